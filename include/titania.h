@@ -51,6 +51,16 @@ extern "C" {
 #define TITANIA_FIRMWARE_DATE_LEN (0x20)
 #define TITANIA_MERGED_REPORT_EDGE_SIZE (174)
 #define TITANIA_MERGED_REPORT_ACCESS_SIZE (960)
+#define TITANIA_EDGE_PROFILE_COUNT (4)
+#define TITANIA_RAW_REPORT_SIZE (64)
+#define TITANIA_CALIBRATION_COUNT (6)
+#define TITANIA_EVENT_QUEUE_SIZE (128) // button events kept per controller, must be a power of two
+#define TITANIA_GESTURE_QUEUE_SIZE (32) // touchpad gestures kept per controller, must be a power of two
+#define TITANIA_FUSION_DEFAULT_GAIN (0.1f) // how hard the accelerometer pulls the orientation back, see titania_set_fusion
+#define TITANIA_GYRO_BIAS_BINS (16) // temperature ranges the gyro bias is learned for, see titania_set_gyro_bias_tracking
+#define TITANIA_GYRO_BIAS_BIN_WIDTH (4) // temperature steps per bin, the last bin takes everything above
+#define TITANIA_FIXED_GYRO_SHIFT (5) // titania_data_fixed gyro is titania_data gyro units * 32, not degrees per second
+#define TITANIA_FIXED_ACCELEROMETER_SHIFT (9) // titania_data_fixed accelerometer is titania_data accelerometer units * 512, not m/s^2
 #define TITANIA_ACCESS_BUTTON_CENTER (0)
 #define TITANIA_ACCESS_BUTTON_B1 (1)
 #define TITANIA_ACCESS_BUTTON_B2 (2)
@@ -79,6 +89,7 @@ typedef enum titania_error {
 	TITANIA_ERROR_NOT_EDGE,
 	TITANIA_ERROR_NOT_ACCESS,
 	TITANIA_ERROR_NOT_SUPPORTED,
+	TITANIA_ERROR_OUT_OF_MEMORY,
 	TITANIA_ERROR_MAX
 } titania_error;
 
@@ -288,6 +299,89 @@ typedef enum titania_access_extension_type_id {
 	TITANIA_ACCESS_EXTENSION_TYPE_MAX
 } titania_access_extension_type_id;
 
+typedef enum titania_filter_type {
+	TITANIA_FILTER_NONE,
+	TITANIA_FILTER_EXPONENTIAL,
+	TITANIA_FILTER_MEDIAN3,
+	TITANIA_FILTER_ONE_EURO,
+	TITANIA_FILTER_MAX
+} titania_filter_type;
+
+typedef enum titania_filter_channel {
+	TITANIA_FILTER_CHANNEL_STICKS,
+	TITANIA_FILTER_CHANNEL_TRIGGERS,
+	TITANIA_FILTER_CHANNEL_GYRO,
+	TITANIA_FILTER_CHANNEL_ACCELEROMETER,
+	TITANIA_FILTER_CHANNEL_MAX
+} titania_filter_channel;
+
+typedef enum titania_gesture_type {
+	TITANIA_GESTURE_TAP,
+	TITANIA_GESTURE_SWIPE,
+	TITANIA_GESTURE_SCROLL,
+	TITANIA_GESTURE_PINCH,
+	TITANIA_GESTURE_MAX
+} titania_gesture_type;
+
+typedef enum titania_gesture_phase {
+	TITANIA_GESTURE_PHASE_BEGIN,
+	TITANIA_GESTURE_PHASE_UPDATE,
+	TITANIA_GESTURE_PHASE_END,
+	TITANIA_GESTURE_PHASE_MAX
+} titania_gesture_phase;
+
+typedef enum titania_gyro_space {
+	TITANIA_GYRO_SPACE_LOCAL, // yaw and pitch around the controller's own axes
+	TITANIA_GYRO_SPACE_WORLD, // yaw around gravity, however the controller is held
+	TITANIA_GYRO_SPACE_PLAYER, // yaw around gravity, with the controller's roll axis blended in like turning a wheel
+	TITANIA_GYRO_SPACE_MAX
+} titania_gyro_space;
+
+typedef enum titania_prediction_model {
+	TITANIA_PREDICTION_NONE,
+	TITANIA_PREDICTION_LINEAR, // sticks and triggers keep moving at their current rate, the controller keeps turning at its current rate
+	TITANIA_PREDICTION_ACCELERATION, // as linear, but the turn also keeps speeding up or slowing down as it currently does
+	TITANIA_PREDICTION_MAX
+} titania_prediction_model;
+
+typedef enum titania_shared_command_type {
+	TITANIA_SHARED_COMMAND_LED,
+	TITANIA_SHARED_COMMAND_AUDIO,
+	TITANIA_SHARED_COMMAND_CONTROL,
+	TITANIA_SHARED_COMMAND_EFFECT,
+	TITANIA_SHARED_COMMAND_RUMBLE,
+	TITANIA_SHARED_COMMAND_MAX
+} titania_shared_command_type;
+
+// bit positions follow the field order of titania_buttons.
+typedef enum titania_button_mask {
+	TITANIA_BUTTON_MASK_DPAD_UP = 1u << 0,
+	TITANIA_BUTTON_MASK_DPAD_RIGHT = 1u << 1,
+	TITANIA_BUTTON_MASK_DPAD_DOWN = 1u << 2,
+	TITANIA_BUTTON_MASK_DPAD_LEFT = 1u << 3,
+	TITANIA_BUTTON_MASK_SQUARE = 1u << 4,
+	TITANIA_BUTTON_MASK_CROSS = 1u << 5,
+	TITANIA_BUTTON_MASK_CIRCLE = 1u << 6,
+	TITANIA_BUTTON_MASK_TRIANGLE = 1u << 7,
+	TITANIA_BUTTON_MASK_L1 = 1u << 8,
+	TITANIA_BUTTON_MASK_R1 = 1u << 9,
+	TITANIA_BUTTON_MASK_L2 = 1u << 10,
+	TITANIA_BUTTON_MASK_R2 = 1u << 11,
+	TITANIA_BUTTON_MASK_CREATE = 1u << 12,
+	TITANIA_BUTTON_MASK_OPTION = 1u << 13,
+	TITANIA_BUTTON_MASK_L3 = 1u << 14,
+	TITANIA_BUTTON_MASK_R3 = 1u << 15,
+	TITANIA_BUTTON_MASK_PLAYSTATION = 1u << 16,
+	TITANIA_BUTTON_MASK_TOUCH = 1u << 17,
+	TITANIA_BUTTON_MASK_MUTE = 1u << 18,
+	TITANIA_BUTTON_MASK_RESERVED = 1u << 19,
+	TITANIA_BUTTON_MASK_EDGE_F1 = 1u << 20,
+	TITANIA_BUTTON_MASK_EDGE_F2 = 1u << 21,
+	TITANIA_BUTTON_MASK_EDGE_LEFT_PADDLE = 1u << 22,
+	TITANIA_BUTTON_MASK_EDGE_RIGHT_PADDLE = 1u << 23,
+	TITANIA_BUTTON_MASK_TOUCHPAD = 1u << 24,
+} titania_button_mask;
+
 TITANIA_EXPORT extern const char* const titania_error_msg[TITANIA_ERROR_MAX + 1];
 TITANIA_EXPORT extern const char* const titania_battery_state_msg[TITANIA_BATTERY_MAX + 1];
 TITANIA_EXPORT extern const char* const titania_profile_id_msg[TITANIA_PROFILE_MAX_META + 1];
@@ -302,6 +396,13 @@ TITANIA_EXPORT extern const char* const titania_access_orientation_msg[TITANIA_A
 TITANIA_EXPORT extern const char* const titania_access_button_id_msg[TITANIA_ACCESS_BUTTON_ID_MAX + 1];
 TITANIA_EXPORT extern const char* const titania_access_stick_id_msg[TITANIA_ACCESS_STICK_ID_MAX + 1];
 TITANIA_EXPORT extern const char* const titania_access_extension_type_id_msg[TITANIA_ACCESS_EXTENSION_TYPE_MAX + 1];
+TITANIA_EXPORT extern const char* const titania_filter_type_msg[TITANIA_FILTER_MAX + 1];
+TITANIA_EXPORT extern const char* const titania_filter_channel_msg[TITANIA_FILTER_CHANNEL_MAX + 1];
+TITANIA_EXPORT extern const char* const titania_gesture_type_msg[TITANIA_GESTURE_MAX + 1];
+TITANIA_EXPORT extern const char* const titania_gesture_phase_msg[TITANIA_GESTURE_PHASE_MAX + 1];
+TITANIA_EXPORT extern const char* const titania_gyro_space_msg[TITANIA_GYRO_SPACE_MAX + 1];
+TITANIA_EXPORT extern const char* const titania_prediction_model_msg[TITANIA_PREDICTION_MAX + 1];
+TITANIA_EXPORT extern const char* const titania_shared_command_type_msg[TITANIA_SHARED_COMMAND_MAX + 1];
 
 TITANIA_EXPORT extern const int titania_max_controllers;
 
@@ -688,6 +789,194 @@ typedef struct titania_data {
 	uint64_t state_id;
 } titania_data;
 
+// calibration folded into a single multiplier per sign, indexed by (value < 0).
+// slots are gyro x, y, z, then accelerometer x, y, z. the accelerometer bias is always zero.
+typedef struct titania_calibration {
+	float scale[2];
+	int32_t bias;
+} titania_calibration;
+
+// bits 0 to 11 follow the access button order of titania_access_button, the extensions count as pressed when moved.
+typedef enum titania_access_button_mask {
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON1 = 1u << 0,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON2 = 1u << 1,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON3 = 1u << 2,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON4 = 1u << 3,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON5 = 1u << 4,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON6 = 1u << 5,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON7 = 1u << 6,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON8 = 1u << 7,
+	TITANIA_ACCESS_BUTTON_MASK_CENTER = 1u << 8,
+	TITANIA_ACCESS_BUTTON_MASK_STICK = 1u << 9,
+	TITANIA_ACCESS_BUTTON_MASK_PLAYSTATION = 1u << 10,
+	TITANIA_ACCESS_BUTTON_MASK_PROFILE = 1u << 11,
+	TITANIA_ACCESS_BUTTON_MASK_E1 = 1u << 12,
+	TITANIA_ACCESS_BUTTON_MASK_E2 = 1u << 13,
+	TITANIA_ACCESS_BUTTON_MASK_E3 = 1u << 14,
+	TITANIA_ACCESS_BUTTON_MASK_E4 = 1u << 15,
+} titania_access_button_mask;
+
+// one button going down or up in a report read by titania_pull.
+typedef struct titania_button_event {
+	uint64_t host_time; // nanoseconds, monotonic where the platform has it
+	uint32_t device_time; // the controller clock, same as titania_data time.system
+	uint32_t button; // a single titania_button_mask bit, or titania_access_button_mask bit if is_access
+	bool pressed;
+	bool is_access;
+} titania_button_event;
+
+// a touchpad gesture recognised in a report read by titania_pull, in touchpad units (1920 by 1080).
+typedef struct titania_gesture_event {
+	uint64_t host_time; // nanoseconds, monotonic where the platform has it
+	uint32_t sensor_time; // the sensor clock of the report, same as titania_data time.sensor
+	titania_gesture_type type;
+	titania_gesture_phase phase; // taps and swipes are recognised once every finger lifts, and only ever end
+	uint8_t fingers;
+	titania_vector2 position; // the finger, or the point between both fingers
+	titania_vector2 delta; // movement since the last event of the gesture, or since the first touch for taps and swipes
+	titania_vector2 velocity; // units per second
+	float scale; // pinch only, the distance between the fingers relative to where the pinch started
+	float scale_velocity; // pinch only, change in scale per second
+} titania_gesture_event;
+
+// smoothing applied by titania_pull to one group of channels, in the units titania_data reports them in.
+typedef struct titania_filter {
+	titania_filter_type type;
+	float alpha; // exponential, weight of the newest report from 0 to 1
+	float min_cutoff; // one euro, cutoff frequency in hz while the value holds still
+	float beta; // one euro, how fast the cutoff rises with speed
+	float derivative_cutoff; // one euro, cutoff frequency in hz of the speed estimate, 1 if 0 or less
+} titania_filter;
+
+typedef struct titania_quaternion {
+	float w;
+	float x;
+	float y;
+	float z;
+} titania_quaternion;
+
+// the gyro bias currently subtracted from input reports, see titania_set_gyro_bias_tracking.
+typedef struct titania_gyro_bias {
+	titania_vector3 bias; // raw sensor units
+	int32_t temperature; // same as titania_data sensors.temperature
+	bool at_rest; // the controller has been still long enough to learn from
+	bool learned; // the bias comes from rest periods rather than the calibration report
+} titania_gyro_bias;
+
+// the controller orientation from titania_set_fusion, in the controller's own axes.
+typedef struct titania_orientation {
+	titania_quaternion orientation; // rotates controller space into world space, world z points up
+	titania_vector3 gravity; // unit vector pointing down as seen by the controller
+	uint32_t sensor_time; // titania_data time.sensor of the last report folded in
+	uint32_t samples; // reports folded in since fusion was enabled
+} titania_orientation;
+
+// output reports the controller has echoed back, see titania_get_output_ack. state ids wrap, compare them with (int32_t) (a - b).
+typedef struct titania_output_ack {
+	uint32_t pushed_state_id; // state id of the last report written by titania_push
+	uint32_t acked_state_id; // state id of the last report the controller applied, a push is applied once this reaches its id
+	uint32_t in_flight; // reports written but not echoed back yet
+	uint32_t deferred; // pushes held back by titania_set_output_backpressure since the last write
+	uint32_t acked; // reports echoed back since open
+	uint32_t lost; // reports never echoed back within 100ms, or still in flight when the controller reconnected
+	uint64_t latency; // nanoseconds from writing the last echoed report to reading the input report that echoed it
+	uint64_t min_latency; // nanoseconds
+	uint64_t average_latency; // nanoseconds, a moving average
+} titania_output_ack;
+
+// how titania_set_gyro_pointer turns rotation into pointer movement, negative sensitivities invert an axis.
+typedef struct titania_gyro_pointer {
+	titania_gyro_space space;
+	titania_vector2 min_sensitivity; // pointer units per degree turned, at min_speed and below
+	titania_vector2 max_sensitivity; // pointer units per degree turned, at max_speed and above
+	float min_speed; // degrees per second
+	float max_speed; // degrees per second, the sensitivity ramps linearly in between
+	float tightening; // degrees per second, slower turns are scaled down towards zero to hide hand shake
+} titania_gyro_pointer;
+
+// pointer movement collected by titania_pull since the last titania_get_gyro_pointer.
+typedef struct titania_pointer_delta {
+	titania_vector2 delta; // x grows to the right and y grows downwards
+	uint32_t samples; // reports that went into delta
+	uint32_t sensor_time; // titania_data time.sensor of the newest report
+} titania_pointer_delta;
+
+// groups reported by titania_pull_changes, timestamps and sequence numbers are not tracked.
+typedef enum titania_change_mask {
+	TITANIA_CHANGE_BUTTONS = 1u << 0,
+	TITANIA_CHANGE_STICKS = 1u << 1,
+	TITANIA_CHANGE_TRIGGERS = 1u << 2,
+	TITANIA_CHANGE_TOUCH = 1u << 3,
+	TITANIA_CHANGE_SENSORS = 1u << 4,
+	TITANIA_CHANGE_BATTERY = 1u << 5,
+	TITANIA_CHANGE_DEVICE = 1u << 6,
+	TITANIA_CHANGE_EDGE = 1u << 7,
+	TITANIA_CHANGE_ACCESS = 1u << 8,
+	TITANIA_CHANGE_ALL = (1u << 9) - 1,
+} titania_change_mask;
+
+// an input report as read from the controller, bluetooth reports are stored in the usb layout.
+typedef struct titania_raw_report {
+	titania_handle handle;
+	uint8_t data[TITANIA_RAW_REPORT_SIZE];
+} titania_raw_report;
+
+// structure-of-arrays output for titania_convert_batch, every array holds one value per report.
+// any array can be nullptr to skip that channel.
+typedef struct titania_batch {
+	float* left_stick_x;
+	float* left_stick_y;
+	float* right_stick_x;
+	float* right_stick_y;
+	float* left_trigger;
+	float* right_trigger;
+	float* gyro_x;
+	float* gyro_y;
+	float* gyro_z;
+	float* accelerometer_x;
+	float* accelerometer_y;
+	float* accelerometer_z;
+	uint32_t* buttons; // titania_button_mask
+} titania_batch;
+
+typedef struct titania_vector2_fixed {
+	int8_t x;
+	int8_t y;
+} titania_vector2_fixed;
+
+typedef struct titania_vector3_fixed {
+	int16_t x;
+	int16_t y;
+	int16_t z;
+} titania_vector3_fixed;
+
+typedef struct titania_touchpad_fixed {
+	uint16_t x;
+	uint16_t y;
+	uint8_t id;
+	bool active;
+} titania_touchpad_fixed;
+
+// integer counterpart of titania_data for consumers that don't want floats.
+// sticks are centred, (x + 128) / 256 is the titania_data value.
+// triggers are 0-255, level * 255 is the titania_data value.
+// gyro and accelerometer are signed fixed point with TITANIA_FIXED_GYRO_SHIFT and TITANIA_FIXED_ACCELEROMETER_SHIFT fraction bits,
+// within one unit in the last place of the titania_data value scaled by the same power of two, and saturated to int16.
+typedef struct titania_data_fixed {
+	titania_handle handle;
+	uint32_t buttons; // titania_button_mask
+	uint32_t sensor_time;
+	uint8_t sequence;
+	uint8_t battery_level; // percent, titania_data battery level * 100
+	uint8_t battery_state; // titania_battery_state
+	uint8_t temperature;
+	uint8_t triggers[2];
+	titania_vector2_fixed sticks[2];
+	titania_touchpad_fixed touch[2];
+	titania_vector3_fixed gyro;
+	titania_vector3_fixed accelerometer;
+} titania_data_fixed;
+
 typedef struct titania_access_led_update {
 	bool enable_profile_led;
 	bool enable_center_led;
@@ -818,10 +1107,43 @@ typedef struct titania_control_update {
 	bool edge_disable_vibration_indicators;
 } titania_control_update;
 
+#define TITANIA_SHARED_DEFAULT_NAME "titania"
+#define TITANIA_SHARED_NAME_SIZE (64)
+#define TITANIA_SHARED_HISTORY (64) // reports kept per controller in shared memory
+#define TITANIA_SHARED_COMMANDS (64) // commands that can wait for the publisher at once
+
+typedef struct titania_shared titania_shared;
+
+typedef struct titania_shared_effect {
+	titania_effect_update left_trigger;
+	titania_effect_update right_trigger;
+	float power_reduction;
+} titania_shared_effect;
+
+typedef struct titania_shared_rumble {
+	float large_motor;
+	float small_motor;
+	float power_reduction;
+	bool emulate_legacy_behavior;
+} titania_shared_rumble;
+
+// an output update sent to the publishing process, which applies it with the matching titania_update_* call and pushes.
+typedef struct titania_shared_command {
+	titania_shared_command_type type;
+	titania_handle handle; // the slot the controller is published in, same as titania_data hid.handle
+	union {
+		titania_led_update led;
+		titania_audio_update audio;
+		titania_control_update control;
+		titania_shared_effect effect;
+		titania_shared_rumble rumble;
+	};
+} titania_shared_command;
+
 #define titania_init() titania_init_checked(sizeof(titania_hid))
 
 /**
- * @brief initialize the library, this is mandatory.
+ * @brief initialize the library and the default context, this is mandatory unless only explicit contexts are used.
  * @param size: sizeof(titania_hid)
  */
 TITANIA_EXPORT titania_error titania_init_checked(const size_t size);
@@ -833,6 +1155,131 @@ TITANIA_EXPORT titania_error titania_init_checked(const size_t size);
  */
 TITANIA_EXPORT titania_error titania_get_hids(titania_query* hids, const size_t hids_length);
 
+/**
+ * @brief use a file to cache calibration, firmware, and serial info between runs
+ * @param path: path to the cache file, it is created if it does not exist. nullptr disables the cache
+ * @note controllers are keyed by the MAC address in their HID serial number, controllers without one are never cached.
+ * cached controllers skip the feature report round-trips on open and are revalidated in the background.
+ */
+TITANIA_EXPORT titania_error titania_set_cache(const char* path);
+
+typedef enum titania_hotplug_event {
+	TITANIA_HOTPLUG_ADDED,
+	TITANIA_HOTPLUG_REMOVED,
+	TITANIA_HOTPLUG_MAX
+} titania_hotplug_event;
+
+typedef struct titania_hotplug titania_hotplug;
+
+typedef void (*titania_hotplug_callback_t)(titania_hotplug_event event, const titania_query* query, void* userdata);
+
+/**
+ * @brief create a hotplug monitor for supported controllers
+ * @param hotplug: where to store the new monitor
+ * @note on linux with libudev the monitor listens for hidraw uevents, everywhere else it rescans on every dispatch.
+ */
+TITANIA_EXPORT titania_error titania_hotplug_create(titania_hotplug** hotplug);
+
+/**
+ * @brief get a file descriptor that becomes readable when hotplug events are pending
+ * @param hotplug: the monitor to query
+ * @return the file descriptor, or -1 if the platform has none and titania_hotplug_dispatch has to be called periodically
+ */
+TITANIA_EXPORT int titania_hotplug_get_fd(titania_hotplug* hotplug);
+
+/**
+ * @brief process pending hotplug events without blocking
+ * @param hotplug: the monitor to process
+ * @param callback: called for every added or removed controller, the first dispatch reports every connected controller as added
+ * @param userdata: passed to callback
+ */
+TITANIA_EXPORT titania_error titania_hotplug_dispatch(titania_hotplug* hotplug, titania_hotplug_callback_t callback, void* userdata);
+
+/**
+ * @brief destroy a hotplug monitor
+ * @param hotplug: the monitor to destroy
+ */
+TITANIA_EXPORT void titania_hotplug_destroy(titania_hotplug* hotplug);
+
+/**
+ * @brief create or take over a shared memory segment and publish controller state in it, for other processes to read
+ * @param name: the segment name, nullptr for TITANIA_SHARED_DEFAULT_NAME
+ * @param shared: where to store the new publisher
+ * @note one process publishes under a name at a time. readers that are already attached see the segment start over.
+ * @return TITANIA_ERROR_INVALID_ARGUMENT if the name is too long or contains a path separator
+ */
+TITANIA_EXPORT titania_error titania_shared_create(const char* name, titania_shared** shared);
+
+/**
+ * @brief attach to a shared memory segment created by titania_shared_create
+ * @param name: the segment name, nullptr for TITANIA_SHARED_DEFAULT_NAME
+ * @param shared: where to store the new reader
+ * @note reading needs neither titania_init nor access to the controllers.
+ * @return TITANIA_ERROR_INVALID_ARGUMENT if there is no such segment, TITANIA_ERROR_INVALID_LIBRARY if it was created by an incompatible build
+ */
+TITANIA_EXPORT titania_error titania_shared_open(const char* name, titania_shared** shared);
+
+/**
+ * @brief publish a report, the slot is data->hid.handle
+ * @param shared: a publisher from titania_shared_create
+ * @param data: the report, as returned by titania_pull
+ * @note readers never wait on the publisher, each slot is a ring of TITANIA_SHARED_HISTORY reports guarded by a sequence number per report.
+ * @return TITANIA_ERROR_NOT_SUPPORTED if shared was not created by titania_shared_create
+ */
+TITANIA_EXPORT titania_error titania_shared_publish(titania_shared* shared, const titania_data* data);
+
+/**
+ * @brief mark a slot as empty, readers get TITANIA_ERROR_INVALID_HANDLE for it until a report is published again
+ * @param shared: a publisher from titania_shared_create
+ * @param handle: the slot to clear
+ */
+TITANIA_EXPORT titania_error titania_shared_disconnect(titania_shared* shared, const titania_handle handle);
+
+/**
+ * @brief take the commands sent by readers, oldest first
+ * @param shared: a publisher from titania_shared_create
+ * @param commands: where to store the commands
+ * @param count: how many commands fit in commands
+ * @param written: how many commands were stored
+ * @note commands come from other processes, the handle and the update data still have to be checked before use.
+ */
+TITANIA_EXPORT titania_error titania_shared_get_commands(titania_shared* shared, titania_shared_command* commands, const size_t count, size_t* written);
+
+/**
+ * @brief read the newest report published in a slot, without locks or system calls
+ * @param shared: a reader from titania_shared_open
+ * @param handle: the slot to read
+ * @param data: where to store the report
+ * @param sequence: where to store how many reports the slot has seen, to tell new reports apart. may be nullptr
+ * @return TITANIA_ERROR_INVALID_HANDLE if nothing is published in the slot, TITANIA_ERROR_INVALID_DATA if the reader fell too far behind the publisher to get a consistent copy
+ */
+TITANIA_EXPORT titania_error titania_shared_read(titania_shared* shared, const titania_handle handle, titania_data* data, uint32_t* sequence);
+
+/**
+ * @brief read the most recent reports published in a slot, oldest first
+ * @param shared: a reader from titania_shared_open
+ * @param handle: the slot to read
+ * @param data: where to store the reports
+ * @param count: how many reports fit in data, at most TITANIA_SHARED_HISTORY are kept
+ * @param written: how many reports were stored, reports overwritten while reading are left out
+ */
+TITANIA_EXPORT titania_error titania_shared_read_history(titania_shared* shared, const titania_handle handle, titania_data* data, const size_t count, size_t* written);
+
+/**
+ * @brief send an output update to the publisher, it is applied and pushed the next time the publisher takes its commands
+ * @param shared: a reader from titania_shared_open
+ * @param command: the update to send
+ * @note any number of processes can send at once.
+ * @return TITANIA_ERROR_NO_SLOTS if TITANIA_SHARED_COMMANDS commands are already waiting
+ */
+TITANIA_EXPORT titania_error titania_shared_send(titania_shared* shared, const titania_shared_command* command);
+
+/**
+ * @brief detach from a shared memory segment, a publisher marks every slot as empty first
+ * @param shared: the publisher or reader to destroy
+ */
+TITANIA_EXPORT void titania_shared_destroy(titania_shared* shared);
+
 /**
  * @brief open a HID handle for processing
  * @param path: the path of the device to open
@@ -843,6 +1290,48 @@ TITANIA_EXPORT titania_error titania_get_hids(titania_query* hids, const size_t
  */
 TITANIA_EXPORT titania_error titania_open(const titania_hid_path path, const bool is_bluetooth, titania_hid* handle, const bool use_calibration, const bool blocking);
 
+/**
+ * @brief open several HID handles concurrently
+ * @param queries: the devices to open, usually from titania_get_hids
+ * @param count: array size of queries, handles, and results
+ * @param handles: pointer to an array of titania HID handles, failed devices hold TITANIA_INVALID_ID
+ * @param results: optional pointer to an array that receives the result of each open
+ * @param use_calibration: whether or not to use calibration data for the gyroscope and accelerometer, calibration is fetched in the background
+ * @param blocking: whether or not to wait for data before reading, this is sometimes slower or faster.
+ * @note firmware and serial info are not fetched, use titania_get_firmware and titania_get_serial. until calibration arrives the default coefficients are used.
+ */
+TITANIA_EXPORT titania_error titania_open_many(const titania_query* queries, const size_t count, titania_hid* handles, titania_error* results, const bool use_calibration, const bool blocking);
+
+/**
+ * @brief get firmware info, fetching it from the controller on first use
+ * @param handle: the controller to query
+ * @param firmware: pointer to the firmware info
+ */
+TITANIA_EXPORT titania_error titania_get_firmware(const titania_handle handle, titania_firmware_info* firmware);
+
+/**
+ * @brief get serial info, fetching it from the controller on first use
+ * @param handle: the controller to query
+ * @param serial: pointer to the serial info
+ */
+TITANIA_EXPORT titania_error titania_get_serial(const titania_handle handle, titania_serial_info* serial);
+
+/**
+ * @brief keep a handle alive when its controller disconnects, and reattach it when the controller comes back
+ * @param handle: the controller to update
+ * @param enabled: whether or not to reconnect automatically
+ * @note while disconnected titania_pull returns idle data and titania_push only queues output, the last output state is sent again on reconnect.
+ * @return TITANIA_ERROR_NOT_SUPPORTED if the controller can't be identified by its MAC address
+ */
+TITANIA_EXPORT titania_error titania_set_reconnect(const titania_handle handle, const bool enabled);
+
+/**
+ * @brief check whether a handle is currently attached to its controller
+ * @param handle: the controller to query
+ * @param connected: pointer to the connection state
+ */
+TITANIA_EXPORT titania_error titania_is_connected(const titania_handle handle, bool* connected);
+
 /**
  * @brief poll controllers for input data
  * @param handle: pointer to an array of handles, values will be set to TITANIA_ERROR_INVALID_HANDLE if they are invalid.
@@ -851,6 +1340,24 @@ TITANIA_EXPORT titania_error titania_open(const titania_hid_path path, const boo
  */
 TITANIA_EXPORT titania_error titania_pull(titania_handle* handle, const size_t handle_count, titania_data* data);
 
+/**
+ * @brief poll controllers for input data in integer units, see titania_data_fixed
+ * @param handle: pointer to an array of handles, values will be set to TITANIA_ERROR_INVALID_HANDLE if they are invalid.
+ * @param handle_count: number of handles to process
+ * @param data: pointer to an array of data storage
+ */
+TITANIA_EXPORT titania_error titania_pull_fixed(titania_handle* handle, const size_t handle_count, titania_data_fixed* data);
+
+/**
+ * @brief poll controllers for input data, and report which groups changed since the previous report of each controller
+ * @param handle: pointer to an array of handles, values will be set to TITANIA_ERROR_INVALID_HANDLE if they are invalid.
+ * @param handle_count: number of handles to process
+ * @param data: pointer to an array of data storage
+ * @param changes: pointer to an array of titania_change_mask bits, one per handle
+ * @note the first report after open or a reconnect marks every group the controller has as changed, a failed read marks none.
+ */
+TITANIA_EXPORT titania_error titania_pull_changes(titania_handle* handle, const size_t handle_count, titania_data* data, uint32_t* changes);
+
 /**
  * @brief push output data to controllers
  * @param handle: pointer to an array of handles, values will be set to TITANIA_ERROR_INVALID_HANDLE if they are invalid.
@@ -858,6 +1365,205 @@ TITANIA_EXPORT titania_error titania_pull(titania_handle* handle, const size_t h
  */
 TITANIA_EXPORT titania_error titania_push(titania_handle* handle, const size_t handle_count);
 
+/**
+ * @brief hold pushes back while the previous output report has not been echoed back by the controller
+ * @param handle: the controller to update
+ * @param enabled: whether to hold pushes back
+ * @note held pushes are merged into the next write, which titania_pull sends as soon as the controller catches up.
+ * @note a report that is not echoed back within 100ms stops holding the next one.
+ * @return TITANIA_ERROR_NOT_SUPPORTED on access controllers, which do not echo output reports
+ */
+TITANIA_EXPORT titania_error titania_set_output_backpressure(const titania_handle handle, const bool enabled);
+
+/**
+ * @brief get which output reports the controller has applied, and how long they took
+ * @param handle: the controller to query
+ * @param ack: where to store the acknowledgement state
+ * @note acknowledgements are read by titania_pull, latency includes the time until the echoing report was pulled.
+ * @return TITANIA_ERROR_NOT_SUPPORTED on access controllers, which do not echo output reports
+ */
+TITANIA_EXPORT titania_error titania_get_output_ack(const titania_handle handle, titania_output_ack* ack);
+
+/**
+ * @brief keep the last raw input reports read by titania_pull
+ * @param handle: the controller to record
+ * @param count: how many reports to keep, 0 stops recording and frees the history
+ */
+TITANIA_EXPORT titania_error titania_set_history(const titania_handle handle, const size_t count);
+
+/**
+ * @brief copy the recorded raw input reports, oldest first
+ * @param handle: the controller to query
+ * @param reports: pointer to an array of raw reports
+ * @param count: array size of reports, the newest reports are kept if more are recorded
+ * @param written: pointer to the number of reports copied
+ */
+TITANIA_EXPORT titania_error titania_get_history(const titania_handle handle, titania_raw_report* reports, const size_t count, size_t* written);
+
+/**
+ * @brief drain the button events of a controller, oldest first
+ * @param handle: the controller to query
+ * @param events: pointer to an array of events
+ * @param count: array size of events, anything left stays queued
+ * @param written: pointer to the number of events copied
+ * @note events are produced by whichever thread calls titania_pull, and are safe to drain from one other thread without locking.
+ * @note the queue holds TITANIA_EVENT_QUEUE_SIZE events, newer events are dropped while it is full.
+ */
+TITANIA_EXPORT titania_error titania_get_events(const titania_handle handle, titania_button_event* events, const size_t count, size_t* written);
+
+/**
+ * @brief recognise taps, swipes, two finger scrolls, and pinches on every report read by titania_pull
+ * @param handle: the controller to update
+ * @param enabled: whether to recognise gestures, any gesture in progress is dropped either way
+ * @note timing comes from the sensor clock, so every report pulled counts no matter how often titania_pull is called.
+ */
+TITANIA_EXPORT titania_error titania_set_gestures(const titania_handle handle, const bool enabled);
+
+/**
+ * @brief drain the touchpad gestures of a controller, oldest first
+ * @param handle: the controller to query
+ * @param events: pointer to an array of gestures
+ * @param count: array size of events, anything left stays queued
+ * @param written: pointer to the number of gestures copied
+ * @note gestures are produced by whichever thread calls titania_pull, and are safe to drain from one other thread without locking.
+ * @note the queue holds TITANIA_GESTURE_QUEUE_SIZE gestures, newer gestures are dropped while it is full.
+ */
+TITANIA_EXPORT titania_error titania_get_gestures(const titania_handle handle, titania_gesture_event* events, const size_t count, size_t* written);
+
+/**
+ * @brief reshape a stick on every report read by titania_pull, using the same curves and deadzone as edge profiles
+ * @param handle: the controller to update
+ * @param stick: TITANIA_LEFT or TITANIA_RIGHT
+ * @param curve: the curve to apply, see titania_helper_edge_stick_template, or nullptr to report the stick as is
+ * @note works for every controller, an edge controller applies its own profile curve in hardware before this one.
+ * @note titania_get_history and titania_convert_batch are not reshaped.
+ */
+TITANIA_EXPORT titania_error titania_set_stick_curve(const titania_handle handle, const int32_t stick, const titania_edge_stick* curve);
+
+/**
+ * @brief remap the buttons of a dualsense or edge on every report read by titania_pull, like the button section of an edge profile
+ * @param handle: the controller to update
+ * @param buttons: what each physical button presses, or nullptr to keep them in place
+ * @param disabled: buttons that never report as pressed, or nullptr
+ * @note buttons not covered by titania_edge_button_remap keep their place, passing nullptr for both turns remapping off.
+ * @note an edge controller applies its own profile remap in hardware before this one.
+ * @note titania_get_events, titania_pull_changes, titania_get_history and titania_convert_batch see the physical buttons.
+ */
+TITANIA_EXPORT titania_error titania_set_button_remap(const titania_handle handle, const titania_edge_button_remap* buttons, const titania_buttons* disabled);
+
+/**
+ * @brief remap the buttons of an access controller on every report read by titania_pull, like the button section of an access profile
+ * @param handle: the controller to update
+ * @param buttons: what each physical button presses, or nullptr to report the buttons of the active profile
+ * @note replaces the mapping of the active profile, the playstation button always presses playstation and toggles latch on press.
+ * @note titania_get_events, titania_pull_changes, titania_get_history and titania_convert_batch see the physical buttons.
+ */
+TITANIA_EXPORT titania_error titania_set_access_button_remap(const titania_handle handle, const titania_access_profile_buttons* buttons);
+
+/**
+ * @brief smooth a group of channels on every report read by titania_pull
+ * @param handle: the controller to update
+ * @param channel: which values to filter
+ * @param filter: the filter and its settings, TITANIA_FILTER_NONE turns it off
+ * @note the filter restarts from the next report, and after any gap in the sensor clock longer than 100ms.
+ * @note titania_pull_fixed, titania_get_history, and titania_convert_batch are not filtered.
+ */
+TITANIA_EXPORT titania_error titania_set_filter(const titania_handle handle, const titania_filter_channel channel, const titania_filter filter);
+
+/**
+ * @brief keep refining the gyro bias whenever the controller is left still
+ * @param handle: the controller to update
+ * @param enabled: true to start learning, false to stop and go back to the calibration report bias
+ * @param use_temperature: learn a separate bias for every TITANIA_GYRO_BIAS_BIN_WIDTH temperature steps
+ * @note the learned bias replaces the calibration bias for titania_pull, titania_pull_fixed, titania_get_calibration, and fusion.
+ * @return TITANIA_ERROR_NOT_SUPPORTED if the controller has no motion sensors
+ */
+TITANIA_EXPORT titania_error titania_set_gyro_bias_tracking(const titania_handle handle, const bool enabled, const bool use_temperature);
+
+/**
+ * @brief get the gyro bias currently applied to a controller
+ * @param handle: the controller to query
+ * @param bias: where to store the bias
+ */
+TITANIA_EXPORT titania_error titania_get_gyro_bias(const titania_handle handle, titania_gyro_bias* bias);
+
+/**
+ * @brief track the controller orientation from every report read by titania_pull
+ * @param handle: the controller to update
+ * @param enabled: true to start (or restart) tracking, false to stop
+ * @param gain: accelerometer correction gain, TITANIA_FUSION_DEFAULT_GAIN if 0 or less. higher is less drift, but more noise
+ * @return TITANIA_ERROR_NOT_SUPPORTED if the controller has no motion sensors
+ */
+TITANIA_EXPORT titania_error titania_set_fusion(const titania_handle handle, const bool enabled, const float gain);
+
+/**
+ * @brief get the controller orientation tracked since titania_set_fusion
+ * @param handle: the controller to query
+ * @param orientation: where to store the orientation
+ * @return TITANIA_ERROR_NOT_SUPPORTED if fusion is not enabled
+ */
+TITANIA_EXPORT titania_error titania_get_orientation(const titania_handle handle, titania_orientation* orientation);
+
+/**
+ * @brief turn gyro rotation into pointer movement on every report read by titania_pull, for gyro aiming or a gyro mouse
+ * @param handle: the controller to update
+ * @param pointer: the space and sensitivity curve, or nullptr to stop
+ * @note movement collects between calls to titania_get_gyro_pointer, so none is lost however often the game polls.
+ * @note uses the gyro bias learned by titania_set_gyro_bias_tracking when that is on.
+ * @return TITANIA_ERROR_NOT_SUPPORTED if the controller has no motion sensors
+ */
+TITANIA_EXPORT titania_error titania_set_gyro_pointer(const titania_handle handle, const titania_gyro_pointer* pointer);
+
+/**
+ * @brief take the pointer movement collected since the last call
+ * @param handle: the controller to query
+ * @param delta: pointer to the movement, which starts collecting again from zero
+ */
+TITANIA_EXPORT titania_error titania_get_gyro_pointer(const titania_handle handle, titania_pointer_delta* delta);
+
+/**
+ * @brief keep the recent reports read by titania_pull, so titania_predict can extrapolate from them
+ * @param handle: the controller to update
+ * @param model: how to extrapolate, TITANIA_PREDICTION_NONE stops and forgets the reports kept so far
+ * @return TITANIA_ERROR_NOT_SUPPORTED if the controller has no sensor clock
+ */
+TITANIA_EXPORT titania_error titania_set_prediction(const titania_handle handle, const titania_prediction_model model);
+
+/**
+ * @brief predict the sticks, triggers, gyro, and orientation at a given time, such as when the current frame will be displayed
+ * @param handle: the controller to query
+ * @param target_host_time: nanoseconds on the titania_get_host_time clock
+ * @param data: where to store the latest report with the predicted values, time.sensor is moved to the predicted time
+ * @param orientation: where to store the predicted orientation, or nullptr. needs titania_set_fusion
+ * @note the reports are matched to the host clock by the quickest one to arrive, so reports that sat in a buffer do not count as late.
+ * @note predicts at most 100ms ahead, and never into the past. values are clamped to what the controller can report.
+ * @note the prediction starts from the calibrated report with stick curves applied, before button remapping and filtering.
+ * @return TITANIA_ERROR_NOT_SUPPORTED if prediction (or fusion, for orientation) is not enabled, TITANIA_ERROR_INVALID_DATA if nothing was pulled since
+ */
+TITANIA_EXPORT titania_error titania_predict(const titania_handle handle, const uint64_t target_host_time, titania_data* data, titania_orientation* orientation);
+
+/**
+ * @brief get the host clock used by titania_predict and titania_button_event
+ * @return nanoseconds, monotonic where the platform has it
+ */
+TITANIA_EXPORT uint64_t titania_get_host_time(void);
+
+/**
+ * @brief get the calibration input reports from a controller are converted with, see titania_decode.h
+ * @param handle: the controller to query
+ * @param calibration: where to store the calibration
+ */
+TITANIA_EXPORT titania_error titania_get_calibration(const titania_handle handle, titania_calibration calibration[TITANIA_CALIBRATION_COUNT]);
+
+/**
+ * @brief convert many raw input reports at once into a structure-of-arrays
+ * @param reports: pointer to an array of raw reports, from any number of open controllers
+ * @param count: array size of reports, and of every array in batch
+ * @param batch: where to store the converted channels
+ * @note values match what titania_pull would have returned for the same report with the controller's current calibration.
+ */
+TITANIA_EXPORT titania_error titania_convert_batch(const titania_raw_report* reports, const size_t count, const titania_batch* batch);
+
 /**
  * @brief update LED state of a controller
  * @param handle: the controller to update
@@ -935,10 +1641,11 @@ TITANIA_EXPORT titania_error titania_bt_disconnect(const titania_handle handle);
 TITANIA_EXPORT titania_error titania_update_edge_profile(const titania_handle handle, const titania_profile_id id, const titania_edge_profile profile);
 
 /**
- * @brief update a dualsense edge profile
+ * @brief update an access profile
  * @param handle: the controller to update
  * @param id: the profile id to store the profile into
  * @param profile: the profile data to store
+ * @note nothing is sent if the controller already holds this exact profile.
  */
 TITANIA_EXPORT titania_error titania_update_access_profile(const titania_handle handle, const titania_profile_id id, const titania_access_profile profile);
 
@@ -950,11 +1657,20 @@ TITANIA_EXPORT titania_error titania_update_access_profile(const titania_handle
  */
 TITANIA_EXPORT titania_error titania_query_edge_profile(const titania_handle handle, const titania_profile_id profile_id, titania_edge_profile* profile);
 
+/**
+ * @brief fetches every dualsense edge profile slot in one pass
+ * @param handle: the controller to query
+ * @param profiles: the profile data, indexed by profile id - TITANIA_PROFILE_TRIANGLE. empty slots are not valid.
+ * @note profiles are cached per handle, a profile that did not change since the last query costs a single feature report.
+ */
+TITANIA_EXPORT titania_error titania_query_edge_profiles_all(const titania_handle handle, titania_edge_profile profiles[TITANIA_EDGE_PROFILE_COUNT]);
+
 /**
  * @brief fetches all access profiles
  * @param handle: the controller to query
  * @param profile_id: profile id to query
  * @param profile: the profile data
+ * @note profiles are cached per handle after the first query, changes made through another handle or process are not seen. titania_debug_get_access_profile always reads from the controller and refreshes the cache.
  */
 TITANIA_EXPORT titania_error titania_query_access_profile(const titania_handle handle, const titania_profile_id profile_id, titania_access_profile* profile);
 
@@ -987,7 +1703,7 @@ TITANIA_EXPORT titania_error titania_delete_access_profile(const titania_handle
 TITANIA_EXPORT void titania_close(const titania_handle handle);
 
 /**
- * @brief cleans up library internals for exit
+ * @brief closes every controller on the default context and cleans up library internals for exit
  */
 TITANIA_EXPORT void titania_exit(void);
 
@@ -1005,6 +1721,13 @@ TITANIA_EXPORT titania_error titania_debug_get_hid(const titania_handle handle,
  */
 TITANIA_EXPORT titania_error titania_debug_get_hid_report_ids(const titania_handle handle, titania_report_id report_ids[0xFF]);
 
+/**
+ * @brief (debug) convert the last read input report again without reading from the device, used to benchmark conversion. call it from the thread that pulls the handle
+ * @param handle: the device to query
+ * @param data: the data to convert into
+ */
+TITANIA_EXPORT titania_error titania_debug_convert_input(const titania_handle handle, titania_data* data);
+
 /**
  * @brief (debug) get a merged edge profile
  * @param handle: the device to query
@@ -1035,6 +1758,528 @@ TITANIA_EXPORT titania_error titania_convert_edge_profile_input(uint8_t input[TI
  */
 TITANIA_EXPORT titania_error titania_convert_access_profile_input(uint8_t input[TITANIA_MERGED_REPORT_ACCESS_SIZE], titania_access_profile* output);
 
+typedef struct titania_context titania_context;
+
+#define titania_context_create(context) titania_context_create_checked(sizeof(titania_hid), context)
+
+/**
+ * @brief create an independent library context with its own handle table
+ * @note contexts share nothing, a thread that owns a context can use it without locking. create and destroy contexts from one thread.
+ * @param size: sizeof(titania_hid)
+ * @param context: where to store the new context
+ */
+TITANIA_EXPORT titania_error titania_context_create_checked(const size_t size, titania_context** context);
+
+/**
+ * @brief close every controller owned by a context and free it
+ * @param context: the context to destroy
+ */
+TITANIA_EXPORT void titania_context_destroy(titania_context* context);
+
+/**
+ * @brief use a file to cache calibration, firmware, and serial info between runs
+ * @param ctx: the context to use the cache in
+ * @param path: path to the cache file, it is created if it does not exist. nullptr disables the cache
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_cache(titania_context* ctx, const char* path);
+
+/**
+ * @brief open a HID handle for processing
+ * @param ctx: the context that owns the handle
+ * @param path: the path of the device to open
+ * @param is_bluetooth: whether or not to consider this device a bluetooth device.
+ * @param handle: pointer to the titania HID handle, this value will hold the titania_handle value when the function returns
+ * @param use_calibration: whether or not to use calibration data for the gyroscope and accelerometer
+ * @param blocking: whether or not to wait for data before reading, this is sometimes slower or faster.
+ */
+TITANIA_EXPORT titania_error titania_ctx_open(titania_context* ctx, const titania_hid_path path, const bool is_bluetooth, titania_hid* handle, const bool use_calibration, const bool blocking);
+
+/**
+ * @brief open several HID handles concurrently
+ * @param ctx: the context that owns the handles
+ * @param queries: the devices to open, usually from titania_get_hids
+ * @param count: array size of queries, handles, and results
+ * @param handles: pointer to an array of titania HID handles, failed devices hold TITANIA_INVALID_ID
+ * @param results: optional pointer to an array that receives the result of each open
+ * @param use_calibration: whether or not to use calibration data for the gyroscope and accelerometer, calibration is fetched in the background
+ * @param blocking: whether or not to wait for data before reading, this is sometimes slower or faster.
+ */
+TITANIA_EXPORT titania_error titania_ctx_open_many(titania_context* ctx, const titania_query* queries, const size_t count, titania_hid* handles, titania_error* results, const bool use_calibration, const bool blocking);
+
+/**
+ * @brief get firmware info, fetching it from the controller on first use
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param firmware: pointer to the firmware info
+ */
+TITANIA_EXPORT titania_error titania_ctx_get_firmware(titania_context* ctx, const titania_handle handle, titania_firmware_info* firmware);
+
+/**
+ * @brief get serial info, fetching it from the controller on first use
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param serial: pointer to the serial info
+ */
+TITANIA_EXPORT titania_error titania_ctx_get_serial(titania_context* ctx, const titania_handle handle, titania_serial_info* serial);
+
+/**
+ * @brief keep a handle alive when its controller disconnects, and reattach it when the controller comes back
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param enabled: whether or not to reconnect automatically
+ * @note while disconnected titania_ctx_pull returns idle data and titania_ctx_push only queues output, the last output state is sent again on reconnect.
+ * @return TITANIA_ERROR_NOT_SUPPORTED if the controller can't be identified by its MAC address
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_reconnect(titania_context* ctx, const titania_handle handle, const bool enabled);
+
+/**
+ * @brief check whether a handle is currently attached to its controller
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param connected: pointer to the connection state
+ */
+TITANIA_EXPORT titania_error titania_ctx_is_connected(titania_context* ctx, const titania_handle handle, bool* connected);
+
+/**
+ * @brief poll controllers for input data
+ * @param ctx: the context that owns the handle
+ * @param handle: pointer to an array of handles, values will be set to TITANIA_ERROR_INVALID_HANDLE if they are invalid.
+ * @param handle_count: number of handles to process
+ * @param data: pointer to an array of data storage
+ */
+TITANIA_EXPORT titania_error titania_ctx_pull(titania_context* ctx, titania_handle* handle, const size_t handle_count, titania_data* data);
+
+/**
+ * @brief poll controllers for input data in integer units, see titania_data_fixed
+ * @param ctx: the context that owns the handle
+ * @param handle: pointer to an array of handles, values will be set to TITANIA_ERROR_INVALID_HANDLE if they are invalid.
+ * @param handle_count: number of handles to process
+ * @param data: pointer to an array of data storage
+ */
+TITANIA_EXPORT titania_error titania_ctx_pull_fixed(titania_context* ctx, titania_handle* handle, const size_t handle_count, titania_data_fixed* data);
+
+/**
+ * @brief poll controllers for input data, and report which groups changed since the previous report of each controller
+ * @param ctx: the context that owns the handle
+ * @param handle: pointer to an array of handles, values will be set to TITANIA_ERROR_INVALID_HANDLE if they are invalid.
+ * @param handle_count: number of handles to process
+ * @param data: pointer to an array of data storage
+ * @param changes: pointer to an array of titania_change_mask bits, one per handle
+ * @note the first report after open or a reconnect marks every group the controller has as changed, a failed read marks none.
+ */
+TITANIA_EXPORT titania_error titania_ctx_pull_changes(titania_context* ctx, titania_handle* handle, const size_t handle_count, titania_data* data, uint32_t* changes);
+
+/**
+ * @brief push output data to controllers
+ * @param ctx: the context that owns the handle
+ * @param handle: pointer to an array of handles, values will be set to TITANIA_ERROR_INVALID_HANDLE if they are invalid.
+ * @param handle_count: number of handles to process
+ */
+TITANIA_EXPORT titania_error titania_ctx_push(titania_context* ctx, titania_handle* handle, const size_t handle_count);
+
+/**
+ * @brief hold pushes back while the previous output report has not been echoed back by the controller
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param enabled: whether to hold pushes back
+ * @note held pushes are merged into the next write, which titania_ctx_pull sends as soon as the controller catches up.
+ * @note a report that is not echoed back within 100ms stops holding the next one.
+ * @return TITANIA_ERROR_NOT_SUPPORTED on access controllers, which do not echo output reports
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_output_backpressure(titania_context* ctx, const titania_handle handle, const bool enabled);
+
+/**
+ * @brief get which output reports the controller has applied, and how long they took
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param ack: where to store the acknowledgement state
+ * @note acknowledgements are read by titania_ctx_pull, latency includes the time until the echoing report was pulled.
+ * @return TITANIA_ERROR_NOT_SUPPORTED on access controllers, which do not echo output reports
+ */
+TITANIA_EXPORT titania_error titania_ctx_get_output_ack(titania_context* ctx, const titania_handle handle, titania_output_ack* ack);
+
+/**
+ * @brief keep the last raw input reports read by titania_ctx_pull
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to record
+ * @param count: how many reports to keep, 0 stops recording and frees the history
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_history(titania_context* ctx, const titania_handle handle, const size_t count);
+
+/**
+ * @brief copy the recorded raw input reports, oldest first
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param reports: pointer to an array of raw reports
+ * @param count: array size of reports, the newest reports are kept if more are recorded
+ * @param written: pointer to the number of reports copied
+ */
+TITANIA_EXPORT titania_error titania_ctx_get_history(titania_context* ctx, const titania_handle handle, titania_raw_report* reports, const size_t count, size_t* written);
+
+/**
+ * @brief drain the button events of a controller, oldest first
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param events: pointer to an array of events
+ * @param count: array size of events, anything left stays queued
+ * @param written: pointer to the number of events copied
+ * @note events are produced by whichever thread calls titania_ctx_pull, and are safe to drain from one other thread without locking.
+ * @note the queue holds TITANIA_EVENT_QUEUE_SIZE events, newer events are dropped while it is full.
+ */
+TITANIA_EXPORT titania_error titania_ctx_get_events(titania_context* ctx, const titania_handle handle, titania_button_event* events, const size_t count, size_t* written);
+
+/**
+ * @brief recognise taps, swipes, two finger scrolls, and pinches on every report read by titania_ctx_pull
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param enabled: whether to recognise gestures, any gesture in progress is dropped either way
+ * @note timing comes from the sensor clock, so every report pulled counts no matter how often titania_ctx_pull is called.
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_gestures(titania_context* ctx, const titania_handle handle, const bool enabled);
+
+/**
+ * @brief drain the touchpad gestures of a controller, oldest first
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param events: pointer to an array of gestures
+ * @param count: array size of events, anything left stays queued
+ * @param written: pointer to the number of gestures copied
+ * @note gestures are produced by whichever thread calls titania_ctx_pull, and are safe to drain from one other thread without locking.
+ * @note the queue holds TITANIA_GESTURE_QUEUE_SIZE gestures, newer gestures are dropped while it is full.
+ */
+TITANIA_EXPORT titania_error titania_ctx_get_gestures(titania_context* ctx, const titania_handle handle, titania_gesture_event* events, const size_t count, size_t* written);
+
+/**
+ * @brief reshape a stick on every report read by titania_ctx_pull, using the same curves and deadzone as edge profiles
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param stick: TITANIA_LEFT or TITANIA_RIGHT
+ * @param curve: the curve to apply, see titania_helper_edge_stick_template, or nullptr to report the stick as is
+ * @note works for every controller, an edge controller applies its own profile curve in hardware before this one.
+ * @note titania_ctx_get_history and titania_ctx_convert_batch are not reshaped.
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_stick_curve(titania_context* ctx, const titania_handle handle, const int32_t stick, const titania_edge_stick* curve);
+
+/**
+ * @brief remap the buttons of a dualsense or edge on every report read by titania_ctx_pull, like the button section of an edge profile
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param buttons: what each physical button presses, or nullptr to keep them in place
+ * @param disabled: buttons that never report as pressed, or nullptr
+ * @note buttons not covered by titania_edge_button_remap keep their place, passing nullptr for both turns remapping off.
+ * @note an edge controller applies its own profile remap in hardware before this one.
+ * @note titania_ctx_get_events, titania_ctx_pull_changes, titania_ctx_get_history and titania_ctx_convert_batch see the physical buttons.
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_button_remap(titania_context* ctx, const titania_handle handle, const titania_edge_button_remap* buttons, const titania_buttons* disabled);
+
+/**
+ * @brief remap the buttons of an access controller on every report read by titania_ctx_pull, like the button section of an access profile
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param buttons: what each physical button presses, or nullptr to report the buttons of the active profile
+ * @note replaces the mapping of the active profile, the playstation button always presses playstation and toggles latch on press.
+ * @note titania_ctx_get_events, titania_ctx_pull_changes, titania_ctx_get_history and titania_ctx_convert_batch see the physical buttons.
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_access_button_remap(titania_context* ctx, const titania_handle handle, const titania_access_profile_buttons* buttons);
+
+/**
+ * @brief smooth a group of channels on every report read by titania_ctx_pull
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param channel: which values to filter
+ * @param filter: the filter and its settings, TITANIA_FILTER_NONE turns it off
+ * @note the filter restarts from the next report, and after any gap in the sensor clock longer than 100ms.
+ * @note titania_ctx_pull_fixed, titania_ctx_get_history, and titania_ctx_convert_batch are not filtered.
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_filter(titania_context* ctx, const titania_handle handle, const titania_filter_channel channel, const titania_filter filter);
+
+/**
+ * @brief keep refining the gyro bias whenever the controller is left still
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param enabled: true to start learning, false to stop and go back to the calibration report bias
+ * @param use_temperature: learn a separate bias for every TITANIA_GYRO_BIAS_BIN_WIDTH temperature steps
+ * @note the learned bias replaces the calibration bias for titania_ctx_pull, titania_ctx_pull_fixed, titania_ctx_get_calibration, and fusion.
+ * @return TITANIA_ERROR_NOT_SUPPORTED if the controller has no motion sensors
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_gyro_bias_tracking(titania_context* ctx, const titania_handle handle, const bool enabled, const bool use_temperature);
+
+/**
+ * @brief get the gyro bias currently applied to a controller
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param bias: where to store the bias
+ */
+TITANIA_EXPORT titania_error titania_ctx_get_gyro_bias(titania_context* ctx, const titania_handle handle, titania_gyro_bias* bias);
+
+/**
+ * @brief track the controller orientation from every report read by titania_ctx_pull
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param enabled: true to start (or restart) tracking, false to stop
+ * @param gain: accelerometer correction gain, TITANIA_FUSION_DEFAULT_GAIN if 0 or less. higher is less drift, but more noise
+ * @return TITANIA_ERROR_NOT_SUPPORTED if the controller has no motion sensors
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_fusion(titania_context* ctx, const titania_handle handle, const bool enabled, const float gain);
+
+/**
+ * @brief get the controller orientation tracked since titania_ctx_set_fusion
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param orientation: where to store the orientation
+ * @return TITANIA_ERROR_NOT_SUPPORTED if fusion is not enabled
+ */
+TITANIA_EXPORT titania_error titania_ctx_get_orientation(titania_context* ctx, const titania_handle handle, titania_orientation* orientation);
+
+/**
+ * @brief turn gyro rotation into pointer movement on every report read by titania_ctx_pull, for gyro aiming or a gyro mouse
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param pointer: the space and sensitivity curve, or nullptr to stop
+ * @note movement collects between calls to titania_ctx_get_gyro_pointer, so none is lost however often the game polls.
+ * @note uses the gyro bias learned by titania_ctx_set_gyro_bias_tracking when that is on.
+ * @return TITANIA_ERROR_NOT_SUPPORTED if the controller has no motion sensors
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_gyro_pointer(titania_context* ctx, const titania_handle handle, const titania_gyro_pointer* pointer);
+
+/**
+ * @brief take the pointer movement collected since the last call
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param delta: pointer to the movement, which starts collecting again from zero
+ */
+TITANIA_EXPORT titania_error titania_ctx_get_gyro_pointer(titania_context* ctx, const titania_handle handle, titania_pointer_delta* delta);
+
+/**
+ * @brief keep the recent reports read by titania_ctx_pull, so titania_ctx_predict can extrapolate from them
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param model: how to extrapolate, TITANIA_PREDICTION_NONE stops and forgets the reports kept so far
+ * @return TITANIA_ERROR_NOT_SUPPORTED if the controller has no sensor clock
+ */
+TITANIA_EXPORT titania_error titania_ctx_set_prediction(titania_context* ctx, const titania_handle handle, const titania_prediction_model model);
+
+/**
+ * @brief predict the sticks, triggers, gyro, and orientation at a given time, such as when the current frame will be displayed
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param target_host_time: nanoseconds on the titania_get_host_time clock
+ * @param data: where to store the latest report with the predicted values, time.sensor is moved to the predicted time
+ * @param orientation: where to store the predicted orientation, or nullptr. needs titania_ctx_set_fusion
+ * @note the reports are matched to the host clock by the quickest one to arrive, so reports that sat in a buffer do not count as late.
+ * @note predicts at most 100ms ahead, and never into the past. values are clamped to what the controller can report.
+ * @note the prediction starts from the calibrated report with stick curves applied, before button remapping and filtering.
+ * @return TITANIA_ERROR_NOT_SUPPORTED if prediction (or fusion, for orientation) is not enabled, TITANIA_ERROR_INVALID_DATA if nothing was pulled since
+ */
+TITANIA_EXPORT titania_error titania_ctx_predict(titania_context* ctx, const titania_handle handle, const uint64_t target_host_time, titania_data* data, titania_orientation* orientation);
+
+/**
+ * @brief get the calibration input reports from a controller are converted with, see titania_decode.h
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param calibration: where to store the calibration
+ */
+TITANIA_EXPORT titania_error titania_ctx_get_calibration(titania_context* ctx, const titania_handle handle, titania_calibration calibration[TITANIA_CALIBRATION_COUNT]);
+
+/**
+ * @brief convert many raw input reports at once into a structure-of-arrays
+ * @param ctx: the context that owns the handles
+ * @param reports: pointer to an array of raw reports, from any number of open controllers
+ * @param count: array size of reports, and of every array in batch
+ * @param batch: where to store the converted channels
+ * @note values match what titania_ctx_pull would have returned for the same report with the controller's current calibration.
+ */
+TITANIA_EXPORT titania_error titania_ctx_convert_batch(titania_context* ctx, const titania_raw_report* reports, const size_t count, const titania_batch* batch);
+
+/**
+ * @brief update LED state of a controller
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param data: led update data
+ */
+TITANIA_EXPORT titania_error titania_ctx_update_led(titania_context* ctx, const titania_handle handle, const titania_led_update data);
+
+/**
+ * @brief update audio state of a controller
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param data: audio update data
+ */
+TITANIA_EXPORT titania_error titania_ctx_update_audio(titania_context* ctx, const titania_handle handle, const titania_audio_update data);
+
+/**
+ * @brief update control state flags of a controller
+ * @note these are controller settings, some of these options persist through device restarts
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param data: control update data
+ */
+TITANIA_EXPORT titania_error titania_ctx_update_control(titania_context* ctx, const titania_handle handle, const titania_control_update data);
+
+/**
+ * @brief get control state flags of a controller (if we've sent them this session.)
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param control: control update data
+ */
+TITANIA_EXPORT titania_error titania_ctx_get_control(titania_context* ctx, const titania_handle handle, titania_control_update* control);
+
+/**
+ * @brief update effect state of a controller
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param left_trigger: effect data for LT
+ * @param right_trigger: effect data for RT
+ * @param power_reduction: power reduction amount for trigger motors
+ */
+TITANIA_EXPORT titania_error titania_ctx_update_effect(titania_context* ctx, const titania_handle handle, const titania_effect_update left_trigger, const titania_effect_update right_trigger, const float power_reduction);
+
+/**
+ * @brief update rumble state of a controller
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param large_motor: amplitude for the large motor
+ * @param small_motor: amplitude for the small motor
+ * @param power_reduction: power reduction amount for haptic motors
+ * @param emulate_legacy_behavior: instructs the dualsense to emulate how rumble motors used to work
+ */
+TITANIA_EXPORT titania_error titania_ctx_update_rumble(titania_context* ctx, const titania_handle handle, const float large_motor, const float small_motor, const float power_reduction, const bool emulate_legacy_behavior);
+
+/**
+ * @brief pair a controller with a bluetooth adapter
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param mac: mac address of the host bluetooth adapter
+ * @param link_key: bluetooth link key
+ */
+TITANIA_EXPORT titania_error titania_ctx_bt_pair(titania_context* ctx, const titania_handle handle, const titania_mac mac, const titania_link_key link_key);
+
+/**
+ * @brief tell a controller to connect with bluetooth
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ */
+TITANIA_EXPORT titania_error titania_ctx_bt_connect(titania_context* ctx, const titania_handle handle);
+
+/**
+ * @brief tell a controller to connect with usb
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ */
+TITANIA_EXPORT titania_error titania_ctx_bt_disconnect(titania_context* ctx, const titania_handle handle);
+
+/**
+ * @brief update a dualsense edge profile
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param id: the profile id to store the profile into
+ * @param profile: the profile data to store
+ */
+TITANIA_EXPORT titania_error titania_ctx_update_edge_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id id, const titania_edge_profile profile);
+
+/**
+ * @brief update an access profile
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param id: the profile id to store the profile into
+ * @param profile: the profile data to store
+ * @note nothing is sent if the controller already holds this exact profile.
+ */
+TITANIA_EXPORT titania_error titania_ctx_update_access_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id id, const titania_access_profile profile);
+
+/**
+ * @brief fetches all dualsense edge profiles
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param profile_id: profile id to query
+ * @param profile: the profile data
+ */
+TITANIA_EXPORT titania_error titania_ctx_query_edge_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id profile_id, titania_edge_profile* profile);
+
+/**
+ * @brief fetches every dualsense edge profile slot in one pass
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param profiles: the profile data, indexed by profile id - TITANIA_PROFILE_TRIANGLE. empty slots are not valid.
+ * @note profiles are cached per handle, a profile that did not change since the last query costs a single feature report.
+ */
+TITANIA_EXPORT titania_error titania_ctx_query_edge_profiles_all(titania_context* ctx, const titania_handle handle, titania_edge_profile profiles[TITANIA_EDGE_PROFILE_COUNT]);
+
+/**
+ * @brief fetches all access profiles
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to query
+ * @param profile_id: profile id to query
+ * @param profile: the profile data
+ * @note profiles are cached per handle after the first query, changes made through another handle or process are not seen. titania_debug_get_access_profile always reads from the controller and refreshes the cache.
+ */
+TITANIA_EXPORT titania_error titania_ctx_query_access_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id profile_id, titania_access_profile* profile);
+
+/**
+ * @brief delete a dualsense edge profile
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param id: the profile id to delete
+ */
+TITANIA_EXPORT titania_error titania_ctx_delete_edge_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id id);
+
+/**
+ * @brief delete a playstation access profile
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to update
+ * @param id: the profile id to delete
+ */
+TITANIA_EXPORT titania_error titania_ctx_delete_access_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id id);
+
+/**
+ * @brief close a controller device handle
+ * @param ctx: the context that owns the handle
+ * @param handle: the controller to close
+ */
+TITANIA_EXPORT void titania_ctx_close(titania_context* ctx, const titania_handle handle);
+
+/**
+ * @brief (debug) get the underlying hid device
+ * @param ctx: the context that owns the handle
+ * @param handle: the device to query
+ * @param hid: where to store the hid device pointer
+ */
+TITANIA_EXPORT titania_error titania_ctx_debug_get_hid(titania_context* ctx, const titania_handle handle, intptr_t* hid);
+
+/**
+ * @brief (debug) get hid report ids
+ * @param ctx: the context that owns the handle
+ * @param handle: the device to query
+ * @param report_ids: where to store the hid report info
+ */
+TITANIA_EXPORT titania_error titania_ctx_debug_get_hid_report_ids(titania_context* ctx, const titania_handle handle, titania_report_id report_ids[0xFF]);
+
+/**
+ * @brief (debug) get a merged edge profile
+ * @param ctx: the context that owns the handle
+ * @param handle: the device to query
+ * @param profile_id: profile to get
+ * @param profile_data: profile data buffer
+ */
+TITANIA_EXPORT titania_error titania_ctx_debug_get_edge_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id profile_id, uint8_t profile_data[TITANIA_MERGED_REPORT_EDGE_SIZE]);
+
+/**
+ * @brief (debug) get a merged access profile
+ * @param ctx: the context that owns the handle
+ * @param handle: the device to query
+ * @param profile_id: profile to get
+ * @param profile_data: profile data buffer
+ */
+TITANIA_EXPORT titania_error titania_ctx_debug_get_access_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id profile_id, uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE]);
+
+/**
+ * @brief (debug) convert the last read input report again without reading from the device, used to benchmark conversion. call it from the thread that pulls the handle
+ * @param ctx: the context that owns the handle
+ * @param handle: the device to query
+ * @param data: the data to convert into
+ */
+TITANIA_EXPORT titania_error titania_ctx_debug_convert_input(titania_context* ctx, const titania_handle handle, titania_data* data);
+
 #ifdef __cplusplus
 }
 #endif
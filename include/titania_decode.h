@@ -0,0 +1,331 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+// header-only input report decoders, one per controller type and bus.
+// titania_open picks one per handle, consumers converting raw reports (see titania_get_history) can call the one they need directly.
+// reports are in the usb layout, 64 bytes starting with the report id (or the bluetooth header byte).
+
+#pragma once
+
+#ifndef TITANIA_DECODE_H
+#define TITANIA_DECODE_H
+
+#include <string.h>
+
+#include "titania.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*titania_decode_fn)(const titania_hid* hid_info, const uint8_t report[TITANIA_RAW_REPORT_SIZE], titania_data* data, const titania_calibration calibration[TITANIA_CALIBRATION_COUNT]);
+
+#define TITANIA_DECODE_BT (0)
+#define TITANIA_DECODE_STICKS (1)
+#define TITANIA_DECODE_TRIGGERS (5)
+#define TITANIA_DECODE_SEQUENCE (7)
+#define TITANIA_DECODE_BUTTONS (8)
+#define TITANIA_DECODE_FIRMWARE_TIME (12)
+#define TITANIA_DECODE_ACCELEROMETER (16)
+#define TITANIA_DECODE_GYRO (22)
+#define TITANIA_DECODE_SENSOR_TIME (28)
+#define TITANIA_DECODE_TEMPERATURE (32)
+#define TITANIA_DECODE_TOUCH (33)
+#define TITANIA_DECODE_TOUCH_SEQUENCE (41)
+#define TITANIA_DECODE_ADAPTIVE_TRIGGERS (42) // right, then left
+#define TITANIA_DECODE_STATE_ID (44)
+#define TITANIA_DECODE_TRIGGER_EFFECT (48)
+#define TITANIA_DECODE_BATTERY_TIME (49) // the edge profile, input, and override state on edge
+#define TITANIA_DECODE_BATTERY (53)
+#define TITANIA_DECODE_DEVICE (54)
+#define TITANIA_DECODE_CHECKSUM (56)
+
+#define TITANIA_DECODE_ACCESS_BUTTONS (16)
+#define TITANIA_DECODE_ACCESS_RAW_STICK (18)
+#define TITANIA_DECODE_ACCESS_EXTENSIONS (20)
+#define TITANIA_DECODE_ACCESS_UNKNOWN1 (28)
+#define TITANIA_DECODE_ACCESS_UNKNOWN2 (32)
+#define TITANIA_DECODE_ACCESS_UNKNOWN3 (36)
+#define TITANIA_DECODE_ACCESS_BATTERY (37)
+#define TITANIA_DECODE_ACCESS_UNKNOWN4 (38)
+#define TITANIA_DECODE_ACCESS_PROFILE (40)
+#define TITANIA_DECODE_ACCESS_E3E4 (41)
+#define TITANIA_DECODE_ACCESS_UNKNOWN6 (42)
+#define TITANIA_DECODE_ACCESS_STICK1 (43)
+#define TITANIA_DECODE_ACCESS_UNKNOWN7 (45)
+#define TITANIA_DECODE_ACCESS_STICK2 (46)
+#define TITANIA_DECODE_ACCESS_UNKNOWN8 (48)
+#define TITANIA_DECODE_ACCESS_E1E2 (49)
+#define TITANIA_DECODE_ACCESS_UNKNOWN9 (50)
+
+#define TITANIA_DECODE_BIT(value, bit) ((((value) >> (bit)) & 1) != 0)
+
+static inline uint16_t titania_decode_u16(const uint8_t* p) { return (uint16_t) (p[0] | p[1] << 8); }
+
+static inline uint32_t titania_decode_u32(const uint8_t* p) { return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24; }
+
+static inline uint64_t titania_decode_u64(const uint8_t* p) { return (uint64_t) titania_decode_u32(p) | (uint64_t) titania_decode_u32(p + 4) << 32; }
+
+static inline float titania_decode_stick(const uint8_t value) { return value / 128.0f / 2.0f; }
+
+static inline float titania_decode_level(const uint8_t value) { return value / 255.0f; }
+
+// value * scale[value < 0], value is already unbiased.
+static inline float titania_decode_calibrate(const int32_t value, const titania_calibration* calibration) { return value * calibration->scale[value < 0]; }
+
+static inline float titania_decode_battery_level(const uint8_t value) {
+	if ((value >> 4) + 1 == TITANIA_BATTERY_FULL) {
+		return 1.0f;
+	}
+
+	return (float) ((value & 0xF) * 0.1 + 0.10);
+}
+
+// dpad hat, 0 is up and every step is 45 degrees clockwise, anything past 7 is centred.
+static inline void titania_decode_dpad(const uint8_t hat, bool* up, bool* right, bool* down, bool* left) {
+	*up = hat == 0 || hat == 1 || hat == 7;
+	*right = hat == 1 || hat == 2 || hat == 3;
+	*down = hat == 3 || hat == 4 || hat == 5;
+	*left = hat == 5 || hat == 6 || hat == 7;
+}
+
+// everything shared by all controllers: time, buttons, and sticks.
+static inline void titania_decode_common(const titania_hid* hid_info, const uint8_t report[TITANIA_RAW_REPORT_SIZE], titania_data* data) {
+	memset(data, 0, sizeof(titania_data));
+	data->hid = *hid_info;
+
+	data->time.checksum = titania_decode_u64(report + TITANIA_DECODE_CHECKSUM);
+	data->time.sequence = report[TITANIA_DECODE_SEQUENCE];
+	data->time.system = titania_decode_u32(report + TITANIA_DECODE_FIRMWARE_TIME);
+
+	const uint32_t buttons = titania_decode_u32(report + TITANIA_DECODE_BUTTONS);
+	titania_decode_dpad(buttons & 0xF, &data->buttons.dpad_up, &data->buttons.dpad_right, &data->buttons.dpad_down, &data->buttons.dpad_left);
+	data->buttons.square = TITANIA_DECODE_BIT(buttons, 4);
+	data->buttons.cross = TITANIA_DECODE_BIT(buttons, 5);
+	data->buttons.circle = TITANIA_DECODE_BIT(buttons, 6);
+	data->buttons.triangle = TITANIA_DECODE_BIT(buttons, 7);
+	data->buttons.l1 = TITANIA_DECODE_BIT(buttons, 8);
+	data->buttons.r1 = TITANIA_DECODE_BIT(buttons, 9);
+	data->buttons.l2 = TITANIA_DECODE_BIT(buttons, 10);
+	data->buttons.r2 = TITANIA_DECODE_BIT(buttons, 11);
+	data->buttons.create = TITANIA_DECODE_BIT(buttons, 12);
+	data->buttons.option = TITANIA_DECODE_BIT(buttons, 13);
+	data->buttons.l3 = TITANIA_DECODE_BIT(buttons, 14);
+	data->buttons.r3 = TITANIA_DECODE_BIT(buttons, 15);
+	data->buttons.playstation = TITANIA_DECODE_BIT(buttons, 16);
+	data->buttons.touch = TITANIA_DECODE_BIT(buttons, 17);
+	data->buttons.mute = TITANIA_DECODE_BIT(buttons, 18);
+	data->buttons.reserved = TITANIA_DECODE_BIT(buttons, 19);
+	data->buttons.edge_f1 = TITANIA_DECODE_BIT(buttons, 20);
+	data->buttons.edge_f2 = TITANIA_DECODE_BIT(buttons, 21);
+	data->buttons.edge_left_paddle = TITANIA_DECODE_BIT(buttons, 22);
+	data->buttons.edge_right_paddle = TITANIA_DECODE_BIT(buttons, 23);
+	data->buttons.edge_reserved = (uint8_t) (buttons >> 24);
+
+	data->sticks[TITANIA_LEFT].x = titania_decode_stick(report[TITANIA_DECODE_STICKS + 0]);
+	data->sticks[TITANIA_LEFT].y = titania_decode_stick(report[TITANIA_DECODE_STICKS + 1]);
+	data->sticks[TITANIA_RIGHT].x = titania_decode_stick(report[TITANIA_DECODE_STICKS + 2]);
+	data->sticks[TITANIA_RIGHT].y = titania_decode_stick(report[TITANIA_DECODE_STICKS + 3]);
+}
+
+static inline void titania_decode_touch(const uint8_t* touch, titania_touchpad* data) {
+	data->id = touch[0] & 0x7F;
+	data->active = (touch[0] & 0x80) == 0;
+	data->pos.x = touch[1] | (touch[2] & 0xF) << 8;
+	data->pos.y = touch[2] >> 4 | touch[3] << 4;
+}
+
+static inline void titania_decode_dualsense_usb(const titania_hid* hid_info, const uint8_t report[TITANIA_RAW_REPORT_SIZE], titania_data* data, const titania_calibration calibration[TITANIA_CALIBRATION_COUNT]) {
+	titania_decode_common(hid_info, report, data);
+
+	data->time.touch_sequence = report[TITANIA_DECODE_TOUCH_SEQUENCE];
+	data->time.sensor = titania_decode_u32(report + TITANIA_DECODE_SENSOR_TIME);
+	data->time.driver_sequence = titania_decode_u32(report + TITANIA_DECODE_STATE_ID);
+	data->time.battery = titania_decode_u32(report + TITANIA_DECODE_BATTERY_TIME);
+
+	data->state_id = data->time.driver_sequence;
+
+	const uint8_t effect = report[TITANIA_DECODE_TRIGGER_EFFECT];
+	data->triggers[TITANIA_LEFT].level = titania_decode_level(report[TITANIA_DECODE_TRIGGERS + 0]);
+	data->triggers[TITANIA_LEFT].id = report[TITANIA_DECODE_ADAPTIVE_TRIGGERS + 1] & 0xF;
+	data->triggers[TITANIA_LEFT].section = report[TITANIA_DECODE_ADAPTIVE_TRIGGERS + 1] >> 4;
+	data->triggers[TITANIA_LEFT].effect = (titania_trigger_effect_state) (effect >> 4);
+	data->triggers[TITANIA_RIGHT].level = titania_decode_level(report[TITANIA_DECODE_TRIGGERS + 1]);
+	data->triggers[TITANIA_RIGHT].id = report[TITANIA_DECODE_ADAPTIVE_TRIGGERS + 0] & 0xF;
+	data->triggers[TITANIA_RIGHT].section = report[TITANIA_DECODE_ADAPTIVE_TRIGGERS + 0] >> 4;
+	data->triggers[TITANIA_RIGHT].effect = (titania_trigger_effect_state) (effect & 0xF);
+
+	titania_decode_touch(report + TITANIA_DECODE_TOUCH, &data->touch[TITANIA_PRIMARY]);
+	titania_decode_touch(report + TITANIA_DECODE_TOUCH + 4, &data->touch[TITANIA_SECONDARY]);
+	data->buttons.touchpad = data->touch[TITANIA_PRIMARY].active || data->touch[TITANIA_SECONDARY].active;
+
+	// slots are gyro x, y, z, then accelerometer x, y, z. the accelerometer has no bias.
+	const uint8_t* accelerometer = report + TITANIA_DECODE_ACCELEROMETER;
+	const uint8_t* gyro = report + TITANIA_DECODE_GYRO;
+	data->sensors.accelerometer.x = titania_decode_calibrate((int16_t) titania_decode_u16(accelerometer + 0), &calibration[3]);
+	data->sensors.accelerometer.y = titania_decode_calibrate((int16_t) titania_decode_u16(accelerometer + 2), &calibration[4]);
+	data->sensors.accelerometer.z = titania_decode_calibrate((int16_t) titania_decode_u16(accelerometer + 4), &calibration[5]);
+	data->sensors.gyro.x = titania_decode_calibrate((int16_t) titania_decode_u16(gyro + 0) - calibration[0].bias, &calibration[0]);
+	data->sensors.gyro.y = titania_decode_calibrate((int16_t) titania_decode_u16(gyro + 2) - calibration[1].bias, &calibration[1]);
+	data->sensors.gyro.z = titania_decode_calibrate((int16_t) titania_decode_u16(gyro + 4) - calibration[2].bias, &calibration[2]);
+	data->sensors.temperature = report[TITANIA_DECODE_TEMPERATURE];
+
+	const uint16_t device = titania_decode_u16(report + TITANIA_DECODE_DEVICE);
+	data->device.headphones = TITANIA_DECODE_BIT(device, 0);
+	data->device.headset = TITANIA_DECODE_BIT(device, 1);
+	data->device.muted = TITANIA_DECODE_BIT(device, 2);
+	data->device.usb_data = TITANIA_DECODE_BIT(device, 3);
+	data->device.usb_power = TITANIA_DECODE_BIT(device, 4);
+	data->device.external_mic = TITANIA_DECODE_BIT(device, 8);
+	data->device.haptic_filter = TITANIA_DECODE_BIT(device, 9);
+	data->device.reserved = (uint16_t) ((device >> 5 & 0x7) | (device >> 10) << 3);
+
+	data->battery.state = (titania_battery_state) ((report[TITANIA_DECODE_BATTERY] >> 4) + 1);
+	data->battery.level = titania_decode_battery_level(report[TITANIA_DECODE_BATTERY]);
+}
+
+static inline void titania_decode_bt_header(const uint8_t report[TITANIA_RAW_REPORT_SIZE], titania_data* data) {
+	const uint8_t bt = report[TITANIA_DECODE_BT];
+	data->bt.has_hid = TITANIA_DECODE_BIT(bt, 0);
+	data->bt.unknown = TITANIA_DECODE_BIT(bt, 1);
+	data->bt.unknown2 = TITANIA_DECODE_BIT(bt, 2);
+	data->bt.unknown3 = TITANIA_DECODE_BIT(bt, 3);
+	data->bt.seq = bt >> 4;
+}
+
+static inline void titania_decode_dualsense_bt(const titania_hid* hid_info, const uint8_t report[TITANIA_RAW_REPORT_SIZE], titania_data* data, const titania_calibration calibration[TITANIA_CALIBRATION_COUNT]) {
+	titania_decode_dualsense_usb(hid_info, report, data, calibration);
+	titania_decode_bt_header(report, data);
+}
+
+// the edge re-uses the battery time for its profile, stick, and button override state.
+static inline void titania_decode_edge_state(const uint8_t report[TITANIA_RAW_REPORT_SIZE], titania_data* data) {
+	const uint8_t profile = report[TITANIA_DECODE_BATTERY_TIME + 0];
+	const uint8_t input = report[TITANIA_DECODE_BATTERY_TIME + 1];
+	const uint16_t override = titania_decode_u16(report + TITANIA_DECODE_BATTERY_TIME + 2);
+
+	data->time.battery = data->time.system + data->time.sensor;
+	titania_decode_dpad(override & 0xF, &data->edge_device.raw_buttons.dpad_up, &data->edge_device.raw_buttons.dpad_right, &data->edge_device.raw_buttons.dpad_down, &data->edge_device.raw_buttons.dpad_left);
+	data->edge_device.raw_buttons.square = TITANIA_DECODE_BIT(override, 4);
+	data->edge_device.raw_buttons.cross = TITANIA_DECODE_BIT(override, 5);
+	data->edge_device.raw_buttons.circle = TITANIA_DECODE_BIT(override, 6);
+	data->edge_device.raw_buttons.triangle = TITANIA_DECODE_BIT(override, 7);
+	data->edge_device.emulating_rumble = TITANIA_DECODE_BIT(override, 8);
+	data->edge_device.brightness = (titania_level) (override >> 9 & 0x3);
+	data->edge_device.unknown = override >> 11 & 0x3;
+	data->edge_device.raw_buttons.playstation = TITANIA_DECODE_BIT(override, 13);
+	data->edge_device.raw_buttons.create = TITANIA_DECODE_BIT(override, 14);
+	data->edge_device.raw_buttons.option = TITANIA_DECODE_BIT(override, 15);
+
+	data->edge_device.stick.disconnected = TITANIA_DECODE_BIT(input, 0);
+	data->edge_device.stick.errored = TITANIA_DECODE_BIT(input, 1);
+	data->edge_device.stick.calibrating = TITANIA_DECODE_BIT(input, 2);
+	data->edge_device.stick.unknown = TITANIA_DECODE_BIT(input, 3);
+	data->edge_device.trigger_levels[TITANIA_LEFT] = (titania_level) (input >> 4 & 0x3);
+	data->edge_device.trigger_levels[TITANIA_RIGHT] = (titania_level) (input >> 6 & 0x3);
+	data->edge_device.current_profile_id = (titania_profile_id) (profile >> 4 & 0x7);
+	data->edge_device.profile_indicator.switching_disabled = TITANIA_DECODE_BIT(profile, 7);
+	data->edge_device.profile_indicator.led = TITANIA_DECODE_BIT(profile, 2);
+	data->edge_device.profile_indicator.vibration = TITANIA_DECODE_BIT(profile, 3);
+	data->edge_device.profile_indicator.unknown1 = TITANIA_DECODE_BIT(profile, 0);
+	data->edge_device.profile_indicator.unknown2 = TITANIA_DECODE_BIT(profile, 1);
+}
+
+static inline void titania_decode_edge_usb(const titania_hid* hid_info, const uint8_t report[TITANIA_RAW_REPORT_SIZE], titania_data* data, const titania_calibration calibration[TITANIA_CALIBRATION_COUNT]) {
+	titania_decode_dualsense_usb(hid_info, report, data, calibration);
+	titania_decode_edge_state(report, data);
+}
+
+static inline void titania_decode_edge_bt(const titania_hid* hid_info, const uint8_t report[TITANIA_RAW_REPORT_SIZE], titania_data* data, const titania_calibration calibration[TITANIA_CALIBRATION_COUNT]) {
+	titania_decode_edge_usb(hid_info, report, data, calibration);
+	titania_decode_bt_header(report, data);
+}
+
+static inline void titania_decode_access_extension(const uint8_t* pos, const uint8_t port, titania_access_extension* data) {
+	data->pos.x = titania_decode_level(pos[0]);
+	data->pos.y = titania_decode_level(pos[1]);
+	data->type = (titania_access_extension_id) port;
+}
+
+// access controllers have no triggers, touchpad, or sensors, and nothing bluetooth specific in their report.
+static inline void titania_decode_access_usb(const titania_hid* hid_info, const uint8_t report[TITANIA_RAW_REPORT_SIZE], titania_data* data, const titania_calibration calibration[TITANIA_CALIBRATION_COUNT]) {
+	(void) calibration;
+	titania_decode_common(hid_info, report, data);
+
+	data->battery.state = (titania_battery_state) ((report[TITANIA_DECODE_ACCESS_BATTERY] >> 4) + 1);
+	data->battery.level = titania_decode_battery_level(report[TITANIA_DECODE_ACCESS_BATTERY]);
+
+	const uint16_t buttons = titania_decode_u16(report + TITANIA_DECODE_ACCESS_BUTTONS);
+	const uint8_t* extensions = report + TITANIA_DECODE_ACCESS_EXTENSIONS;
+	data->access_device.buttons.button1 = TITANIA_DECODE_BIT(buttons, 0);
+	data->access_device.buttons.button2 = TITANIA_DECODE_BIT(buttons, 1);
+	data->access_device.buttons.button3 = TITANIA_DECODE_BIT(buttons, 2);
+	data->access_device.buttons.button4 = TITANIA_DECODE_BIT(buttons, 3);
+	data->access_device.buttons.button5 = TITANIA_DECODE_BIT(buttons, 4);
+	data->access_device.buttons.button6 = TITANIA_DECODE_BIT(buttons, 5);
+	data->access_device.buttons.button7 = TITANIA_DECODE_BIT(buttons, 6);
+	data->access_device.buttons.button8 = TITANIA_DECODE_BIT(buttons, 7);
+	data->access_device.buttons.center_button = TITANIA_DECODE_BIT(buttons, 8);
+	data->access_device.buttons.stick_button = TITANIA_DECODE_BIT(buttons, 9);
+	data->access_device.buttons.playstation = TITANIA_DECODE_BIT(buttons, 10);
+	data->access_device.buttons.profile = TITANIA_DECODE_BIT(buttons, 11);
+	data->access_device.buttons.reserved = buttons >> 12;
+	data->access_device.buttons.e1 = extensions[0] != 0 || extensions[1] != 0;
+	data->access_device.buttons.e2 = extensions[2] != 0 || extensions[3] != 0;
+	data->access_device.buttons.e3 = extensions[4] != 0 || extensions[5] != 0;
+	data->access_device.buttons.e4 = extensions[6] != 0 || extensions[7] != 0;
+
+	data->access_device.raw_stick.x = titania_decode_stick(report[TITANIA_DECODE_ACCESS_RAW_STICK + 0]);
+	data->access_device.raw_stick.y = titania_decode_stick(report[TITANIA_DECODE_ACCESS_RAW_STICK + 1]);
+
+	data->access_device.sticks[TITANIA_PRIMARY].x = titania_decode_stick(report[TITANIA_DECODE_ACCESS_STICK1 + 0]);
+	data->access_device.sticks[TITANIA_PRIMARY].y = titania_decode_stick(report[TITANIA_DECODE_ACCESS_STICK1 + 1]);
+	data->access_device.sticks[TITANIA_SECONDARY].x = titania_decode_stick(report[TITANIA_DECODE_ACCESS_STICK2 + 0]);
+	data->access_device.sticks[TITANIA_SECONDARY].y = titania_decode_stick(report[TITANIA_DECODE_ACCESS_STICK2 + 1]);
+
+	const uint8_t profile = report[TITANIA_DECODE_ACCESS_PROFILE];
+	data->access_device.current_profile_id = (titania_profile_id) ((profile & 0x7) + 1);
+	data->access_device.profile_switching_disabled = TITANIA_DECODE_BIT(profile, 3);
+
+	const uint8_t e1e2 = report[TITANIA_DECODE_ACCESS_E1E2];
+	const uint8_t e3e4 = report[TITANIA_DECODE_ACCESS_E3E4];
+	titania_decode_access_extension(extensions + 0, e1e2 & 0xF, &data->access_device.extensions[TITANIA_EXTENSION1]);
+	titania_decode_access_extension(extensions + 2, e1e2 >> 4, &data->access_device.extensions[TITANIA_EXTENSION2]);
+	titania_decode_access_extension(extensions + 4, e3e4 & 0xF, &data->access_device.extensions[TITANIA_EXTENSION3]);
+	titania_decode_access_extension(extensions + 6, e3e4 >> 4, &data->access_device.extensions[TITANIA_EXTENSION4]);
+
+	data->access_device.unknown1 = titania_decode_u32(report + TITANIA_DECODE_ACCESS_UNKNOWN1);
+	data->access_device.unknown2 = titania_decode_u32(report + TITANIA_DECODE_ACCESS_UNKNOWN2);
+	data->access_device.unknown3 = report[TITANIA_DECODE_ACCESS_UNKNOWN3];
+	data->access_device.unknown4 = titania_decode_u16(report + TITANIA_DECODE_ACCESS_UNKNOWN4);
+	data->access_device.unknown5 = profile >> 4;
+	data->access_device.unknown6 = report[TITANIA_DECODE_ACCESS_UNKNOWN6];
+	data->access_device.unknown7 = report[TITANIA_DECODE_ACCESS_UNKNOWN7];
+	data->access_device.unknown8 = report[TITANIA_DECODE_ACCESS_UNKNOWN8];
+	data->access_device.unknown9 = titania_decode_u32(report + TITANIA_DECODE_ACCESS_UNKNOWN9);
+}
+
+static inline void titania_decode_access_bt(const titania_hid* hid_info, const uint8_t report[TITANIA_RAW_REPORT_SIZE], titania_data* data, const titania_calibration calibration[TITANIA_CALIBRATION_COUNT]) {
+	titania_decode_access_usb(hid_info, report, data, calibration);
+}
+
+static inline titania_decode_fn titania_select_decoder(const bool is_edge, const bool is_access, const bool is_bluetooth) {
+	if (is_access) {
+		return is_bluetooth ? titania_decode_access_bt : titania_decode_access_usb;
+	}
+
+	if (is_edge) {
+		return is_bluetooth ? titania_decode_edge_bt : titania_decode_edge_usb;
+	}
+
+	return is_bluetooth ? titania_decode_dualsense_bt : titania_decode_dualsense_usb;
+}
+
+#undef TITANIA_DECODE_BIT
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
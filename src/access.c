@@ -9,8 +9,8 @@
 #include "structures.h"
 #include "unicode.h"
 
-titania_error titania_update_access_led(const titania_handle handle, const titania_led_update data) {
-	access_output_msg* hid_state = &state[handle].output.data.msg.access;
+titania_error titania_update_access_led(titania_context* ctx, const titania_handle handle, const titania_led_update data) {
+	access_output_msg* hid_state = &ctx->state[handle].output.data.msg.access;
 
 	if (data.color.x >= 0.0f && data.color.y >= 0.0f && data.color.z >= 0.0f) {
 		hid_state->flags.led = true;
@@ -86,13 +86,7 @@ titania_error titania_convert_access_profile_input(uint8_t profile_data[TITANIA_
 
 	const playstation_access_profile profile = *(playstation_access_profile*) profile_data;
 
-	titania_char32 unicode[41];
-	titania_unicode_result unicode_result = titania_utf16_to_utf32((const titania_char16*) &profile.msg.name, sizeof(profile.msg.name), unicode, sizeof(unicode));
-	if (unicode_result.failed) {
-		return TITANIA_ERROR_UNICODE_ERROR;
-	}
-
-	unicode_result = titania_utf32_to_utf8(unicode, sizeof(unicode), (titania_char8*) &output->name, sizeof(output->name));
+	const titania_unicode_result unicode_result = titania_utf16_to_utf8((const titania_char16*) &profile.msg.name, sizeof(profile.msg.name) / sizeof(titania_char16), (titania_char8*) &output->name, sizeof(output->name));
 	if (unicode_result.failed) {
 		return TITANIA_ERROR_UNICODE_ERROR;
 	}
@@ -125,10 +119,37 @@ titania_error titania_convert_access_profile_input(uint8_t profile_data[TITANIA_
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_debug_get_access_profile(const titania_handle handle, const titania_profile_id profile_id, uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE]) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
-	CHECK_ACCESS(handle);
+void titania_invalidate_access_profile(dualsense_state* hid_state, const titania_profile_id profile_id) {
+	LOCK_INFO(hid_state);
+	for (int i = 0; i < TITANIA_ACCESS_PROFILE_COUNT; ++i) {
+		if (profile_id == TITANIA_PROFILE_ALL || profile_id == (titania_profile_id) (TITANIA_PROFILE_DEFAULT + i)) {
+			hid_state->access_profiles[i].has_data = false;
+			hid_state->access_profiles[i].has_profile = false;
+		}
+	}
+	UNLOCK_INFO(hid_state);
+}
+
+void titania_store_access_profile(dualsense_state* hid_state, const titania_profile_id profile_id, const uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE]) {
+	titania_access_profile_cache* cache = &hid_state->access_profiles[profile_id - TITANIA_PROFILE_DEFAULT];
+	LOCK_INFO(hid_state);
+	memcpy(cache->data, profile_data, TITANIA_MERGED_REPORT_ACCESS_SIZE);
+	cache->has_data = true;
+	cache->has_profile = false;
+	UNLOCK_INFO(hid_state);
+}
+
+bool titania_is_access_profile_cached(dualsense_state* hid_state, const titania_profile_id profile_id, const uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE]) {
+	const titania_access_profile_cache* cache = &hid_state->access_profiles[profile_id - TITANIA_PROFILE_DEFAULT];
+	LOCK_INFO(hid_state);
+	const bool is_cached = cache->has_data && memcmp(cache->data, profile_data, TITANIA_MERGED_REPORT_ACCESS_SIZE) == 0;
+	UNLOCK_INFO(hid_state);
+	return is_cached;
+}
+
+// always reads from the controller, and refreshes the cached copy while at it.
+static titania_error titania_debug_get_access_profile_impl(titania_context* ctx, const titania_handle handle, const titania_profile_id profile_id, uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE]) {
+	CHECK_ACCESS(ctx, handle);
 
 	playstation_access_profile_blob data = { 0 };
 
@@ -141,13 +162,13 @@ titania_error titania_debug_get_access_profile(const titania_handle handle, cons
 		default: return TITANIA_ERROR_INVALID_PROFILE;
 	}
 
-	if (HID_FAIL(hid_send_feature_report(state[handle].hid, (uint8_t*) &data, sizeof(playstation_access_profile_blob)))) {
+	if (HID_FAIL(hid_send_feature_report(ctx->state[handle].hid, (uint8_t*) &data, sizeof(playstation_access_profile_blob)))) {
 		return TITANIA_ERROR_INVALID_PROFILE;
 	}
 
 	for (int i = 0; i < 0x12; ++i) {
 		data.report_id = ACCESS_REPORT_GET_PROFILE;
-		if (HID_FAIL(hid_get_feature_report(state[handle].hid, (uint8_t*) &data, sizeof(playstation_access_profile_blob)))) {
+		if (HID_FAIL(hid_get_feature_report(ctx->state[handle].hid, (uint8_t*) &data, sizeof(playstation_access_profile_blob)))) {
 			return TITANIA_ERROR_INVALID_DATA;
 		}
 
@@ -163,27 +184,78 @@ titania_error titania_debug_get_access_profile(const titania_handle handle, cons
 		memcpy(&profile_data[sizeof(data.select_op.blob) * i], data.select_op.blob, s);
 	}
 
+	titania_store_access_profile(&ctx->state[handle], profile_id, profile_data);
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_query_access_profile(const titania_handle handle, const titania_profile_id profile_id, titania_access_profile* profile) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
-	CHECK_ACCESS(handle);
+titania_error titania_ctx_debug_get_access_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id profile_id, uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE]) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_debug_get_access_profile_impl(ctx, handle, profile_id, profile_data);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
 
-	uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE];
-	titania_error result = titania_debug_get_access_profile(handle, profile_id, profile_data);
-	if (IS_TITANIA_BAD(result)) {
+static titania_error titania_query_access_profile_impl(titania_context* ctx, const titania_handle handle, const titania_profile_id profile_id, titania_access_profile* profile) {
+	CHECK_ACCESS(ctx, handle);
+
+	if (profile_id < TITANIA_PROFILE_DEFAULT || profile_id > TITANIA_PROFILE_3) {
 		profile->valid = false;
-		return result;
+		return TITANIA_ERROR_INVALID_PROFILE;
+	}
+
+	// reading a profile back takes 0x13 feature reports, and profiles only change when they are written.
+	// so the cached copy is trusted until this handle writes or deletes the profile.
+	dualsense_state* hid_state = &ctx->state[handle];
+	titania_access_profile_cache* cache = &hid_state->access_profiles[profile_id - TITANIA_PROFILE_DEFAULT];
+	uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE];
+	LOCK_INFO(hid_state);
+	const bool has_profile = cache->has_profile;
+	const bool has_data = cache->has_data;
+	if (has_profile) {
+		*profile = cache->profile;
+	} else if (has_data) {
+		memcpy(profile_data, cache->data, TITANIA_MERGED_REPORT_ACCESS_SIZE);
+	}
+	UNLOCK_INFO(hid_state);
+
+	if (has_profile) {
+		return TITANIA_ERROR_OK;
+	}
+
+	titania_error result = TITANIA_ERROR_OK;
+	if (!has_data) {
+		result = titania_debug_get_access_profile_impl(ctx, handle, profile_id, profile_data);
+		if (IS_TITANIA_BAD(result)) {
+			profile->valid = false;
+			return result;
+		}
 	}
 
 	result = titania_convert_access_profile_input(profile_data, profile);
 	if (IS_TITANIA_BAD(result)) {
 		memset(profile, 0, sizeof(titania_access_profile));
 		profile->valid = false;
+		return result;
 	}
 
+	LOCK_INFO(hid_state);
+	if (cache->has_data && memcmp(cache->data, profile_data, TITANIA_MERGED_REPORT_ACCESS_SIZE) == 0) {
+		cache->profile = *profile;
+		cache->has_profile = true;
+	}
+	UNLOCK_INFO(hid_state);
+
+	return result;
+}
+
+titania_error titania_ctx_query_access_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id profile_id, titania_access_profile* profile) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_query_access_profile_impl(ctx, handle, profile_id, profile);
+	RELEASE_HANDLE(ctx, handle);
 	return result;
 }
 
@@ -216,18 +288,12 @@ void convert_extension_out(titania_access_profile_extension value, playstation_a
 	}
 }
 
-titania_error titania_convert_access_profile_output(titania_access_profile input, playstation_access_profile_blob output[0x12]) {
+titania_error titania_convert_access_profile_output(titania_access_profile input, uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE], playstation_access_profile_blob output[0x12]) {
 	playstation_access_profile profile = { 0 };
 
 	profile.msg.version = 1;
 
-	titania_char32 unicode[41];
-	titania_unicode_result unicode_result = titania_utf8_to_utf32((const titania_char8*) &input.name, sizeof(input.name), unicode, sizeof(unicode));
-	if (unicode_result.failed) {
-		return TITANIA_ERROR_UNICODE_ERROR;
-	}
-
-	unicode_result = titania_utf32_to_utf16(unicode, sizeof(unicode), (titania_char16*) &profile.msg.name, sizeof(profile.msg.name));
+	const titania_unicode_result unicode_result = titania_utf8_to_utf16((const titania_char8*) &input.name, sizeof(input.name), (titania_char16*) &profile.msg.name, sizeof(profile.msg.name) / sizeof(titania_char16));
 	if (unicode_result.failed) {
 		return TITANIA_ERROR_UNICODE_ERROR;
 	}
@@ -276,6 +342,7 @@ titania_error titania_convert_access_profile_output(titania_access_profile input
 		memcpy(output[i].blob, profile.buffers[i], sizeof(*profile.buffers));
 	}
 	memcpy(output[0x11].blob, profile.tail, sizeof(profile.tail));
+	memcpy(profile_data, &profile, TITANIA_MERGED_REPORT_ACCESS_SIZE);
 
 	return TITANIA_ERROR_OK;
 }
@@ -0,0 +1,167 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <string.h>
+
+#include "structures.h"
+
+#define TITANIA_ACK_TIMEOUT (100000000ull) // nanoseconds before a write that was never echoed back stops holding the next one
+#define TITANIA_ACK_AVERAGE (8) // the newest latency counts for one part in this of the average
+
+#define TITANIA_ACK_MASK (TITANIA_ACK_QUEUE_SIZE - 1)
+
+// writes are tracked in the order they were made, so once the newest has timed out every one of them has.
+bool titania_ack_hold(dualsense_state* hid_state) {
+	titania_ack_state* ack = &hid_state->ack;
+	if (!ack->backpressure) {
+		return false;
+	}
+
+	const unsigned int head = atomic_load_explicit(&ack->head, memory_order_acquire);
+	const unsigned int tail = atomic_load_explicit(&ack->tail, memory_order_relaxed);
+	if (head == tail || titania_host_time() - ack->in_flight[(tail - 1) & TITANIA_ACK_MASK].host_time > TITANIA_ACK_TIMEOUT) {
+		return false;
+	}
+
+	atomic_fetch_add_explicit(&ack->deferred, 1, memory_order_relaxed);
+	return true;
+}
+
+void titania_ack_sent(dualsense_state* hid_state, const uint32_t state_id) {
+	titania_ack_state* ack = &hid_state->ack;
+	const unsigned int head = atomic_load_explicit(&ack->head, memory_order_acquire);
+	const unsigned int tail = atomic_load_explicit(&ack->tail, memory_order_relaxed);
+	if (tail - head < TITANIA_ACK_QUEUE_SIZE) {
+		ack->in_flight[tail & TITANIA_ACK_MASK] = (titania_ack_entry) { .state_id = state_id, .host_time = titania_host_time() };
+		atomic_store_explicit(&ack->tail, tail + 1, memory_order_release);
+	} else {
+		atomic_fetch_add_explicit(&ack->dropped, 1, memory_order_relaxed);
+	}
+
+	atomic_store_explicit(&ack->pushed_state_id, state_id, memory_order_release);
+	atomic_store_explicit(&ack->deferred, 0, memory_order_relaxed);
+}
+
+void titania_ack_forget(dualsense_state* hid_state) {
+	titania_ack_state* ack = &hid_state->ack;
+	const unsigned int head = atomic_load_explicit(&ack->head, memory_order_relaxed);
+	const unsigned int tail = atomic_load_explicit(&ack->tail, memory_order_acquire);
+	hid_state->ack_stats.lost += tail - head;
+	atomic_store_explicit(&ack->head, tail, memory_order_release);
+}
+
+bool titania_ack_update(dualsense_state* hid_state) {
+	if (hid_state->hid_info.is_access) {
+		return false;
+	}
+
+	titania_ack_state* ack = &hid_state->ack;
+	titania_ack_stats* stats = &hid_state->ack_stats;
+	const uint32_t state_id = hid_state->input.data.msg.data.state_id;
+	const uint64_t now = titania_host_time();
+	// the pushed id is read first, every write up to it is then in the queue.
+	const uint32_t pushed_state_id = atomic_load_explicit(&ack->pushed_state_id, memory_order_acquire);
+	const unsigned int tail = atomic_load_explicit(&ack->tail, memory_order_acquire);
+	unsigned int head = atomic_load_explicit(&ack->head, memory_order_relaxed);
+	// an id newer than anything written is left over from before the controller was opened.
+	if ((int32_t) (pushed_state_id - state_id) >= 0) {
+		// the controller only echoes the newest report it applied, everything written before it is applied as well.
+		while (head != tail) {
+			const titania_ack_entry* entry = &ack->in_flight[head & TITANIA_ACK_MASK];
+			if ((int32_t) (state_id - entry->state_id) < 0) {
+				break;
+			}
+
+			if (entry->state_id == state_id) {
+				stats->latency = now - entry->host_time;
+				stats->min_latency = stats->acked == 0 || stats->latency < stats->min_latency ? stats->latency : stats->min_latency;
+				stats->average_latency = stats->acked == 0 ? stats->latency : stats->average_latency + ((int64_t) stats->latency - (int64_t) stats->average_latency) / TITANIA_ACK_AVERAGE;
+			}
+
+			stats->acked_state_id = state_id;
+			stats->acked++;
+			head++;
+		}
+	}
+
+	while (head != tail && now - ack->in_flight[head & TITANIA_ACK_MASK].host_time > TITANIA_ACK_TIMEOUT) {
+		stats->lost++;
+		head++;
+	}
+
+	atomic_store_explicit(&ack->head, head, memory_order_release);
+	return head == tail && atomic_load_explicit(&ack->deferred, memory_order_relaxed) > 0;
+}
+
+static titania_error titania_set_output_backpressure_impl(titania_context* ctx, const titania_handle handle, const bool enabled) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	if (hid_state->hid_info.is_access) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	LOCK_OUTPUT(hid_state);
+	hid_state->ack.backpressure = enabled;
+	UNLOCK_OUTPUT(hid_state);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_set_output_backpressure(titania_context* ctx, const titania_handle handle, const bool enabled) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_set_output_backpressure_impl(ctx, handle, enabled);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_get_output_ack_impl(titania_context* ctx, const titania_handle handle, titania_output_ack* output_ack) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	if (hid_state->hid_info.is_access) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	LOCK_INFO(hid_state);
+	const titania_ack_stats stats = titania_results_read(hid_state)->ack;
+	UNLOCK_INFO(hid_state);
+
+	// the output lock keeps titania_push from reusing the slots counted here, pull only ever retires them.
+	const uint64_t now = titania_host_time();
+	LOCK_OUTPUT(hid_state);
+	titania_ack_state* ack = &hid_state->ack;
+	unsigned int head = atomic_load_explicit(&ack->head, memory_order_acquire);
+	const unsigned int tail = atomic_load_explicit(&ack->tail, memory_order_relaxed);
+	uint32_t expired = 0;
+	while (head != tail && now - ack->in_flight[head & TITANIA_ACK_MASK].host_time > TITANIA_ACK_TIMEOUT) {
+		expired++;
+		head++;
+	}
+
+	output_ack->pushed_state_id = atomic_load_explicit(&ack->pushed_state_id, memory_order_relaxed);
+	output_ack->in_flight = tail - head;
+	output_ack->deferred = atomic_load_explicit(&ack->deferred, memory_order_relaxed);
+	output_ack->lost = stats.lost + expired + atomic_load_explicit(&ack->dropped, memory_order_relaxed);
+	UNLOCK_OUTPUT(hid_state);
+
+	output_ack->acked_state_id = stats.acked_state_id;
+	output_ack->acked = stats.acked;
+	output_ack->latency = stats.latency;
+	output_ack->min_latency = stats.min_latency;
+	output_ack->average_latency = stats.average_latency;
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_get_output_ack(titania_context* ctx, const titania_handle handle, titania_output_ack* ack) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (ack == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_get_output_ack_impl(ctx, handle, ack);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
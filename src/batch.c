@@ -0,0 +1,336 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "structures.h"
+
+#if defined(__AVX2__)
+#define TITANIA_BATCH_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TITANIA_BATCH_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define TITANIA_BATCH_NEON
+#include <arm_neon.h>
+#endif
+
+// reports are gathered into columns this many at a time, small enough to stay on the stack.
+#define TITANIA_BATCH_CHUNK (256)
+
+#define BATCH_STICK_SCALE (256.0f) // DENORM_CLAMP_INT8
+#define BATCH_TRIGGER_SCALE (255.0f) // DENORM_CLAMP_UINT8
+
+typedef enum titania_batch_column {
+	BATCH_LEFT_STICK_X,
+	BATCH_LEFT_STICK_Y,
+	BATCH_RIGHT_STICK_X,
+	BATCH_RIGHT_STICK_Y,
+	BATCH_LEFT_TRIGGER,
+	BATCH_RIGHT_TRIGGER,
+	BATCH_GYRO_X,
+	BATCH_GYRO_Y,
+	BATCH_GYRO_Z,
+	BATCH_ACCELEROMETER_X,
+	BATCH_ACCELEROMETER_Y,
+	BATCH_ACCELEROMETER_Z,
+	BATCH_COLUMN_MAX
+} titania_batch_column;
+
+typedef struct titania_batch_source {
+	bool is_loaded;
+	bool is_access;
+	titania_calibration_scale calibration[6];
+} titania_batch_source;
+
+typedef struct titania_batch_columns {
+	int32_t raw[BATCH_COLUMN_MAX][TITANIA_BATCH_CHUNK];
+	// per report calibration for the sensor columns, reports may come from different controllers.
+	int32_t bias[6][TITANIA_BATCH_CHUNK];
+	float positive[6][TITANIA_BATCH_CHUNK];
+	float negative[6][TITANIA_BATCH_CHUNK];
+} titania_batch_columns;
+
+// out = raw / divisor, a division rather than a reciprocal so results match the decoders in titania_decode.h bit for bit.
+static void titania_batch_scale(const int32_t* raw, float* out, const size_t count, const float divisor) {
+	size_t i = 0;
+#if defined(TITANIA_BATCH_AVX2)
+	const __m256 d = _mm256_set1_ps(divisor);
+	for (; i + 8 <= count; i += 8) {
+		_mm256_storeu_ps(out + i, _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*) (raw + i))), d));
+	}
+#elif defined(TITANIA_BATCH_SSE2)
+	const __m128 d = _mm_set1_ps(divisor);
+	for (; i + 4 <= count; i += 4) {
+		_mm_storeu_ps(out + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*) (raw + i))), d));
+	}
+#elif defined(TITANIA_BATCH_NEON)
+	const float32x4_t d = vdupq_n_f32(divisor);
+	for (; i + 4 <= count; i += 4) {
+		vst1q_f32(out + i, vdivq_f32(vcvtq_f32_s32(vld1q_s32(raw + i)), d));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		out[i] = raw[i] / divisor;
+	}
+}
+
+// out = (raw - bias) * (raw - bias < 0 ? negative : positive), same as CALIBRATE_BIAS.
+static void titania_batch_calibrate(const int32_t* raw, const int32_t* bias, const float* positive, const float* negative, float* out, const size_t count) {
+	size_t i = 0;
+#if defined(TITANIA_BATCH_AVX2)
+	for (; i + 8 <= count; i += 8) {
+		const __m256i v = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*) (raw + i)), _mm256_loadu_si256((const __m256i*) (bias + i)));
+		const __m256 scale = _mm256_blendv_ps(_mm256_loadu_ps(positive + i), _mm256_loadu_ps(negative + i), _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_setzero_si256(), v)));
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+	}
+#elif defined(TITANIA_BATCH_SSE2)
+	for (; i + 4 <= count; i += 4) {
+		const __m128i v = _mm_sub_epi32(_mm_loadu_si128((const __m128i*) (raw + i)), _mm_loadu_si128((const __m128i*) (bias + i)));
+		const __m128 is_negative = _mm_castsi128_ps(_mm_cmplt_epi32(v, _mm_setzero_si128()));
+		const __m128 scale = _mm_or_ps(_mm_and_ps(is_negative, _mm_loadu_ps(negative + i)), _mm_andnot_ps(is_negative, _mm_loadu_ps(positive + i)));
+		_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+	}
+#elif defined(TITANIA_BATCH_NEON)
+	for (; i + 4 <= count; i += 4) {
+		const int32x4_t v = vsubq_s32(vld1q_s32(raw + i), vld1q_s32(bias + i));
+		const float32x4_t scale = vbslq_f32(vcltq_s32(v, vdupq_n_s32(0)), vld1q_f32(negative + i), vld1q_f32(positive + i));
+		vst1q_f32(out + i, vmulq_f32(vcvtq_f32_s32(v), scale));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		const int32_t v = raw[i] - bias[i];
+		out[i] = v * (v < 0 ? negative[i] : positive[i]);
+	}
+}
+
+static titania_error titania_batch_load_source(titania_context* ctx, const titania_handle handle, titania_batch_source* source) {
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	dualsense_state* hid_state = &ctx->state[handle];
+	LOCK_INFO(hid_state);
+	source->is_access = hid_state->hid_info.is_access;
+	titania_results_calibration(hid_state, titania_results_read(hid_state), source->calibration);
+	UNLOCK_INFO(hid_state);
+	RELEASE_HANDLE(ctx, handle);
+
+	source->is_loaded = true;
+	return TITANIA_ERROR_OK;
+}
+
+static void titania_batch_gather(const titania_raw_report* report, const titania_batch_source* source, titania_batch_columns* columns, const size_t j, uint32_t* buttons) {
+	const dualsense_input_msg* input = (const dualsense_input_msg*) report->data;
+
+	columns->raw[BATCH_LEFT_STICK_X][j] = input->sticks[DUALSENSE_LEFT].x;
+	columns->raw[BATCH_LEFT_STICK_Y][j] = input->sticks[DUALSENSE_LEFT].y;
+	columns->raw[BATCH_RIGHT_STICK_X][j] = input->sticks[DUALSENSE_RIGHT].x;
+	columns->raw[BATCH_RIGHT_STICK_Y][j] = input->sticks[DUALSENSE_RIGHT].y;
+
+	// access reports have no triggers or sensors, zeroed scales give the zeroes titania_decode_access_usb leaves there.
+	if (source->is_access) {
+		columns->raw[BATCH_LEFT_TRIGGER][j] = 0;
+		columns->raw[BATCH_RIGHT_TRIGGER][j] = 0;
+		for (int k = 0; k < 6; ++k) {
+			columns->raw[BATCH_GYRO_X + k][j] = 0;
+			columns->bias[k][j] = 0;
+			columns->positive[k][j] = 0.0f;
+			columns->negative[k][j] = 0.0f;
+		}
+	} else {
+		columns->raw[BATCH_LEFT_TRIGGER][j] = input->triggers[DUALSENSE_LEFT];
+		columns->raw[BATCH_RIGHT_TRIGGER][j] = input->triggers[DUALSENSE_RIGHT];
+		columns->raw[BATCH_GYRO_X][j] = input->sensors.gyro.x;
+		columns->raw[BATCH_GYRO_Y][j] = input->sensors.gyro.y;
+		columns->raw[BATCH_GYRO_Z][j] = input->sensors.gyro.z;
+		columns->raw[BATCH_ACCELEROMETER_X][j] = input->sensors.accelerometer.x;
+		columns->raw[BATCH_ACCELEROMETER_Y][j] = input->sensors.accelerometer.y;
+		columns->raw[BATCH_ACCELEROMETER_Z][j] = input->sensors.accelerometer.z;
+
+		const int slots[6] = { CALIBRATION_GYRO_X, CALIBRATION_GYRO_Y, CALIBRATION_GYRO_Z, CALIBRATION_ACCELEROMETER_X, CALIBRATION_ACCELEROMETER_Y, CALIBRATION_ACCELEROMETER_Z };
+		for (int k = 0; k < 6; ++k) {
+			// the accelerometer is calibrated without a bias.
+			columns->bias[k][j] = k < 3 ? source->calibration[slots[k]].bias : 0;
+			columns->positive[k][j] = source->calibration[slots[k]].scale[0];
+			columns->negative[k][j] = source->calibration[slots[k]].scale[1];
+		}
+	}
+
+	if (buttons != nullptr) {
+		buttons[j] = titania_convert_buttons(input, source->is_access);
+	}
+}
+
+titania_error titania_ctx_convert_batch(titania_context* ctx, const titania_raw_report* reports, const size_t count, const titania_batch* batch) {
+	CHECK_INIT(ctx);
+
+	if (reports == nullptr || batch == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	titania_batch_source sources[TITANIA_MAX_CONTROLLERS] = { 0 };
+	titania_batch_columns* columns = malloc(sizeof(titania_batch_columns));
+	if (columns == nullptr) {
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	float* const outputs[BATCH_COLUMN_MAX] = {
+		batch->left_stick_x, batch->left_stick_y, batch->right_stick_x, batch->right_stick_y, batch->left_trigger, batch->right_trigger,
+		batch->gyro_x, batch->gyro_y, batch->gyro_z, batch->accelerometer_x, batch->accelerometer_y, batch->accelerometer_z,
+	};
+
+	for (size_t offset = 0; offset < count; offset += TITANIA_BATCH_CHUNK) {
+		const size_t n = count - offset < TITANIA_BATCH_CHUNK ? count - offset : TITANIA_BATCH_CHUNK;
+		uint32_t* buttons = batch->buttons != nullptr ? batch->buttons + offset : nullptr;
+
+		for (size_t j = 0; j < n; ++j) {
+			const titania_handle handle = reports[offset + j].handle;
+			if (handle < 0 || handle >= TITANIA_MAX_CONTROLLERS) {
+				free(columns);
+				return TITANIA_ERROR_INVALID_HANDLE;
+			}
+
+			if (!sources[handle].is_loaded) {
+				const titania_error result = titania_batch_load_source(ctx, handle, &sources[handle]);
+				if (IS_TITANIA_BAD(result)) {
+					free(columns);
+					return result;
+				}
+			}
+
+			titania_batch_gather(&reports[offset + j], &sources[handle], columns, j, buttons);
+		}
+
+		for (int k = BATCH_LEFT_STICK_X; k <= BATCH_RIGHT_STICK_Y; ++k) {
+			if (outputs[k] != nullptr) {
+				titania_batch_scale(columns->raw[k], outputs[k] + offset, n, BATCH_STICK_SCALE);
+			}
+		}
+
+		for (int k = BATCH_LEFT_TRIGGER; k <= BATCH_RIGHT_TRIGGER; ++k) {
+			if (outputs[k] != nullptr) {
+				titania_batch_scale(columns->raw[k], outputs[k] + offset, n, BATCH_TRIGGER_SCALE);
+			}
+		}
+
+		for (int k = BATCH_GYRO_X; k <= BATCH_ACCELEROMETER_Z; ++k) {
+			if (outputs[k] != nullptr) {
+				const int slot = k - BATCH_GYRO_X;
+				titania_batch_calibrate(columns->raw[k], columns->bias[slot], columns->positive[slot], columns->negative[slot], outputs[k] + offset, n);
+			}
+		}
+	}
+
+	free(columns);
+	return TITANIA_ERROR_OK;
+}
+
+void titania_history_update(dualsense_state* hid_state) {
+	titania_history* history = atomic_exchange_explicit(&hid_state->history_next, nullptr, memory_order_acquire);
+	if (history != nullptr) {
+		// titania_get_history moved on to the new ring when it was published.
+		free(hid_state->history);
+		hid_state->history = history;
+	}
+}
+
+void titania_history_write(dualsense_state* hid_state, const titania_handle handle) {
+	titania_history* history = hid_state->history;
+	const unsigned int index = atomic_load_explicit(&history->written, memory_order_relaxed);
+	atomic_store_explicit(&history->started, index + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	titania_raw_report* report = &history->reports[index & history->mask];
+	report->handle = handle;
+	memcpy(report->data, &hid_state->input.data.msg.data, sizeof(report->data));
+	atomic_store_explicit(&history->written, index + 1, memory_order_release);
+}
+
+static titania_error titania_set_history_impl(titania_context* ctx, const titania_handle handle, const size_t count) {
+	if (count > (1u << 31)) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	// a power of two so the counters can run past UINT32_MAX, an empty ring still replaces the old one.
+	uint32_t slots = 1;
+	while (slots < count) {
+		slots <<= 1;
+	}
+
+	titania_history* history = calloc(1, sizeof(titania_history) + slots * sizeof(titania_raw_report));
+	if (history == nullptr) {
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	history->capacity = (uint32_t) count;
+	history->mask = slots - 1;
+
+	// a ring pull has not picked up yet was never written to, it is simply replaced.
+	dualsense_state* hid_state = &ctx->state[handle];
+	LOCK_INFO(hid_state);
+	hid_state->history_latest = history;
+	titania_history* dropped = atomic_exchange_explicit(&hid_state->history_next, history, memory_order_acq_rel);
+	UNLOCK_INFO(hid_state);
+
+	free(dropped);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_set_history(titania_context* ctx, const titania_handle handle, const size_t count) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_set_history_impl(ctx, handle, count);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+// pull never waits for this, so the oldest reports may be overwritten while they are copied. started tells which ones were.
+static titania_error titania_get_history_impl(titania_context* ctx, const titania_handle handle, titania_raw_report* reports, const size_t count, size_t* written) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	size_t n = 0;
+	LOCK_INFO(hid_state);
+	const titania_history* history = hid_state->history_latest;
+	if (history != nullptr) {
+		const unsigned int end = atomic_load_explicit(&history->written, memory_order_acquire);
+		n = end < history->capacity ? end : history->capacity;
+		n = n < count ? n : count;
+		const unsigned int start = end - (unsigned int) n;
+		for (size_t i = 0; i < n; ++i) {
+			reports[i] = history->reports[(start + i) & history->mask];
+		}
+
+		atomic_thread_fence(memory_order_acquire);
+		const unsigned int started = atomic_load_explicit(&history->started, memory_order_relaxed);
+		size_t torn = 0;
+		while (torn < n && started - (start + (unsigned int) torn) > history->mask + 1) {
+			torn++;
+		}
+
+		if (torn > 0) {
+			memmove(reports, reports + torn, (n - torn) * sizeof(titania_raw_report));
+			n -= torn;
+		}
+	}
+	UNLOCK_INFO(hid_state);
+
+	*written = n;
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_get_history(titania_context* ctx, const titania_handle handle, titania_raw_report* reports, const size_t count, size_t* written) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if ((reports == nullptr && count > 0) || written == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_get_history_impl(ctx, handle, reports, count, written);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
@@ -0,0 +1,186 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <math.h>
+#include <string.h>
+
+#include "structures.h"
+
+// all in raw sensor units, a gyro step is about 0.06 degrees per second and 8192 accelerometer steps are 1 g.
+#define TITANIA_BIAS_AVERAGE (1.0f / 16.0f) // weight of the newest report in the running means
+#define TITANIA_BIAS_WARMUP (32) // reports before the running variances mean anything
+#define TITANIA_BIAS_GYRO_VARIANCE (36.0f) // per axis
+#define TITANIA_BIAS_GYRO_OFFSET (64.0f) // how far the mean may sit from the current bias, slow turns are not rest
+#define TITANIA_BIAS_ACCELEROMETER_VARIANCE (1600.0f) // per axis
+#define TITANIA_BIAS_REST_TICKS (1500000u) // half a second of sensor time
+#define TITANIA_BIAS_MAX_SAMPLES (2048u) // caps the learning rate so the bias keeps following slow drift
+
+static int titania_bias_bin_index(const titania_bias_state* bias, const bool use_temperature) {
+	if (!use_temperature || bias->temperature < 0) {
+		return 0;
+	}
+
+	const int bin = bias->temperature / TITANIA_GYRO_BIAS_BIN_WIDTH;
+	return bin < TITANIA_GYRO_BIAS_BINS ? bin : TITANIA_GYRO_BIAS_BINS - 1;
+}
+
+// the bin for the current temperature, or the closest one that has learned anything.
+static const titania_bias_bin* titania_bias_nearest_bin(const titania_bias_state* bias, const bool use_temperature) {
+	const int bin = titania_bias_bin_index(bias, use_temperature);
+	for (int distance = 0; distance < TITANIA_GYRO_BIAS_BINS; ++distance) {
+		if (bin - distance >= 0 && bias->bins[bin - distance].samples > 0) {
+			return &bias->bins[bin - distance];
+		}
+
+		if (bin + distance < TITANIA_GYRO_BIAS_BINS && bias->bins[bin + distance].samples > 0) {
+			return &bias->bins[bin + distance];
+		}
+	}
+
+	return nullptr;
+}
+
+static void titania_bias_average(float mean[3], float variance[3], const float value[3]) {
+	for (int j = 0; j < 3; ++j) {
+		const float delta = value[j] - mean[j];
+		mean[j] += delta * TITANIA_BIAS_AVERAGE;
+		variance[j] = (1.0f - TITANIA_BIAS_AVERAGE) * (variance[j] + delta * delta * TITANIA_BIAS_AVERAGE);
+	}
+}
+
+void titania_bias_update(dualsense_state* hid_state) {
+	const titania_bias_config* config = &hid_state->pipeline->bias;
+	if (!config->enabled) {
+		return;
+	}
+
+	titania_bias_state* bias = &hid_state->bias;
+	const dualsense_sensors* sensors = &hid_state->input.data.msg.data.sensors;
+	if (bias->samples > 0 && sensors->time == bias->sensor_time) { // the same sample read twice.
+		return;
+	}
+
+	bias->sensor_time = sensors->time;
+	const float gyro[3] = { sensors->gyro.x, sensors->gyro.y, sensors->gyro.z };
+	const float accelerometer[3] = { sensors->accelerometer.x, sensors->accelerometer.y, sensors->accelerometer.z };
+	bias->temperature = sensors->temperature;
+
+	if (bias->samples == 0) {
+		memcpy(bias->gyro_mean, gyro, sizeof(bias->gyro_mean));
+		memcpy(bias->accelerometer_mean, accelerometer, sizeof(bias->accelerometer_mean));
+	}
+
+	titania_bias_average(bias->gyro_mean, bias->gyro_variance, gyro);
+	titania_bias_average(bias->accelerometer_mean, bias->accelerometer_variance, accelerometer);
+	if (bias->samples < TITANIA_BIAS_WARMUP) {
+		bias->samples++;
+	}
+
+	bool still = bias->samples >= TITANIA_BIAS_WARMUP;
+	for (int j = 0; j < 3 && still; ++j) {
+		still = bias->gyro_variance[j] < TITANIA_BIAS_GYRO_VARIANCE && bias->accelerometer_variance[j] < TITANIA_BIAS_ACCELEROMETER_VARIANCE && fabsf(bias->gyro_mean[j] - (float) hid_state->calibration[j].bias) < TITANIA_BIAS_GYRO_OFFSET;
+	}
+
+	if (!still) {
+		bias->at_rest = false;
+		bias->rest_time = sensors->time;
+	} else if (!bias->at_rest && sensors->time - bias->rest_time >= TITANIA_BIAS_REST_TICKS) {
+		bias->at_rest = true;
+	}
+
+	if (bias->at_rest) {
+		titania_bias_bin* bin = &bias->bins[titania_bias_bin_index(bias, config->use_temperature)];
+		if (bin->samples < TITANIA_BIAS_MAX_SAMPLES) {
+			bin->samples++;
+		}
+
+		const float rate = 1.0f / (float) bin->samples;
+		for (int j = 0; j < 3; ++j) {
+			bin->bias[j] += (gyro[j] - bin->bias[j]) * rate;
+		}
+	}
+
+	const titania_bias_bin* bin = titania_bias_nearest_bin(bias, config->use_temperature);
+	bias->learned = bin != nullptr;
+	for (int j = 0; j < 3; ++j) {
+		const int32_t value = bin != nullptr ? (int32_t) lroundf(bin->bias[j]) : bias->calibration_bias[j];
+		hid_state->calibration[j].bias = value;
+		hid_state->calibration_fixed[j].bias = value;
+	}
+}
+
+void titania_bias_result(const dualsense_state* hid_state, titania_gyro_bias* bias) {
+	const titania_bias_config* config = &hid_state->pipeline->bias;
+	const titania_bias_bin* bin = config->enabled ? titania_bias_nearest_bin(&hid_state->bias, config->use_temperature) : nullptr;
+	if (bin != nullptr) {
+		bias->bias = (titania_vector3) { { bin->bias[0] }, { bin->bias[1] }, { bin->bias[2] } };
+	} else {
+		bias->bias = (titania_vector3) { { (float) hid_state->calibration[0].bias }, { (float) hid_state->calibration[1].bias }, { (float) hid_state->calibration[2].bias } };
+	}
+
+	bias->temperature = hid_state->bias.temperature;
+	bias->at_rest = hid_state->bias.at_rest;
+	bias->learned = bin != nullptr;
+}
+
+static titania_error titania_set_gyro_bias_tracking_impl(titania_context* ctx, const titania_handle handle, const bool enabled, const bool use_temperature) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	if (hid_state->hid_info.is_access) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	LOCK_INFO(hid_state);
+	titania_pipeline* pipeline = titania_pipeline_edit(hid_state);
+	if (pipeline == nullptr) {
+		UNLOCK_INFO(hid_state);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	// pull puts the calibration report bias back and starts learning over when it picks this up.
+	pipeline->bias.enabled = enabled;
+	pipeline->bias.use_temperature = use_temperature;
+	pipeline->bias.generation++;
+	titania_pipeline_publish(hid_state, pipeline);
+	UNLOCK_INFO(hid_state);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_set_gyro_bias_tracking(titania_context* ctx, const titania_handle handle, const bool enabled, const bool use_temperature) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_set_gyro_bias_tracking_impl(ctx, handle, enabled, use_temperature);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_get_gyro_bias_impl(titania_context* ctx, const titania_handle handle, titania_gyro_bias* bias) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	LOCK_INFO(hid_state);
+	const titania_results* results = titania_results_read(hid_state);
+	if (results->bias_generation == hid_state->pipeline_staging.bias.generation) {
+		*bias = results->gyro_bias;
+	} else {
+		// pull has not reached the current settings yet, they start over from the calibration report.
+		*bias = (titania_gyro_bias) { 0 };
+		bias->bias = (titania_vector3) { { (float) results->calibration_bias[0] }, { (float) results->calibration_bias[1] }, { (float) results->calibration_bias[2] } };
+	}
+	UNLOCK_INFO(hid_state);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_get_gyro_bias(titania_context* ctx, const titania_handle handle, titania_gyro_bias* bias) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (bias == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_get_gyro_bias_impl(ctx, handle, bias);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
@@ -0,0 +1,179 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <string.h>
+
+#include "structures.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint32_t titania_cache_checksum(const titania_cache_entry* entry) {
+	const uint8_t* buffer = (const uint8_t*) entry + offsetof(titania_cache_entry, has_calibration);
+	return titania_calc_checksum(crc_seed_titania, buffer, sizeof(titania_cache_entry) - offsetof(titania_cache_entry, has_calibration));
+}
+
+static void titania_cache_unmap(titania_cache* cache) {
+	if (cache->map == nullptr) {
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(cache->map);
+	CloseHandle(cache->mapping);
+	CloseHandle(cache->file);
+#else
+	munmap(cache->map, sizeof(titania_cache_file));
+	close(cache->file);
+#endif
+	cache->map = nullptr;
+}
+
+titania_error titania_cache_open(titania_cache* cache, const char* path) {
+	titania_cache_file* map = nullptr;
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, sizeof(titania_cache_file), nullptr);
+	if (mapping == nullptr) {
+		CloseHandle(file);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	map = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(titania_cache_file));
+	if (map == nullptr) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+#else
+	const int file = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (file < 0) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || (info.st_size != sizeof(titania_cache_file) && ftruncate(file, sizeof(titania_cache_file)) != 0)) {
+		close(file);
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	map = mmap(nullptr, sizeof(titania_cache_file), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	if (map == MAP_FAILED) {
+		close(file);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+#endif
+
+	// anything written by a different layout is thrown away rather than migrated, it is only a cache.
+	if (map->magic != TITANIA_CACHE_MAGIC || map->version != TITANIA_CACHE_VERSION || map->entry_size != sizeof(titania_cache_entry) || map->entry_count != TITANIA_CACHE_ENTRIES) {
+		memset(map, 0, sizeof(titania_cache_file));
+		map->magic = TITANIA_CACHE_MAGIC;
+		map->version = TITANIA_CACHE_VERSION;
+		map->entry_size = sizeof(titania_cache_entry);
+		map->entry_count = TITANIA_CACHE_ENTRIES;
+	}
+
+	titania_spin_lock(&cache->lock);
+	titania_cache_unmap(cache);
+	cache->map = map;
+	cache->file = file;
+#ifdef _WIN32
+	cache->mapping = mapping;
+#endif
+	titania_spin_unlock(&cache->lock);
+	return TITANIA_ERROR_OK;
+}
+
+void titania_cache_close(titania_cache* cache) {
+	titania_spin_lock(&cache->lock);
+	titania_cache_unmap(cache);
+	titania_spin_unlock(&cache->lock);
+}
+
+bool titania_cache_key(const wchar_t* serial, char key[TITANIA_CACHE_KEY_SIZE]) {
+	memset(key, 0, TITANIA_CACHE_KEY_SIZE);
+	if (serial == nullptr) {
+		return false;
+	}
+
+	// accept aa:bb:cc:dd:ee:ff, aa-bb-..., and aabbccddeeff, anything else is not a MAC.
+	int length = 0;
+	for (const wchar_t* c = serial; *c != 0; ++c) {
+		if (*c == L':' || *c == L'-') {
+			continue;
+		}
+
+		if (length >= 12) {
+			return false;
+		}
+
+		if (*c >= L'0' && *c <= L'9') {
+			key[length++] = (char) *c;
+		} else if (*c >= L'a' && *c <= L'f') {
+			key[length++] = (char) *c;
+		} else if (*c >= L'A' && *c <= L'F') {
+			key[length++] = (char) (*c - L'A' + L'a');
+		} else {
+			return false;
+		}
+	}
+
+	if (length != 12) {
+		key[0] = 0;
+		return false;
+	}
+
+	return true;
+}
+
+bool titania_cache_lookup(titania_cache* cache, const char key[TITANIA_CACHE_KEY_SIZE], titania_cache_entry* entry) {
+	bool found = false;
+	titania_spin_lock(&cache->lock);
+	if (cache->map != nullptr) {
+		for (int i = 0; i < TITANIA_CACHE_ENTRIES; ++i) {
+			if (memcmp(cache->map->entries[i].key, key, TITANIA_CACHE_KEY_SIZE) == 0) {
+				*entry = cache->map->entries[i];
+				found = entry->checksum == titania_cache_checksum(entry);
+				break;
+			}
+		}
+	}
+	titania_spin_unlock(&cache->lock);
+	return found;
+}
+
+void titania_cache_store(titania_cache* cache, const char key[TITANIA_CACHE_KEY_SIZE], titania_cache_entry* entry) {
+	titania_spin_lock(&cache->lock);
+	if (cache->map != nullptr) {
+		int slot = 0;
+		for (int i = 0; i < TITANIA_CACHE_ENTRIES; ++i) {
+			if (memcmp(cache->map->entries[i].key, key, TITANIA_CACHE_KEY_SIZE) == 0) {
+				slot = i;
+				break;
+			}
+
+			if (cache->map->entries[i].stamp < cache->map->entries[slot].stamp) {
+				slot = i;
+			}
+		}
+
+		memcpy(entry->key, key, TITANIA_CACHE_KEY_SIZE);
+		entry->stamp = ++cache->map->stamp;
+		entry->checksum = titania_cache_checksum(entry);
+		cache->map->entries[slot] = *entry;
+	}
+	titania_spin_unlock(&cache->lock);
+}
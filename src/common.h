@@ -23,6 +23,9 @@
 #define nullptr ((void*) 0)
 #endif
 
+// assumed destructive interference size, x86-64 and most arm64 cores use 64 bytes.
+#define TITANIA_CACHE_LINE (64)
+
 #define DUALSENSE_CRC_INPUT (0xA1)
 #define DUALSENSE_CRC_OUTPUT (0xA2)
 #define DUALSENSE_CRC_FEATURE (0xA3)
@@ -86,6 +89,12 @@
 #define DUALSENSE_GYRO_BASE (0.270)
 #define DUALSENSE_ACCELEROMETER_BASE (0.250)
 
+// titania_data gyro values are raw / DUALSENSE_GYRO_SENSITIVITY folded with the calibrated range and speed,
+// undoing the default range and speed gives back radians per second.
+#define DUALSENSE_GYRO_RADIANS (540.0f / (360.0f * DUALSENSE_GYRO_BASE) * (3.14159265358979f / 180.0f))
+
+#define DUALSENSE_SENSOR_TICKS_PER_SECOND (3000000.0f) // sensor time counts in thirds of a microsecond
+
 #define DUALSENSE_FIRMWARE_VERSION_DATE_LEN 0xB
 #define DUALSENSE_FIRMWARE_VERSION_TIME_LEN 0x8
 
@@ -97,9 +106,9 @@
 #define DENORM_CLAMP_UINT8(value) DENORM_CLAMP(value, UINT8_MAX)
 #define DENORM_CLAMP_INT8(value) (DENORM_CLAMP(value, INT8_MAX + 1) / 2.0f)
 
-// Check if the library is initialized
-#define CHECK_INIT() \
-	if (!is_initialized) \
+// Check if the context is initialized
+#define CHECK_INIT(ctx) \
+	if (ctx == nullptr || !ctx->is_initialized) \
 	return TITANIA_ERROR_NOT_INITIALIZED
 
 // Check if a handle is a valid number.
@@ -107,11 +116,48 @@
 	if (h == TITANIA_INVALID_ID || h < 0 || h >= TITANIA_MAX_CONTROLLERS) \
 	return TITANIA_ERROR_INVALID_HANDLE
 
-// Check if a handle is a valid number, and that it has been initialized.
-#define CHECK_HANDLE_VALID(h) \
-	CHECK_HANDLE(h); \
-	if (state[h].hid == nullptr) \
+#ifdef TITANIA_THREAD_SAFE
+// Take a reference on an open handle, titania_close waits for it to be released.
+#define ACQUIRE_HANDLE(ctx, h) \
+	if (!titania_slot_acquire(&ctx->state[h].lifecycle)) \
+	return TITANIA_ERROR_INVALID_HANDLE
+#define RELEASE_HANDLE(ctx, h) titania_slot_release(&ctx->state[h].lifecycle)
+#define RESERVE_HANDLE(ctx, h) titania_slot_reserve(&ctx->state[h].lifecycle)
+#define PUBLISH_HANDLE(ctx, h) titania_slot_publish(&ctx->state[h].lifecycle)
+#define RETIRE_HANDLE(ctx, h) titania_slot_retire(&ctx->state[h].lifecycle)
+#define FREE_HANDLE(ctx, h) titania_slot_free(&ctx->state[h].lifecycle)
+
+// Replace the device behind a handle the caller holds a reference to, other threads wait in ACQUIRE_HANDLE meanwhile.
+#define BEGIN_SWAP_HANDLE(ctx, h) titania_slot_begin_swap(&ctx->state[h].lifecycle)
+#define END_SWAP_HANDLE(ctx, h) titania_slot_end_swap(&ctx->state[h].lifecycle)
+
+// Guard the pending output report against concurrent updates.
+#define LOCK_OUTPUT(s) titania_spin_lock(&(s)->output_lock)
+#define UNLOCK_OUTPUT(s) titania_spin_unlock(&(s)->output_lock)
+
+// Guard the lazily fetched firmware and serial info against concurrent fetches and pulls.
+#define LOCK_INFO(s) titania_spin_lock(&(s)->info_lock)
+#define UNLOCK_INFO(s) titania_spin_unlock(&(s)->info_lock)
+#else
+// Check that a handle has been initialized.
+#define ACQUIRE_HANDLE(ctx, h) \
+	if (ctx->state[h].hid == nullptr) \
 	return TITANIA_ERROR_INVALID_HANDLE
+#define RELEASE_HANDLE(ctx, h) ((void) 0)
+#define RESERVE_HANDLE(ctx, h) (ctx->state[h].hid == nullptr)
+#define PUBLISH_HANDLE(ctx, h) ((void) 0)
+#define RETIRE_HANDLE(ctx, h) (ctx->state[h].hid != nullptr)
+#define FREE_HANDLE(ctx, h) ((void) 0)
+
+#define BEGIN_SWAP_HANDLE(ctx, h) ((void) 0)
+#define END_SWAP_HANDLE(ctx, h) ((void) 0)
+
+#define LOCK_OUTPUT(s) ((void) 0)
+#define UNLOCK_OUTPUT(s) ((void) 0)
+
+#define LOCK_INFO(s) ((void) 0)
+#define UNLOCK_INFO(s) ((void) 0)
+#endif
 
 #define HID_FAIL(s) (s == -1)
 #define HID_PASS(s) (s != -1)
@@ -119,12 +165,12 @@
 #define IS_EDGE(h) (h.vendor_id == 0x054C && h.product_id == 0x0DF2)
 #define IS_ACCESS(h) (h.vendor_id == 0x054C && h.product_id == 0x0E5F)
 
-#define CHECK_EDGE(h) \
-	if (!IS_EDGE(state[h].hid_info)) \
+#define CHECK_EDGE(ctx, h) \
+	if (!IS_EDGE(ctx->state[h].hid_info)) \
 	return TITANIA_ERROR_NOT_EDGE
 
-#define CHECK_ACCESS(h) \
-	if (!IS_ACCESS(state[h].hid_info)) \
+#define CHECK_ACCESS(ctx, h) \
+	if (!IS_ACCESS(ctx->state[h].hid_info)) \
 	return TITANIA_ERROR_NOT_ACCESS
 
 typedef struct PACKED dualsense_vector3 {
@@ -0,0 +1,257 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "structures.h"
+
+#ifdef __APPLE__
+#include <hidapi_darwin.h>
+#endif
+
+titania_context titania_default_context;
+
+// hid_init/hid_exit are process-wide, so only the first context to open and the last context to close touch them.
+static int32_t hidapi_references = 0;
+
+bool titania_is_hidapi_initialized(void) { return hidapi_references > 0; }
+
+titania_error titania_acquire_hidapi(void) {
+	if (hidapi_references == 0) {
+		if (hid_init() != 0) {
+			return TITANIA_ERROR_HIDAPI_FAIL;
+		}
+
+#ifdef __APPLE__
+		hid_darwin_set_open_exclusive(0);
+#endif
+	}
+
+	hidapi_references += 1;
+	return TITANIA_ERROR_OK;
+}
+
+void titania_release_hidapi(void) {
+	if (hidapi_references == 0) {
+		return;
+	}
+
+	hidapi_references -= 1;
+	if (hidapi_references == 0) {
+		hid_exit();
+	}
+}
+
+void titania_close_context(titania_context* ctx) {
+	for (int i = 0; i < TITANIA_MAX_CONTROLLERS; i++) {
+		titania_ctx_close(ctx, i);
+	}
+
+	titania_cache_close(&ctx->cache);
+	ctx->is_initialized = false;
+}
+
+titania_error titania_init_checked(const size_t size) {
+	if (size != sizeof(titania_hid)) {
+		return TITANIA_ERROR_INVALID_LIBRARY;
+	}
+
+	if (titania_default_context.is_initialized) {
+		return TITANIA_ERROR_OK;
+	}
+
+	const titania_error result = titania_acquire_hidapi();
+	if (IS_TITANIA_BAD(result)) {
+		return result;
+	}
+
+	memset(&titania_default_context, 0, sizeof(titania_context));
+	titania_default_context.is_initialized = true;
+	return TITANIA_ERROR_OK;
+}
+
+void titania_exit(void) {
+	if (!titania_default_context.is_initialized) {
+		return;
+	}
+
+	titania_close_context(&titania_default_context);
+	titania_release_hidapi();
+}
+
+titania_error titania_context_create_checked(const size_t size, titania_context** context) {
+	if (size != sizeof(titania_hid)) {
+		return TITANIA_ERROR_INVALID_LIBRARY;
+	}
+
+	if (context == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	*context = nullptr;
+
+	// the state table is cache line aligned, malloc only guarantees max_align_t.
+#ifdef _WIN32
+	titania_context* ctx = _aligned_malloc(sizeof(titania_context), alignof(titania_context));
+#else
+	titania_context* ctx = aligned_alloc(alignof(titania_context), sizeof(titania_context));
+#endif
+	if (ctx == nullptr) {
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	const titania_error result = titania_acquire_hidapi();
+	if (IS_TITANIA_BAD(result)) {
+#ifdef _WIN32
+		_aligned_free(ctx);
+#else
+		free(ctx);
+#endif
+		return result;
+	}
+
+	memset(ctx, 0, sizeof(titania_context));
+	ctx->is_initialized = true;
+	*context = ctx;
+	return TITANIA_ERROR_OK;
+}
+
+void titania_context_destroy(titania_context* context) {
+	if (context == nullptr || context == &titania_default_context) {
+		return;
+	}
+
+	if (context->is_initialized) {
+		titania_close_context(context);
+		titania_release_hidapi();
+	}
+
+#ifdef _WIN32
+	_aligned_free(context);
+#else
+	free(context);
+#endif
+}
+
+titania_error titania_ctx_set_cache(titania_context* ctx, const char* path) {
+	CHECK_INIT(ctx);
+
+	if (path == nullptr) {
+		titania_cache_close(&ctx->cache);
+		return TITANIA_ERROR_OK;
+	}
+
+	return titania_cache_open(&ctx->cache, path);
+}
+
+// default context wrappers
+
+titania_error titania_set_cache(const char* path) { return titania_ctx_set_cache(&titania_default_context, path); }
+
+titania_error titania_open(const titania_hid_path path, const bool is_bluetooth, titania_hid* handle, const bool use_calibration, const bool blocking) { return titania_ctx_open(&titania_default_context, path, is_bluetooth, handle, use_calibration, blocking); }
+
+titania_error titania_open_many(const titania_query* queries, const size_t count, titania_hid* handles, titania_error* results, const bool use_calibration, const bool blocking) { return titania_ctx_open_many(&titania_default_context, queries, count, handles, results, use_calibration, blocking); }
+
+titania_error titania_get_firmware(const titania_handle handle, titania_firmware_info* firmware) { return titania_ctx_get_firmware(&titania_default_context, handle, firmware); }
+
+titania_error titania_get_serial(const titania_handle handle, titania_serial_info* serial) { return titania_ctx_get_serial(&titania_default_context, handle, serial); }
+
+titania_error titania_set_reconnect(const titania_handle handle, const bool enabled) { return titania_ctx_set_reconnect(&titania_default_context, handle, enabled); }
+
+titania_error titania_is_connected(const titania_handle handle, bool* connected) { return titania_ctx_is_connected(&titania_default_context, handle, connected); }
+
+titania_error titania_pull(titania_handle* handle, const size_t handle_count, titania_data* data) { return titania_ctx_pull(&titania_default_context, handle, handle_count, data); }
+
+titania_error titania_pull_changes(titania_handle* handle, const size_t handle_count, titania_data* data, uint32_t* changes) { return titania_ctx_pull_changes(&titania_default_context, handle, handle_count, data, changes); }
+
+titania_error titania_pull_fixed(titania_handle* handle, const size_t handle_count, titania_data_fixed* data) { return titania_ctx_pull_fixed(&titania_default_context, handle, handle_count, data); }
+
+titania_error titania_push(titania_handle* handle, const size_t handle_count) { return titania_ctx_push(&titania_default_context, handle, handle_count); }
+
+titania_error titania_set_output_backpressure(const titania_handle handle, const bool enabled) { return titania_ctx_set_output_backpressure(&titania_default_context, handle, enabled); }
+
+titania_error titania_get_output_ack(const titania_handle handle, titania_output_ack* ack) { return titania_ctx_get_output_ack(&titania_default_context, handle, ack); }
+
+titania_error titania_set_history(const titania_handle handle, const size_t count) { return titania_ctx_set_history(&titania_default_context, handle, count); }
+
+titania_error titania_get_history(const titania_handle handle, titania_raw_report* reports, const size_t count, size_t* written) { return titania_ctx_get_history(&titania_default_context, handle, reports, count, written); }
+
+titania_error titania_get_events(const titania_handle handle, titania_button_event* events, const size_t count, size_t* written) { return titania_ctx_get_events(&titania_default_context, handle, events, count, written); }
+
+titania_error titania_set_gestures(const titania_handle handle, const bool enabled) { return titania_ctx_set_gestures(&titania_default_context, handle, enabled); }
+
+titania_error titania_get_gestures(const titania_handle handle, titania_gesture_event* events, const size_t count, size_t* written) { return titania_ctx_get_gestures(&titania_default_context, handle, events, count, written); }
+
+titania_error titania_set_stick_curve(const titania_handle handle, const int32_t stick, const titania_edge_stick* curve) { return titania_ctx_set_stick_curve(&titania_default_context, handle, stick, curve); }
+
+titania_error titania_set_button_remap(const titania_handle handle, const titania_edge_button_remap* buttons, const titania_buttons* disabled) { return titania_ctx_set_button_remap(&titania_default_context, handle, buttons, disabled); }
+
+titania_error titania_set_access_button_remap(const titania_handle handle, const titania_access_profile_buttons* buttons) { return titania_ctx_set_access_button_remap(&titania_default_context, handle, buttons); }
+
+titania_error titania_set_filter(const titania_handle handle, const titania_filter_channel channel, const titania_filter filter) { return titania_ctx_set_filter(&titania_default_context, handle, channel, filter); }
+
+titania_error titania_set_gyro_bias_tracking(const titania_handle handle, const bool enabled, const bool use_temperature) { return titania_ctx_set_gyro_bias_tracking(&titania_default_context, handle, enabled, use_temperature); }
+
+titania_error titania_get_gyro_bias(const titania_handle handle, titania_gyro_bias* bias) { return titania_ctx_get_gyro_bias(&titania_default_context, handle, bias); }
+
+titania_error titania_set_fusion(const titania_handle handle, const bool enabled, const float gain) { return titania_ctx_set_fusion(&titania_default_context, handle, enabled, gain); }
+
+titania_error titania_get_orientation(const titania_handle handle, titania_orientation* orientation) { return titania_ctx_get_orientation(&titania_default_context, handle, orientation); }
+
+titania_error titania_set_gyro_pointer(const titania_handle handle, const titania_gyro_pointer* pointer) { return titania_ctx_set_gyro_pointer(&titania_default_context, handle, pointer); }
+
+titania_error titania_get_gyro_pointer(const titania_handle handle, titania_pointer_delta* delta) { return titania_ctx_get_gyro_pointer(&titania_default_context, handle, delta); }
+
+titania_error titania_set_prediction(const titania_handle handle, const titania_prediction_model model) { return titania_ctx_set_prediction(&titania_default_context, handle, model); }
+
+titania_error titania_predict(const titania_handle handle, const uint64_t target_host_time, titania_data* data, titania_orientation* orientation) { return titania_ctx_predict(&titania_default_context, handle, target_host_time, data, orientation); }
+
+titania_error titania_get_calibration(const titania_handle handle, titania_calibration calibration[TITANIA_CALIBRATION_COUNT]) { return titania_ctx_get_calibration(&titania_default_context, handle, calibration); }
+
+titania_error titania_convert_batch(const titania_raw_report* reports, const size_t count, const titania_batch* batch) { return titania_ctx_convert_batch(&titania_default_context, reports, count, batch); }
+
+titania_error titania_update_led(const titania_handle handle, const titania_led_update data) { return titania_ctx_update_led(&titania_default_context, handle, data); }
+
+titania_error titania_update_audio(const titania_handle handle, const titania_audio_update data) { return titania_ctx_update_audio(&titania_default_context, handle, data); }
+
+titania_error titania_update_control(const titania_handle handle, const titania_control_update data) { return titania_ctx_update_control(&titania_default_context, handle, data); }
+
+titania_error titania_get_control(const titania_handle handle, titania_control_update* control) { return titania_ctx_get_control(&titania_default_context, handle, control); }
+
+titania_error titania_update_effect(const titania_handle handle, const titania_effect_update left_trigger, const titania_effect_update right_trigger, const float power_reduction) { return titania_ctx_update_effect(&titania_default_context, handle, left_trigger, right_trigger, power_reduction); }
+
+titania_error titania_update_rumble(const titania_handle handle, const float large_motor, const float small_motor, const float power_reduction, const bool emulate_legacy_behavior) { return titania_ctx_update_rumble(&titania_default_context, handle, large_motor, small_motor, power_reduction, emulate_legacy_behavior); }
+
+titania_error titania_bt_pair(const titania_handle handle, const titania_mac mac, const titania_link_key link_key) { return titania_ctx_bt_pair(&titania_default_context, handle, mac, link_key); }
+
+titania_error titania_bt_connect(const titania_handle handle) { return titania_ctx_bt_connect(&titania_default_context, handle); }
+
+titania_error titania_bt_disconnect(const titania_handle handle) { return titania_ctx_bt_disconnect(&titania_default_context, handle); }
+
+titania_error titania_update_edge_profile(const titania_handle handle, const titania_profile_id id, const titania_edge_profile profile) { return titania_ctx_update_edge_profile(&titania_default_context, handle, id, profile); }
+
+titania_error titania_update_access_profile(const titania_handle handle, const titania_profile_id id, const titania_access_profile profile) { return titania_ctx_update_access_profile(&titania_default_context, handle, id, profile); }
+
+titania_error titania_query_edge_profile(const titania_handle handle, const titania_profile_id profile_id, titania_edge_profile* profile) { return titania_ctx_query_edge_profile(&titania_default_context, handle, profile_id, profile); }
+
+titania_error titania_query_edge_profiles_all(const titania_handle handle, titania_edge_profile profiles[TITANIA_EDGE_PROFILE_COUNT]) { return titania_ctx_query_edge_profiles_all(&titania_default_context, handle, profiles); }
+
+titania_error titania_query_access_profile(const titania_handle handle, const titania_profile_id profile_id, titania_access_profile* profile) { return titania_ctx_query_access_profile(&titania_default_context, handle, profile_id, profile); }
+
+titania_error titania_delete_edge_profile(const titania_handle handle, const titania_profile_id id) { return titania_ctx_delete_edge_profile(&titania_default_context, handle, id); }
+
+titania_error titania_delete_access_profile(const titania_handle handle, const titania_profile_id id) { return titania_ctx_delete_access_profile(&titania_default_context, handle, id); }
+
+void titania_close(const titania_handle handle) { titania_ctx_close(&titania_default_context, handle); }
+
+titania_error titania_debug_get_hid(const titania_handle handle, intptr_t* hid) { return titania_ctx_debug_get_hid(&titania_default_context, handle, hid); }
+
+titania_error titania_debug_get_hid_report_ids(const titania_handle handle, titania_report_id report_ids[0xFF]) { return titania_ctx_debug_get_hid_report_ids(&titania_default_context, handle, report_ids); }
+
+titania_error titania_debug_get_edge_profile(const titania_handle handle, const titania_profile_id profile_id, uint8_t profile_data[TITANIA_MERGED_REPORT_EDGE_SIZE]) { return titania_ctx_debug_get_edge_profile(&titania_default_context, handle, profile_id, profile_data); }
+
+titania_error titania_debug_get_access_profile(const titania_handle handle, const titania_profile_id profile_id, uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE]) { return titania_ctx_debug_get_access_profile(&titania_default_context, handle, profile_id, profile_data); }
+
+titania_error titania_debug_convert_input(const titania_handle handle, titania_data* data) { return titania_ctx_debug_convert_input(&titania_default_context, handle, data); }
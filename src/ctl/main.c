@@ -28,6 +28,9 @@ const titaniactl_mode modes[] = { { "report", titaniactl_mode_report, titaniactl
 	{ "dump", titaniactl_mode_dump, nullptr, "dump every feature report from connected controllers", nullptr },
 	{ "benchmark", titaniactl_mode_bench, nullptr, "benchmark report parsing speed", nullptr },
 	{ "bench", titaniactl_mode_bench, nullptr, nullptr, nullptr },
+	{ "bench convert", nullptr, nullptr, "benchmark input report conversion without device reads", nullptr },
+	{ "stress", titaniactl_mode_stress, nullptr, "hammer a controller from several threads (requires titania_thread_safe)", "[seconds]" },
+	{ "serve", titaniactl_mode_serve, nullptr, "publish controller state to shared memory for other processes, and apply their output updates", "[name]" },
 	{ "led", titaniactl_mode_led, titaniactl_mode_led, "update LED color", "#rrggbb|off player-led" },
 	{ "light", titaniactl_mode_led, titaniactl_mode_led, nullptr, nullptr },
 	{ "pair", titaniactl_mode_bt_pair, titaniactl_mode_bt_pair, "pair with a bluetooth adapter", "address link-key" },
@@ -121,6 +124,7 @@ int main(const int argc, const char** const argv) {
 	bool disable_bt = false;
 	bool disable_usb = false;
 	bool blocking = true;
+	const char* cache_path = nullptr;
 
 	int filtered_controllers = 0;
 	titania_serial filter[TITANIACTL_CONTROLLER_COUNT] = { 0 };
@@ -154,6 +158,7 @@ int main(const int argc, const char** const argv) {
 				printf("\t-b, --no-bt: disable bluetooth controllers from being considered\n");
 				printf("\t-u, --no-usb: disable usb controllers from being considered\n");
 				printf("\t-z, --non-blocking: disable blocking reads\n");
+				printf("\t-k, --cache: cache calibration and device info in this file\n");
 				printf("\t-p, --preserve: preserve ids and timestamps when importing\n");
 				printf("\n");
 				printf("available modes:\n");
@@ -246,6 +251,8 @@ int main(const int argc, const char** const argv) {
 				calibrate = false;
 			} else if (strcmp(text, "-z") == 0 || strcmp(text, "--non-blocking") == 0) {
 				blocking = false;
+			} else if ((strcmp(text, "-k") == 0 || strcmp(text, "--cache") == 0) && i + 1 < argc) {
+				cache_path = argv[++i];
 			} else if (text[0] != '-') {
 				mode = text;
 				if (argc - i > 1) {
@@ -297,6 +304,14 @@ int main(const int argc, const char** const argv) {
 		titania_errorf(result, "error initializing " TITANIA_PROJECT_NAME);
 		return result;
 	}
+
+	if (cache_path != nullptr) {
+		result = titania_set_cache(cache_path);
+		if (IS_TITANIA_BAD(result)) {
+			titania_errorf(result, "error opening cache");
+		}
+	}
+
 	titania_query query[TITANIACTL_CONTROLLER_COUNT];
 	result = titania_get_hids(query, TITANIACTL_CONTROLLER_COUNT);
 	if (IS_TITANIA_BAD(result)) {
@@ -305,6 +320,8 @@ int main(const int argc, const char** const argv) {
 		return result;
 	}
 
+	titania_query open_query[TITANIACTL_CONTROLLER_COUNT];
+	int open_count = 0;
 	for (int hid_id = 0; hid_id < TITANIACTL_CONTROLLER_COUNT; ++hid_id) {
 		if (should_stop) {
 			return 0;
@@ -345,16 +362,25 @@ int main(const int argc, const char** const argv) {
 		}
 
 	pass:
-		if (should_stop) {
-			return 0;
-		}
+		open_query[open_count++] = query[hid_id];
+	}
 
-		result = titania_open(query[hid_id].hid_path, query[hid_id].is_bluetooth, &context.hids[context.connected_controllers], calibrate, blocking);
-		if (IS_TITANIA_BAD(result)) {
-			titania_errorf(result, "error initializing hid");
+	if (should_stop) {
+		return 0;
+	}
+
+	// open everything at once, firmware and serial info is fetched by the modes that print it.
+	titania_hid hids[TITANIACTL_CONTROLLER_COUNT];
+	titania_error open_results[TITANIACTL_CONTROLLER_COUNT];
+	titania_open_many(open_query, open_count, hids, open_results, calibrate, blocking);
+	for (int hid_id = 0; hid_id < open_count; ++hid_id) {
+		if (IS_TITANIA_BAD(open_results[hid_id])) {
+			titania_errorf(open_results[hid_id], "error initializing hid");
 			continue;
 		}
-		context.handles[context.connected_controllers] = context.hids[context.connected_controllers].handle;
+
+		context.hids[context.connected_controllers] = hids[hid_id];
+		context.handles[context.connected_controllers] = hids[hid_id].handle;
 		context.connected_controllers++;
 	}
 
@@ -24,9 +24,48 @@ void nanosleep(const struct timespec* tspec, void* nullvoid) {
 #include "../titaniactl.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 
+#define BENCH_CONVERT_ITERATIONS (1000000)
+
+titaniactl_error titaniactl_mode_bench_convert(titaniactl_context* context) {
+	printf("testing conversion speed, press CTRL+C to stop\n");
+	struct timespec ts1, ts2;
+	titania_data data;
+	titania_handle handle = context->handles[0];
+
+	// read one real report so there is something to convert.
+	titania_error result = titania_pull(&handle, 1, &data);
+	if (IS_TITANIA_BAD(result)) {
+		return MAKE_TITANIA_ERROR(result);
+	}
+
+	while (true) {
+		if (should_stop) {
+			return TITANIACTL_ERROR_INTERRUPTED;
+		}
+
+		timespec_get(&ts1, TIME_UTC);
+		for (int32_t i = 0; i < BENCH_CONVERT_ITERATIONS; ++i) {
+			result = titania_debug_convert_input(handle, &data);
+		}
+		timespec_get(&ts2, TIME_UTC);
+
+		if (IS_TITANIA_BAD(result)) {
+			return MAKE_TITANIA_ERROR(result);
+		}
+
+		const double delta = (ts2.tv_sec - ts1.tv_sec) * 1e+9 + (ts2.tv_nsec - ts1.tv_nsec);
+		printf("%d reports, avg: %.2f ns\n", BENCH_CONVERT_ITERATIONS, delta / BENCH_CONVERT_ITERATIONS);
+	}
+}
+
 titaniactl_error titaniactl_mode_bench(titaniactl_context* context) {
+	if (context->argc > 0 && strcmp(context->argv[0], "convert") == 0) {
+		return titaniactl_mode_bench_convert(context);
+	}
+
 	printf("testing latency, press CTRL+C to stop\n");
 	uint64_t max = 0;
 	uint64_t min = UINT64_MAX;
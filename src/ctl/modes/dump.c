@@ -15,6 +15,11 @@ titaniactl_error titaniactl_mode_dump(titaniactl_context* context) {
 			return TITANIACTL_ERROR_INTERRUPTED;
 		}
 
+		// controllers are opened lazily, the serial is only fetched when it names a file.
+		if (context->hids[i].serial.mac[0] == 0) {
+			titania_get_serial(context->hids[i].handle, &context->hids[i].serial);
+		}
+
 		char name[0x30] = { 0 };
 		sprintf(name, "report_%s_%%d.bin", context->hids[i].serial.mac);
 		titania_report_id report_ids[0xFF];
@@ -390,6 +390,10 @@ titaniactl_error titaniactl_mode_edge_delete(titania_profile_id profile, titania
 		return TITANIACTL_ERROR_HID_FAILURE;
 	}
 
+	if (handle.serial.mac[0] == 0) {
+		titania_get_serial(handle.handle, &handle.serial);
+	}
+
 	printf("deleted %s profile%s from %s\n", titania_profile_id_msg[profile], profile == TITANIA_PROFILE_ALL ? "s" : "", handle.serial.mac);
 
 	return TITANIACTL_ERROR_OK;
@@ -113,6 +113,11 @@ titaniactl_error titaniactl_mode_profile_dump_inner(titaniactl_context* context,
 			return TITANIACTL_ERROR_HID_FAILURE;
 		}
 
+		// controllers are opened lazily, the serial is only fetched when it names a file.
+		if (context->hids[i].serial.mac[0] == 0) {
+			titania_get_serial(context->hids[i].handle, &context->hids[i].serial);
+		}
+
 		char report_name[1024];
 		if (simple) {
 			sprintf(report_name, "%s.bin", strbuffer);
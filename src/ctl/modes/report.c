@@ -8,6 +8,20 @@
 
 #include <json.h>
 
+// controllers are opened lazily, so firmware and serial info is only fetched here when it is printed.
+static titania_hid titaniactl_get_hid_info(titaniactl_context* context, const int index) {
+	titania_hid* hid = &context->hids[index];
+	if (hid->firmware.datetime[0] == 0) {
+		titania_get_firmware(hid->handle, &hid->firmware);
+	}
+
+	if (hid->serial.mac[0] == 0) {
+		titania_get_serial(hid->handle, &hid->serial);
+	}
+
+	return *hid;
+}
+
 titaniactl_error titaniactl_mode_report_inner(titaniactl_context* context, const bool loop) {
 	do {
 		titania_data datum[TITANIACTL_CONTROLLER_COUNT];
@@ -19,13 +33,13 @@ titaniactl_error titaniactl_mode_report_inner(titaniactl_context* context, const
 
 		for (int i = 0; i < context->connected_controllers; ++i) {
 			const titania_data data = datum[i];
-			const titania_hid hid = context->hids[i];
+			const titania_hid hid = titaniactl_get_hid_info(context, i);
 			// clang-format off
 			printf("hid {");
 			TITANIAPRINT_X16(data.hid, product_id); TITANIAPRINT_SEP();
 			TITANIAPRINT_X16(data.hid, vendor_id); TITANIAPRINT_SEP();
-			TITANIAPRINT_STR(data.hid.serial, mac); TITANIAPRINT_SEP();
-			TITANIAPRINT_STR(data.hid.serial, paired_mac); TITANIAPRINT_SEP();
+			TITANIAPRINT_STR(hid.serial, mac); TITANIAPRINT_SEP();
+			TITANIAPRINT_STR(hid.serial, paired_mac); TITANIAPRINT_SEP();
 			TITANIAPRINT_TEST(data.hid, is_bluetooth); TITANIAPRINT_SEP();
 			TITANIAPRINT_TEST(data.hid, is_edge); TITANIAPRINT_SEP();
 			TITANIAPRINT_TEST(data.hid, is_access);
@@ -283,7 +297,7 @@ titaniactl_error titaniactl_mode_report_json_inner(titaniactl_context* context,
 		struct json* arr = json_object_add_array(root_obj, "devices");
 		for (int i = 0; i < context->connected_controllers; ++i) {
 			const titania_data data = datum[i];
-			const titania_hid hid = context->hids[i];
+			const titania_hid hid = titaniactl_get_hid_info(context, i);
 			char strbuffer[512];
 
 			struct json* obj = json_array_add_object(arr);
@@ -594,7 +608,7 @@ titaniactl_error titaniactl_mode_report_loop_json(titaniactl_context* context) {
 
 titaniactl_error titaniactl_mode_list(titaniactl_context* context) {
 	for (int i = 0; i < context->connected_controllers; ++i) {
-		titania_hid hid = context->hids[i];
+		titania_hid hid = titaniactl_get_hid_info(context, i);
 		if (hid.is_edge) {
 			printf("DualSense Edge Controller (");
 		} else if (hid.is_access) {
@@ -628,7 +642,7 @@ titaniactl_error titaniactl_mode_list_json(titaniactl_context* context) {
 	json_object_add_bool(root_obj, "success", true);
 	struct json* arr = json_object_add_array(root_obj, "devices");
 	for (int i = 0; i < context->connected_controllers; ++i) {
-		const titania_hid hid = context->hids[i];
+		const titania_hid hid = titaniactl_get_hid_info(context, i);
 		struct json* obj = json_array_add_object(arr);
 		json_object_add_bool(obj, "isEdge", hid.is_edge);
 		json_object_add_bool(obj, "isAccess", hid.is_access);
@@ -0,0 +1,103 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include "../titaniactl.h"
+
+#include <stdio.h>
+
+// commands come from other processes, anything that does not name one of our controllers is dropped.
+static bool titaniactl_serve_apply(const titaniactl_context* context, const titania_shared_command* command) {
+	bool is_ours = false;
+	for (int i = 0; i < context->connected_controllers; ++i) {
+		if (context->handles[i] == command->handle) {
+			is_ours = true;
+			break;
+		}
+	}
+
+	if (!is_ours) {
+		return false;
+	}
+
+	titania_error result;
+	switch (command->type) {
+		case TITANIA_SHARED_COMMAND_LED: result = titania_update_led(command->handle, command->led); break;
+		case TITANIA_SHARED_COMMAND_AUDIO: result = titania_update_audio(command->handle, command->audio); break;
+		case TITANIA_SHARED_COMMAND_CONTROL: result = titania_update_control(command->handle, command->control); break;
+		case TITANIA_SHARED_COMMAND_EFFECT: result = titania_update_effect(command->handle, command->effect.left_trigger, command->effect.right_trigger, command->effect.power_reduction); break;
+		case TITANIA_SHARED_COMMAND_RUMBLE: result = titania_update_rumble(command->handle, command->rumble.large_motor, command->rumble.small_motor, command->rumble.power_reduction, command->rumble.emulate_legacy_behavior); break;
+		default: return false;
+	}
+
+	return IS_TITANIA_OKAY(result);
+}
+
+titaniactl_error titaniactl_mode_serve(titaniactl_context* context) {
+	const char* name = context->argc > 0 ? context->argv[0] : TITANIA_SHARED_DEFAULT_NAME;
+	titania_shared* shared;
+	titania_error result = titania_shared_create(name, &shared);
+	if (IS_TITANIA_BAD(result)) {
+		titania_errorf(result, "error creating shared memory");
+		return MAKE_TITANIA_ERROR(result);
+	}
+
+	// the handles stay valid while a controller is away, and output waits for the controller instead of queueing up.
+	for (int i = 0; i < context->connected_controllers; ++i) {
+		titania_set_reconnect(context->handles[i], true);
+		if (!context->hids[i].is_access) {
+			titania_set_output_backpressure(context->handles[i], true);
+		}
+	}
+
+	printf("publishing %d controller(s) as %s\n", context->connected_controllers, name);
+
+	titania_data datum[TITANIACTL_CONTROLLER_COUNT];
+	titania_shared_command commands[TITANIA_SHARED_COMMANDS];
+	titaniactl_error error = TITANIACTL_ERROR_OK;
+	while (!should_stop) {
+		result = titania_pull(context->handles, context->connected_controllers, datum);
+		if (IS_TITANIA_BAD(result)) {
+			if (!should_stop) {
+				titania_errorf(result, "error getting report");
+				error = TITANIACTL_ERROR_HID_FAILURE;
+			}
+			break;
+		}
+
+		for (int i = 0; i < context->connected_controllers; ++i) {
+			titania_shared_publish(shared, &datum[i]);
+		}
+
+		size_t count = 0;
+		titania_shared_get_commands(shared, commands, TITANIA_SHARED_COMMANDS, &count);
+		if (count == 0) {
+			continue;
+		}
+
+		// every update of a pull goes out in one push per controller.
+		titania_handle pending[TITANIACTL_CONTROLLER_COUNT];
+		int pending_count = 0;
+		for (size_t j = 0; j < count; ++j) {
+			if (!titaniactl_serve_apply(context, &commands[j])) {
+				continue;
+			}
+
+			bool is_pending = false;
+			for (int k = 0; k < pending_count; ++k) {
+				is_pending |= pending[k] == commands[j].handle;
+			}
+
+			if (!is_pending) {
+				pending[pending_count++] = commands[j].handle;
+			}
+		}
+
+		if (pending_count > 0) {
+			titania_push(pending, pending_count);
+		}
+	}
+
+	titania_shared_destroy(shared);
+	return should_stop ? TITANIACTL_ERROR_INTERRUPTED : error;
+}
@@ -0,0 +1,149 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include "../titaniactl.h"
+
+#include <titania_config.h>
+
+#include <stdio.h>
+
+#ifdef TITANIA_THREAD_SAFE
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <threads.h>
+#include <time.h>
+
+#define STRESS_UPDATERS (2)
+
+typedef struct titaniactl_stress_state {
+	titania_handle handle;
+	atomic_bool stop;
+	atomic_uint_fast64_t pulls;
+	atomic_uint_fast64_t updates;
+	atomic_uint_fast64_t pushes;
+} titaniactl_stress_state;
+
+static int titaniactl_stress_pull(void* userdata) {
+	titaniactl_stress_state* stress = userdata;
+	titania_handle handle = stress->handle;
+	titania_data data;
+	while (!atomic_load(&stress->stop)) {
+		if (IS_TITANIA_BAD(titania_pull(&handle, 1, &data)) || handle == TITANIA_INVALID_ID) {
+			break;
+		}
+
+		atomic_fetch_add(&stress->pulls, 1);
+	}
+
+	return 0;
+}
+
+static int titaniactl_stress_update(void* userdata) {
+	titaniactl_stress_state* stress = userdata;
+	const titania_effect_update effect = { .mode = TITANIA_EFFECT_OFF };
+	uint64_t i = 0;
+	while (!atomic_load(&stress->stop)) {
+		titania_led_update led = { 0 };
+		led.color.x = (i & 0xFF) / 255.0f;
+		led.color.y = ((i >> 8) & 0xFF) / 255.0f;
+		led.color.z = 0.5f;
+		led.led = TITANIA_LED_NO_UPDATE;
+
+		titania_error result = titania_update_led(stress->handle, led);
+		if (IS_TITANIA_OKAY(result)) {
+			result = titania_update_rumble(stress->handle, (i & 0x7) / 7.0f, 0.0f, -1.0f, false);
+		}
+
+		if (IS_TITANIA_OKAY(result) || result == TITANIA_ERROR_NOT_SUPPORTED) {
+			result = titania_update_effect(stress->handle, effect, effect, -1.0f);
+		}
+
+		if (result == TITANIA_ERROR_INVALID_HANDLE) {
+			break;
+		}
+
+		atomic_fetch_add(&stress->updates, 1);
+		i++;
+	}
+
+	return 0;
+}
+
+static int titaniactl_stress_push(void* userdata) {
+	titaniactl_stress_state* stress = userdata;
+	titania_handle handle = stress->handle;
+	const struct timespec sleep_time = { 0, 1e+6 };
+	while (!atomic_load(&stress->stop)) {
+		if (IS_TITANIA_BAD(titania_push(&handle, 1)) || handle == TITANIA_INVALID_ID) {
+			break;
+		}
+
+		atomic_fetch_add(&stress->pushes, 1);
+		thrd_sleep(&sleep_time, nullptr);
+	}
+
+	return 0;
+}
+#endif
+
+titaniactl_error titaniactl_mode_stress(titaniactl_context* context) {
+#ifndef TITANIA_THREAD_SAFE
+	titaniactl_errorf("titania was built without titania_thread_safe", "stress test is unavailable");
+	return TITANIACTL_ERROR_NOT_IMPLEMENTED;
+#else
+	if (context->connected_controllers == 0) {
+		return TITANIACTL_ERROR_OK;
+	}
+
+	int seconds = 5;
+	if (context->argc > 0) {
+		seconds = atoi(context->argv[0]);
+		if (seconds <= 0) {
+			return TITANIACTL_ERROR_INVALID_ARGUMENTS;
+		}
+	}
+
+	titaniactl_stress_state stress = { 0 };
+	stress.handle = context->handles[0];
+
+	printf("stressing handle %d for %d seconds, press CTRL+C to stop\n", stress.handle, seconds);
+
+	thrd_t threads[STRESS_UPDATERS + 2];
+	int thread_count = 0;
+	bool started = thrd_create(&threads[thread_count++], titaniactl_stress_pull, &stress) == thrd_success;
+	for (int i = 0; i < STRESS_UPDATERS && started; ++i) {
+		started = thrd_create(&threads[thread_count++], titaniactl_stress_update, &stress) == thrd_success;
+	}
+
+	if (started) {
+		started = thrd_create(&threads[thread_count++], titaniactl_stress_push, &stress) == thrd_success;
+	}
+
+	if (!started) {
+		thread_count -= 1;
+	}
+
+	const struct timespec sleep_time = { 0, 1e+8 };
+	for (int i = 0; i < seconds * 10 && started && !should_stop; ++i) {
+		thrd_sleep(&sleep_time, nullptr);
+	}
+
+	// close while the workers are still running, they should all observe an invalid handle and wind down.
+	titania_close(stress.handle);
+	atomic_store(&stress.stop, true);
+
+	for (int i = 0; i < thread_count; ++i) {
+		thrd_join(threads[i], nullptr);
+	}
+
+	printf("pulls: %llu, updates: %llu, pushes: %llu\n", (unsigned long long) atomic_load(&stress.pulls), (unsigned long long) atomic_load(&stress.updates), (unsigned long long) atomic_load(&stress.pushes));
+
+	if (!started) {
+		titaniactl_errorf("could not start worker threads", "stress test failed");
+		return TITANIACTL_ERROR_INTERRUPTED;
+	}
+
+	return should_stop ? TITANIACTL_ERROR_INTERRUPTED : TITANIACTL_ERROR_OK;
+#endif
+}
@@ -71,6 +71,8 @@ titaniactl_error titaniactl_mode_report_loop(titaniactl_context* context);
 titaniactl_error titaniactl_mode_dump(titaniactl_context* context);
 titaniactl_error titaniactl_mode_test(titaniactl_context* context);
 titaniactl_error titaniactl_mode_bench(titaniactl_context* context);
+titaniactl_error titaniactl_mode_stress(titaniactl_context* context);
+titaniactl_error titaniactl_mode_serve(titaniactl_context* context);
 titaniactl_error titaniactl_mode_led(titaniactl_context* context);
 titaniactl_error titaniactl_mode_bt_pair(titaniactl_context* context);
 titaniactl_error titaniactl_mode_bt_connect(titaniactl_context* context);
@@ -0,0 +1,178 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <math.h>
+#include <string.h>
+
+#include "structures.h"
+
+#define TITANIA_CURVE_POINTS (5) // the three curve points between (0, 0) and (1, 1)
+
+typedef struct titania_curve {
+	float x[TITANIA_CURVE_POINTS];
+	float y[TITANIA_CURVE_POINTS];
+	float tangent[TITANIA_CURVE_POINTS]; // smooth only
+	bool smooth;
+} titania_curve;
+
+static float titania_curve_clamp(const float value) { return value < 0.0f ? 0.0f : value > 1.0f ? 1.0f : value; }
+
+// monotone cubic tangents (fritsch-carlson), so a smooth curve never overshoots the points it passes through.
+static void titania_curve_tangents(titania_curve* curve) {
+	float secant[TITANIA_CURVE_POINTS - 1];
+	for (int i = 0; i < TITANIA_CURVE_POINTS - 1; ++i) {
+		const float dx = curve->x[i + 1] - curve->x[i];
+		secant[i] = dx > 0.0f ? (curve->y[i + 1] - curve->y[i]) / dx : 0.0f;
+	}
+
+	curve->tangent[0] = secant[0];
+	curve->tangent[TITANIA_CURVE_POINTS - 1] = secant[TITANIA_CURVE_POINTS - 2];
+	for (int i = 1; i < TITANIA_CURVE_POINTS - 1; ++i) {
+		curve->tangent[i] = secant[i - 1] * secant[i] <= 0.0f ? 0.0f : (secant[i - 1] + secant[i]) / 2.0f;
+	}
+
+	for (int i = 0; i < TITANIA_CURVE_POINTS - 1; ++i) {
+		if (secant[i] == 0.0f) {
+			curve->tangent[i] = 0.0f;
+			curve->tangent[i + 1] = 0.0f;
+			continue;
+		}
+
+		const float a = curve->tangent[i] / secant[i];
+		const float b = curve->tangent[i + 1] / secant[i];
+		const float length = a * a + b * b;
+		if (length > 9.0f) {
+			const float scale = 3.0f / sqrtf(length);
+			curve->tangent[i] = scale * a * secant[i];
+			curve->tangent[i + 1] = scale * b * secant[i];
+		}
+	}
+}
+
+static float titania_curve_evaluate(const titania_curve* curve, const float t) {
+	int i = 0;
+	while (i < TITANIA_CURVE_POINTS - 2 && t > curve->x[i + 1]) {
+		i++;
+	}
+
+	const float dx = curve->x[i + 1] - curve->x[i];
+	if (dx <= 0.0f) {
+		return curve->y[i + 1];
+	}
+
+	const float s = titania_curve_clamp((t - curve->x[i]) / dx);
+	if (!curve->smooth) {
+		return curve->y[i] + (curve->y[i + 1] - curve->y[i]) * s;
+	}
+
+	const float s2 = s * s;
+	const float s3 = s2 * s;
+	return (2.0f * s3 - 3.0f * s2 + 1.0f) * curve->y[i] + (s3 - 2.0f * s2 + s) * dx * curve->tangent[i] + (-2.0f * s3 + 3.0f * s2) * curve->y[i + 1] + (s3 - s2) * dx * curve->tangent[i + 1];
+}
+
+// evaluates the curve once per possible axis byte, pulling only ever looks the result up.
+static void titania_curve_compile(const titania_edge_stick* stick, float value[256], int8_t fixed[256]) {
+	titania_curve curve = { .smooth = stick->interpolation_type == TITANIA_EDGE_INTERPOLATION_TYPE_SMOOTH };
+	curve.x[TITANIA_CURVE_POINTS - 1] = 1.0f;
+	curve.y[TITANIA_CURVE_POINTS - 1] = 1.0f;
+	for (int i = 0; i < 3; ++i) {
+		// points out of order are pushed forward, the curve can't go back on itself.
+		curve.x[i + 1] = fmaxf(titania_curve_clamp(stick->curve_points[i].x), curve.x[i]);
+		curve.y[i + 1] = titania_curve_clamp(stick->curve_points[i].y);
+	}
+
+	if (curve.smooth) {
+		titania_curve_tangents(&curve);
+	}
+
+	const float inner = titania_curve_clamp(stick->deadzone.x);
+	const float outer = stick->deadzone.y > inner && stick->deadzone.y <= 1.0f ? stick->deadzone.y : 1.0f;
+	for (int raw = 0; raw < 256; ++raw) {
+		// 128 is center, and there is one less step above it than below.
+		const int offset = raw - 128;
+		const float span = offset >= 0 ? 127.0f : 128.0f;
+		const float magnitude = fabsf((float) offset) / span;
+		float shaped = 0.0f;
+		if (!stick->disabled && magnitude > inner) {
+			shaped = titania_curve_clamp(titania_curve_evaluate(&curve, titania_curve_clamp((magnitude - inner) / (outer - inner))));
+		}
+
+		const float position = (offset >= 0 ? shaped : -shaped) * span;
+		value[raw] = (128.0f + position) / 256.0f; // the scale titania_decode_stick uses
+		fixed[raw] = (int8_t) lroundf(position < -128.0f ? -128.0f : position > 127.0f ? 127.0f : position);
+	}
+}
+
+void titania_curve_apply(const dualsense_state* hid_state, titania_data* data, titania_data_fixed* fixed) {
+	const titania_curve_state* curve = &hid_state->pipeline->curve;
+	const dualsense_input_msg* input = &hid_state->input.data.msg.data;
+	if (curve->enabled[TITANIA_LEFT]) {
+		const uint8_t x = input->sticks[DUALSENSE_LEFT].x;
+		const uint8_t y = input->sticks[DUALSENSE_LEFT].y;
+		if (data != nullptr) {
+			data->sticks[TITANIA_LEFT].x = curve->value[TITANIA_LEFT][x];
+			data->sticks[TITANIA_LEFT].y = curve->value[TITANIA_LEFT][y];
+		}
+
+		if (fixed != nullptr) {
+			fixed->sticks[TITANIA_LEFT].x = curve->fixed[TITANIA_LEFT][x];
+			fixed->sticks[TITANIA_LEFT].y = curve->fixed[TITANIA_LEFT][y];
+		}
+	}
+
+	if (curve->enabled[TITANIA_RIGHT]) {
+		const uint8_t x = input->sticks[DUALSENSE_RIGHT].x;
+		const uint8_t y = input->sticks[DUALSENSE_RIGHT].y;
+		if (data != nullptr) {
+			data->sticks[TITANIA_RIGHT].x = curve->value[TITANIA_RIGHT][x];
+			data->sticks[TITANIA_RIGHT].y = curve->value[TITANIA_RIGHT][y];
+		}
+
+		if (fixed != nullptr) {
+			fixed->sticks[TITANIA_RIGHT].x = curve->fixed[TITANIA_RIGHT][x];
+			fixed->sticks[TITANIA_RIGHT].y = curve->fixed[TITANIA_RIGHT][y];
+		}
+	}
+}
+
+static titania_error titania_set_stick_curve_impl(titania_context* ctx, const titania_handle handle, const int32_t stick, const titania_edge_stick* curve) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	// compiled outside the lock, setters only wait on each other for the copy.
+	float value[256];
+	int8_t fixed[256];
+	if (curve != nullptr) {
+		titania_curve_compile(curve, value, fixed);
+	}
+
+	LOCK_INFO(hid_state);
+	titania_pipeline* pipeline = titania_pipeline_edit(hid_state);
+	if (pipeline == nullptr) {
+		UNLOCK_INFO(hid_state);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	if (curve != nullptr) {
+		memcpy(pipeline->curve.value[stick], value, sizeof(value));
+		memcpy(pipeline->curve.fixed[stick], fixed, sizeof(fixed));
+	}
+
+	pipeline->curve.enabled[stick] = curve != nullptr;
+	titania_pipeline_publish(hid_state, pipeline);
+	UNLOCK_INFO(hid_state);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_set_stick_curve(titania_context* ctx, const titania_handle handle, const int32_t stick, const titania_edge_stick* curve) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (stick != TITANIA_LEFT && stick != TITANIA_RIGHT) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_set_stick_curve_impl(ctx, handle, stick, curve);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
@@ -13,13 +13,7 @@ titania_error titania_convert_edge_profile_input(uint8_t profile_data[TITANIA_ME
 
 	const dualsense_edge_profile profile = *(dualsense_edge_profile*) profile_data;
 
-	titania_char32 unicode[41];
-	titania_unicode_result unicode_result = titania_utf16_to_utf32((const titania_char16*) &profile.msg.name, sizeof(profile.msg.name), unicode, sizeof(unicode));
-	if (unicode_result.failed) {
-		return TITANIA_ERROR_UNICODE_ERROR;
-	}
-
-	unicode_result = titania_utf32_to_utf8(unicode, sizeof(unicode), (titania_char8*) &output->name, sizeof(output->name));
+	const titania_unicode_result unicode_result = titania_utf16_to_utf8((const titania_char16*) &profile.msg.name, sizeof(profile.msg.name) / sizeof(titania_char16), (titania_char8*) &output->name, sizeof(output->name));
 	if (unicode_result.failed) {
 		return TITANIA_ERROR_UNICODE_ERROR;
 	}
@@ -111,13 +105,7 @@ titania_error titania_convert_edge_profile_output(titania_edge_profile input, du
 
 	profile.msg.version = 1;
 
-	titania_char32 unicode[41];
-	titania_unicode_result unicode_result = titania_utf8_to_utf32((const titania_char8*) &input.name, sizeof(input.name), unicode, sizeof(unicode));
-	if (unicode_result.failed) {
-		return TITANIA_ERROR_UNICODE_ERROR;
-	}
-
-	unicode_result = titania_utf32_to_utf16(unicode, sizeof(unicode), (titania_char16*) &profile.msg.name, sizeof(profile.msg.name));
+	const titania_unicode_result unicode_result = titania_utf8_to_utf16((const titania_char8*) &input.name, sizeof(input.name), (titania_char16*) &profile.msg.name, sizeof(profile.msg.name) / sizeof(titania_char16));
 	if (unicode_result.failed) {
 		return TITANIA_ERROR_UNICODE_ERROR;
 	}
@@ -303,12 +291,19 @@ titania_error titania_helper_edge_stick_template(titania_edge_stick* stick, cons
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_debug_get_edge_profile(const titania_handle handle, const titania_profile_id profile_id, uint8_t profile_data[TITANIA_MERGED_REPORT_EDGE_SIZE]) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
-	CHECK_EDGE(handle);
+void titania_invalidate_edge_profile(dualsense_state* hid_state, const titania_profile_id profile_id) {
+	LOCK_INFO(hid_state);
+	for (int i = 0; i < TITANIA_EDGE_PROFILE_COUNT; ++i) {
+		if (profile_id == TITANIA_PROFILE_ALL || profile_id == (titania_profile_id) (TITANIA_PROFILE_TRIANGLE + i)) {
+			hid_state->edge_profiles[i].has_data = false;
+			hid_state->edge_profiles[i].has_profile = false;
+		}
+	}
+	UNLOCK_INFO(hid_state);
+}
 
-	dualsense_edge_profile_blob data = { 0 };
+static titania_error titania_debug_get_edge_profile_impl(titania_context* ctx, const titania_handle handle, const titania_profile_id profile_id, uint8_t profile_data[TITANIA_MERGED_REPORT_EDGE_SIZE]) {
+	CHECK_EDGE(ctx, handle);
 
 	uint8_t id;
 	switch (profile_id) {
@@ -319,35 +314,131 @@ titania_error titania_debug_get_edge_profile(const titania_handle handle, const
 		default: return TITANIA_ERROR_INVALID_PROFILE;
 	}
 
-	for (int i = 0; i < 3; ++i) {
-		data.report_id = id + i;
-		if (HID_FAIL(hid_get_feature_report(state[handle].hid, (uint8_t*) &data, sizeof(dualsense_edge_profile_blob))) || (i == 0 && data.profile_part == 0x10)) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	titania_edge_profile_cache* cache = &hid_state->edge_profiles[profile_id - TITANIA_PROFILE_TRIANGLE];
+	dualsense_edge_profile_blob data[3] = { 0 };
+
+	// the last part carries the timestamp and the checksum of the whole profile, if it did not change neither did the rest.
+	data[2].report_id = id + 2;
+	if (HID_FAIL(hid_get_feature_report(hid_state->hid, (uint8_t*) &data[2], sizeof(dualsense_edge_profile_blob)))) {
+		return TITANIA_ERROR_INVALID_DATA;
+	}
+
+	LOCK_INFO(hid_state);
+	const bool is_cached = cache->has_data && memcmp(&cache->data[sizeof(data[2].blob) * 2], data[2].blob, sizeof(data[2].blob)) == 0;
+	if (is_cached) {
+		memcpy(profile_data, cache->data, TITANIA_MERGED_REPORT_EDGE_SIZE);
+	}
+	UNLOCK_INFO(hid_state);
+
+	if (is_cached) {
+		return TITANIA_ERROR_OK;
+	}
+
+	for (int i = 0; i < 2; ++i) {
+		data[i].report_id = id + i;
+		if (HID_FAIL(hid_get_feature_report(hid_state->hid, (uint8_t*) &data[i], sizeof(dualsense_edge_profile_blob))) || (i == 0 && data[i].profile_part == 0x10)) {
 			return TITANIA_ERROR_INVALID_DATA;
 		}
+	}
 
-		memcpy(&profile_data[sizeof(data.blob) * i], data.blob, sizeof(data.blob));
+	for (int i = 0; i < 3; ++i) {
+		memcpy(&profile_data[sizeof(data[i].blob) * i], data[i].blob, sizeof(data[i].blob));
 	}
 
+	LOCK_INFO(hid_state);
+	memcpy(cache->data, profile_data, TITANIA_MERGED_REPORT_EDGE_SIZE);
+	cache->has_data = true;
+	cache->has_profile = false;
+	UNLOCK_INFO(hid_state);
+
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_query_edge_profile(const titania_handle handle, const titania_profile_id profile_id, titania_edge_profile* profile) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
-	CHECK_EDGE(handle);
+titania_error titania_ctx_debug_get_edge_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id profile_id, uint8_t profile_data[TITANIA_MERGED_REPORT_EDGE_SIZE]) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_debug_get_edge_profile_impl(ctx, handle, profile_id, profile_data);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_query_edge_profile_impl(titania_context* ctx, const titania_handle handle, const titania_profile_id profile_id, titania_edge_profile* profile) {
+	CHECK_EDGE(ctx, handle);
 
 	uint8_t profile_data[TITANIA_MERGED_REPORT_EDGE_SIZE];
-	titania_error result = titania_debug_get_edge_profile(handle, profile_id, profile_data);
+	titania_error result = titania_debug_get_edge_profile_impl(ctx, handle, profile_id, profile_data);
 	if (IS_TITANIA_BAD(result)) {
 		profile->valid = false;
 		return TITANIA_ERROR_INVALID_DATA;
 	}
 
+	// the profile is unchanged since the last query, skip converting it again.
+	dualsense_state* hid_state = &ctx->state[handle];
+	titania_edge_profile_cache* cache = &hid_state->edge_profiles[profile_id - TITANIA_PROFILE_TRIANGLE];
+	LOCK_INFO(hid_state);
+	const bool is_cached = cache->has_profile && memcmp(cache->data, profile_data, TITANIA_MERGED_REPORT_EDGE_SIZE) == 0;
+	if (is_cached) {
+		*profile = cache->profile;
+	}
+	UNLOCK_INFO(hid_state);
+
+	if (is_cached) {
+		return TITANIA_ERROR_OK;
+	}
+
 	result = titania_convert_edge_profile_input(profile_data, profile);
 	if (IS_TITANIA_BAD(result)) {
 		memset(profile, 0, sizeof(titania_edge_profile));
 		profile->valid = false;
+		return result;
+	}
+
+	LOCK_INFO(hid_state);
+	if (memcmp(cache->data, profile_data, TITANIA_MERGED_REPORT_EDGE_SIZE) == 0) {
+		cache->profile = *profile;
+		cache->has_profile = true;
+	}
+	UNLOCK_INFO(hid_state);
+
+	return result;
+}
+
+titania_error titania_ctx_query_edge_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id profile_id, titania_edge_profile* profile) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_query_edge_profile_impl(ctx, handle, profile_id, profile);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_query_edge_profiles_all_impl(titania_context* ctx, const titania_handle handle, titania_edge_profile profiles[TITANIA_EDGE_PROFILE_COUNT]) {
+	CHECK_EDGE(ctx, handle);
+
+	// empty slots come back with valid unset, the query only fails when no slot could be read at all.
+	titania_error result = TITANIA_ERROR_INVALID_DATA;
+	for (int i = 0; i < TITANIA_EDGE_PROFILE_COUNT; ++i) {
+		const titania_error profile_result = titania_query_edge_profile_impl(ctx, handle, TITANIA_PROFILE_TRIANGLE + i, &profiles[i]);
+		if (IS_TITANIA_OKAY(profile_result) || IS_TITANIA_BAD(result)) {
+			result = profile_result;
+		}
+	}
+
+	return result;
+}
+
+titania_error titania_ctx_query_edge_profiles_all(titania_context* ctx, const titania_handle handle, titania_edge_profile profiles[TITANIA_EDGE_PROFILE_COUNT]) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (profiles == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
 	}
 
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_query_edge_profiles_all_impl(ctx, handle, profiles);
+	RELEASE_HANDLE(ctx, handle);
 	return result;
 }
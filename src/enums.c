@@ -22,6 +22,7 @@ const char* const titania_error_msg[TITANIA_ERROR_MAX + 1] = {
 	"not an edge controller",
 	"not an access controller",
 	"not supported",
+	"out of memory",
 	nullptr
 };
 
@@ -189,3 +190,57 @@ const char* const titania_access_extension_type_id_msg[TITANIA_ACCESS_EXTENSION_
 };
 
 // clang-format on
+
+const char* const titania_filter_type_msg[TITANIA_FILTER_MAX + 1] = {
+	"none",
+	"exponential",
+	"median3",
+	"one euro",
+	nullptr
+};
+
+const char* const titania_filter_channel_msg[TITANIA_FILTER_CHANNEL_MAX + 1] = {
+	"sticks",
+	"triggers",
+	"gyro",
+	"accelerometer",
+	nullptr
+};
+
+const char* const titania_gesture_type_msg[TITANIA_GESTURE_MAX + 1] = {
+	"tap",
+	"swipe",
+	"scroll",
+	"pinch",
+	nullptr
+};
+
+const char* const titania_gesture_phase_msg[TITANIA_GESTURE_PHASE_MAX + 1] = {
+	"begin",
+	"update",
+	"end",
+	nullptr
+};
+
+const char* const titania_gyro_space_msg[TITANIA_GYRO_SPACE_MAX + 1] = {
+	"local",
+	"world",
+	"player",
+	nullptr
+};
+
+const char* const titania_prediction_model_msg[TITANIA_PREDICTION_MAX + 1] = {
+	"none",
+	"linear",
+	"acceleration",
+	nullptr
+};
+
+const char* const titania_shared_command_type_msg[TITANIA_SHARED_COMMAND_MAX + 1] = {
+	"led",
+	"audio",
+	"control",
+	"effect",
+	"rumble",
+	nullptr
+};
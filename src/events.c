@@ -0,0 +1,94 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <time.h>
+
+#include "structures.h"
+
+// timespec_get only has TIME_MONOTONIC on newer c libraries, TIME_UTC jumps whenever the wall clock is set.
+uint64_t titania_host_time(void) {
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (uint64_t) (counter.QuadPart / frequency.QuadPart) * 1000000000ull + (uint64_t) (counter.QuadPart % frequency.QuadPart) * 1000000000ull / (uint64_t) frequency.QuadPart;
+#else
+	struct timespec now;
+#ifdef TIME_MONOTONIC
+	timespec_get(&now, TIME_MONOTONIC);
+#else
+	clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+	return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+#endif
+}
+
+uint64_t titania_get_host_time(void) { return titania_host_time(); }
+
+void titania_queue_button_events(dualsense_state* hid_state) {
+	const dualsense_input_msg* input = &hid_state->input.data.msg.data;
+	const bool is_access = hid_state->hid_info.is_access;
+	const uint32_t buttons = is_access ? titania_convert_access_buttons(input) : titania_convert_buttons(input, false);
+	uint32_t changed = buttons ^ hid_state->event_buttons;
+	if (changed == 0) {
+		return;
+	}
+
+	const uint64_t host_time = titania_host_time();
+	unsigned int head = atomic_load_explicit(&hid_state->event_head, memory_order_relaxed);
+	const unsigned int tail = atomic_load_explicit(&hid_state->event_tail, memory_order_acquire);
+	while (changed != 0) {
+		if (head - tail >= TITANIA_EVENT_QUEUE_SIZE) {
+			break;
+		}
+
+		// only queued changes are remembered, anything dropped shows up again once there is room.
+		const uint32_t bit = changed & (~changed + 1);
+		changed &= ~bit;
+		hid_state->event_buttons ^= bit;
+
+		titania_button_event* event = &hid_state->events[head & (TITANIA_EVENT_QUEUE_SIZE - 1)];
+		event->host_time = host_time;
+		event->device_time = input->firmware_time;
+		event->button = bit;
+		event->pressed = (buttons & bit) != 0;
+		event->is_access = is_access;
+		head++;
+	}
+
+	atomic_store_explicit(&hid_state->event_head, head, memory_order_release);
+}
+
+static titania_error titania_get_events_impl(titania_context* ctx, const titania_handle handle, titania_button_event* events, const size_t count, size_t* written) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	const unsigned int head = atomic_load_explicit(&hid_state->event_head, memory_order_acquire);
+	unsigned int tail = atomic_load_explicit(&hid_state->event_tail, memory_order_relaxed);
+	size_t n = 0;
+	while (n < count && tail != head) {
+		events[n++] = hid_state->events[tail & (TITANIA_EVENT_QUEUE_SIZE - 1)];
+		tail++;
+	}
+
+	atomic_store_explicit(&hid_state->event_tail, tail, memory_order_release);
+	*written = n;
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_get_events(titania_context* ctx, const titania_handle handle, titania_button_event* events, const size_t count, size_t* written) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if ((events == nullptr && count > 0) || written == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_get_events_impl(ctx, handle, events, count, written);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
@@ -0,0 +1,178 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <math.h>
+#include <string.h>
+
+#include "structures.h"
+
+#define TITANIA_FILTER_MAX_STEP (0.1f) // seconds, longer gaps restart the filter
+#define TITANIA_FILTER_TAU (6.28318530717959f)
+
+static const struct {
+	uint8_t first;
+	uint8_t count;
+} titania_filter_lanes[TITANIA_FILTER_CHANNEL_MAX] = {
+	[TITANIA_FILTER_CHANNEL_STICKS] = { 0, 4 },
+	[TITANIA_FILTER_CHANNEL_TRIGGERS] = { 4, 2 },
+	[TITANIA_FILTER_CHANNEL_GYRO] = { 6, 3 },
+	[TITANIA_FILTER_CHANNEL_ACCELEROMETER] = { 9, 3 },
+};
+
+static void titania_filter_gather(const titania_data* data, float lanes[TITANIA_FILTER_LANES]) {
+	memset(lanes, 0, sizeof(float) * TITANIA_FILTER_LANES);
+	lanes[0] = data->sticks[TITANIA_LEFT].x;
+	lanes[1] = data->sticks[TITANIA_LEFT].y;
+	lanes[2] = data->sticks[TITANIA_RIGHT].x;
+	lanes[3] = data->sticks[TITANIA_RIGHT].y;
+	lanes[4] = data->triggers[TITANIA_LEFT].level;
+	lanes[5] = data->triggers[TITANIA_RIGHT].level;
+	lanes[6] = data->sensors.gyro.x;
+	lanes[7] = data->sensors.gyro.y;
+	lanes[8] = data->sensors.gyro.z;
+	lanes[9] = data->sensors.accelerometer.x;
+	lanes[10] = data->sensors.accelerometer.y;
+	lanes[11] = data->sensors.accelerometer.z;
+}
+
+static void titania_filter_scatter(const float lanes[TITANIA_FILTER_LANES], titania_data* data) {
+	data->sticks[TITANIA_LEFT].x = lanes[0];
+	data->sticks[TITANIA_LEFT].y = lanes[1];
+	data->sticks[TITANIA_RIGHT].x = lanes[2];
+	data->sticks[TITANIA_RIGHT].y = lanes[3];
+	data->triggers[TITANIA_LEFT].level = lanes[4];
+	data->triggers[TITANIA_RIGHT].level = lanes[5];
+	data->sensors.gyro.x = lanes[6];
+	data->sensors.gyro.y = lanes[7];
+	data->sensors.gyro.z = lanes[8];
+	data->sensors.accelerometer.x = lanes[9];
+	data->sensors.accelerometer.y = lanes[10];
+	data->sensors.accelerometer.z = lanes[11];
+}
+
+// every lane runs every filter, the per-lane weights pick which result sticks. kept branch free so it vectorises.
+static void titania_filter_step(const titania_filter_config* config, titania_filter_state* filter, const float input[TITANIA_FILTER_LANES], const float dt) {
+	const float rate = 1.0f / dt;
+	for (int j = 0; j < TITANIA_FILTER_LANES; ++j) {
+		const float a = filter->history[1][j];
+		const float b = filter->history[0][j];
+		const float c = input[j];
+		const float low = a < b ? a : b;
+		const float high = a < b ? b : a;
+		const float clamped = c < high ? c : high;
+		const float median = low > clamped ? low : clamped;
+		const float x = c + config->median[j] * (median - c);
+
+		const float derivative_step = TITANIA_FILTER_TAU * config->derivative_cutoff[j] * dt;
+		filter->speed[j] += derivative_step / (derivative_step + 1.0f) * ((x - filter->value[j]) * rate - filter->speed[j]);
+		const float speed = filter->speed[j] < 0.0f ? -filter->speed[j] : filter->speed[j];
+		const float step = TITANIA_FILTER_TAU * (config->min_cutoff[j] + config->beta[j] * speed) * dt;
+		const float alpha = config->alpha[j] + config->one_euro[j] * (step / (step + 1.0f) - config->alpha[j]);
+
+		filter->value[j] += alpha * (x - filter->value[j]);
+		filter->history[1][j] = b;
+		filter->history[0][j] = c;
+	}
+}
+
+static void titania_filter_prime(titania_filter_state* filter, const float input[TITANIA_FILTER_LANES]) {
+	memcpy(filter->value, input, sizeof(filter->value));
+	memcpy(filter->history[0], input, sizeof(filter->history[0]));
+	memcpy(filter->history[1], input, sizeof(filter->history[1]));
+	memset(filter->speed, 0, sizeof(filter->speed));
+	filter->primed = true;
+}
+
+void titania_filter_apply(dualsense_state* hid_state, titania_data* data) {
+	const titania_filter_config* config = &hid_state->pipeline->filter;
+	if (!config->enabled) {
+		return;
+	}
+
+	titania_filter_state* filter = &hid_state->filter;
+	float dt;
+	if (hid_state->hid_info.is_access) {
+		const uint64_t now = titania_host_time();
+		dt = (float) (now - filter->host_time) / 1000000000.0f;
+		filter->host_time = now;
+	} else {
+		// the sensor clock wraps every 24 minutes, unsigned subtraction absorbs it.
+		dt = (float) (data->time.sensor - filter->sensor_time) / DUALSENSE_SENSOR_TICKS_PER_SECOND;
+		filter->sensor_time = data->time.sensor;
+	}
+
+	alignas(64) float lanes[TITANIA_FILTER_LANES];
+	titania_filter_gather(data, lanes);
+	if (!filter->primed || dt > TITANIA_FILTER_MAX_STEP) {
+		titania_filter_prime(filter, lanes);
+		return;
+	}
+
+	// the same report read twice repeats the last output rather than counting as a zero length step.
+	if (dt > 0.0f) {
+		titania_filter_step(config, filter, lanes, dt);
+	}
+
+	titania_filter_scatter(filter->value, data);
+}
+
+static titania_error titania_set_filter_impl(titania_context* ctx, const titania_handle handle, const titania_filter_channel channel, const titania_filter settings) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	LOCK_INFO(hid_state);
+	titania_pipeline* pipeline = titania_pipeline_edit(hid_state);
+	if (pipeline == nullptr) {
+		UNLOCK_INFO(hid_state);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	titania_filter_config* filter = &pipeline->filter;
+	if (!filter->enabled) {
+		for (int j = 0; j < TITANIA_FILTER_LANES; ++j) {
+			filter->alpha[j] = 1.0f;
+			filter->median[j] = 0.0f;
+			filter->one_euro[j] = 0.0f;
+		}
+	}
+
+	for (int j = titania_filter_lanes[channel].first; j < titania_filter_lanes[channel].first + titania_filter_lanes[channel].count; ++j) {
+		filter->alpha[j] = settings.type == TITANIA_FILTER_EXPONENTIAL ? settings.alpha : 1.0f;
+		filter->median[j] = settings.type == TITANIA_FILTER_MEDIAN3 ? 1.0f : 0.0f;
+		filter->one_euro[j] = settings.type == TITANIA_FILTER_ONE_EURO ? 1.0f : 0.0f;
+		filter->min_cutoff[j] = settings.min_cutoff;
+		filter->beta[j] = settings.beta;
+		filter->derivative_cutoff[j] = settings.derivative_cutoff > 0.0f ? settings.derivative_cutoff : 1.0f;
+	}
+
+	filter->enabled = false;
+	for (int j = 0; j < TITANIA_FILTER_LANES; ++j) {
+		filter->enabled |= filter->alpha[j] != 1.0f || filter->median[j] != 0.0f || filter->one_euro[j] != 0.0f;
+	}
+
+	filter->generation++;
+	titania_pipeline_publish(hid_state, pipeline);
+	UNLOCK_INFO(hid_state);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_set_filter(titania_context* ctx, const titania_handle handle, const titania_filter_channel channel, const titania_filter filter) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (channel < 0 || channel >= TITANIA_FILTER_CHANNEL_MAX || filter.type < 0 || filter.type >= TITANIA_FILTER_MAX) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	if (filter.type == TITANIA_FILTER_EXPONENTIAL && !(filter.alpha >= 0.0f && filter.alpha <= 1.0f)) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	if (filter.type == TITANIA_FILTER_ONE_EURO && !(filter.min_cutoff >= 0.0f && filter.beta >= 0.0f && !isnan(filter.derivative_cutoff))) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_set_filter_impl(ctx, handle, channel, filter);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
@@ -0,0 +1,209 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <math.h>
+#include <string.h>
+
+#include "structures.h"
+
+// gaps longer than this (a stall, a reconnect) are not integrated, the accelerometer still corrects the next sample.
+#define TITANIA_FUSION_MAX_STEP (0.1f)
+
+// titania_data keeps the sign of the calibrated range (which is negative below zero), motion needs the real direction.
+float titania_fusion_calibrate(const int32_t value, const titania_calibration_scale* calibration) { return (float) value * fabsf(calibration->scale[value < 0]); }
+
+static float titania_fusion_length(const float v[4]) { return sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3]); }
+
+// starts from the rotation that lines the accelerometer up with world z, so there is nothing to converge on the first frame.
+static void titania_fusion_seed(titania_fusion_state* fusion, const float accelerometer[3]) {
+	float q[4] = { 1.0f + accelerometer[2], accelerometer[1], -accelerometer[0], 0.0f };
+	if (q[0] < 1e-6f) { // upside down, any half turn around a horizontal axis works.
+		q[0] = 0.0f;
+		q[1] = 1.0f;
+		q[2] = 0.0f;
+	}
+
+	const float norm = 1.0f / titania_fusion_length(q);
+	for (int j = 0; j < 4; ++j) {
+		fusion->q[j] = q[j] * norm;
+	}
+}
+
+// one madgwick imu step, written as 4-wide quaternion lanes so the compiler can keep it in vector registers.
+static void titania_fusion_step(titania_fusion_state* fusion, const float gain, const float gyro[3], const float accelerometer[3], const float dt) {
+	const float w = fusion->q[0];
+	const float x = fusion->q[1];
+	const float y = fusion->q[2];
+	const float z = fusion->q[3];
+
+	// q' = 0.5 * q * (0, gyro)
+	const float rate_x[4] = { -x, w, z, -y };
+	const float rate_y[4] = { -y, -z, w, x };
+	const float rate_z[4] = { -z, y, -x, w };
+	float rate[4];
+	for (int j = 0; j < 4; ++j) {
+		rate[j] = 0.5f * (gyro[0] * rate_x[j] + gyro[1] * rate_y[j] + gyro[2] * rate_z[j]);
+	}
+
+	// gradient of the error between the predicted and measured up vectors, J^T * f.
+	const float error[3] = {
+		2.0f * (x * z - w * y) - accelerometer[0],
+		2.0f * (w * x + y * z) - accelerometer[1],
+		2.0f * (0.5f - x * x - y * y) - accelerometer[2],
+	};
+	const float jacobian_x[4] = { -2.0f * y, 2.0f * z, -2.0f * w, 2.0f * x };
+	const float jacobian_y[4] = { 2.0f * x, 2.0f * w, 2.0f * z, 2.0f * y };
+	const float jacobian_z[4] = { 0.0f, -4.0f * x, -4.0f * y, 0.0f };
+	float gradient[4];
+	for (int j = 0; j < 4; ++j) {
+		gradient[j] = error[0] * jacobian_x[j] + error[1] * jacobian_y[j] + error[2] * jacobian_z[j];
+	}
+
+	const float gradient_length = titania_fusion_length(gradient);
+	const float correction = gradient_length > 0.0f ? gain / gradient_length : 0.0f;
+
+	float q[4];
+	for (int j = 0; j < 4; ++j) {
+		q[j] = fusion->q[j] + (rate[j] - correction * gradient[j]) * dt;
+	}
+
+	const float norm = 1.0f / titania_fusion_length(q);
+	for (int j = 0; j < 4; ++j) {
+		fusion->q[j] = q[j] * norm;
+	}
+}
+
+void titania_fusion_update(dualsense_state* hid_state) {
+	const titania_fusion_config* config = &hid_state->pipeline->fusion;
+	if (!config->enabled) {
+		return;
+	}
+
+	titania_fusion_state* fusion = &hid_state->fusion;
+	const dualsense_sensors* sensors = &hid_state->input.data.msg.data.sensors;
+	const titania_calibration_scale* calibration = hid_state->calibration;
+	float accelerometer[3] = {
+		titania_fusion_calibrate(sensors->accelerometer.x, &calibration[CALIBRATION_ACCELEROMETER_X]),
+		titania_fusion_calibrate(sensors->accelerometer.y, &calibration[CALIBRATION_ACCELEROMETER_Y]),
+		titania_fusion_calibrate(sensors->accelerometer.z, &calibration[CALIBRATION_ACCELEROMETER_Z]),
+	};
+
+	// only the direction of the accelerometer matters, a free falling controller has none.
+	const float accelerometer_length = sqrtf(accelerometer[0] * accelerometer[0] + accelerometer[1] * accelerometer[1] + accelerometer[2] * accelerometer[2]);
+	if (accelerometer_length <= 0.0f) {
+		return;
+	}
+
+	for (int j = 0; j < 3; ++j) {
+		accelerometer[j] /= accelerometer_length;
+	}
+
+	if (fusion->samples == 0) {
+		titania_fusion_seed(fusion, accelerometer);
+	} else {
+		// the sensor clock wraps every 24 minutes, unsigned subtraction absorbs it.
+		const float dt = (float) (sensors->time - fusion->sensor_time) / DUALSENSE_SENSOR_TICKS_PER_SECOND;
+		if (dt <= 0.0f) { // the same sample read twice.
+			return;
+		}
+
+		const float gyro[3] = {
+			titania_fusion_calibrate(sensors->gyro.x - calibration[CALIBRATION_GYRO_X].bias, &calibration[CALIBRATION_GYRO_X]) * DUALSENSE_GYRO_RADIANS,
+			titania_fusion_calibrate(sensors->gyro.y - calibration[CALIBRATION_GYRO_Y].bias, &calibration[CALIBRATION_GYRO_Y]) * DUALSENSE_GYRO_RADIANS,
+			titania_fusion_calibrate(sensors->gyro.z - calibration[CALIBRATION_GYRO_Z].bias, &calibration[CALIBRATION_GYRO_Z]) * DUALSENSE_GYRO_RADIANS,
+		};
+
+		titania_fusion_step(fusion, config->gain, gyro, accelerometer, dt > TITANIA_FUSION_MAX_STEP ? 0.0f : dt);
+	}
+
+	fusion->sensor_time = sensors->time;
+	fusion->samples++;
+}
+
+void titania_fusion_orientation(const float q[4], titania_orientation* orientation) {
+	const float w = q[0];
+	const float x = q[1];
+	const float y = q[2];
+	const float z = q[3];
+	orientation->orientation = (titania_quaternion) { w, x, y, z };
+	// world down rotated into controller space, the opposite of what the accelerometer reads at rest.
+	orientation->gravity.x = -2.0f * (x * z - w * y);
+	orientation->gravity.y = -2.0f * (w * x + y * z);
+	orientation->gravity.z = -(w * w - x * x - y * y + z * z);
+}
+
+static titania_error titania_set_fusion_impl(titania_context* ctx, const titania_handle handle, const bool enabled, const float gain) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	if (hid_state->hid_info.is_access) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	LOCK_INFO(hid_state);
+	titania_pipeline* pipeline = titania_pipeline_edit(hid_state);
+	if (pipeline == nullptr) {
+		UNLOCK_INFO(hid_state);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	// pull starts the filter over when it picks this up.
+	pipeline->fusion.gain = gain > 0.0f ? gain : TITANIA_FUSION_DEFAULT_GAIN;
+	pipeline->fusion.enabled = enabled;
+	pipeline->fusion.generation++;
+	titania_pipeline_publish(hid_state, pipeline);
+	UNLOCK_INFO(hid_state);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_set_fusion(titania_context* ctx, const titania_handle handle, const bool enabled, const float gain) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (isnan(gain)) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_set_fusion_impl(ctx, handle, enabled, gain);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_get_orientation_impl(titania_context* ctx, const titania_handle handle, titania_orientation* orientation) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	LOCK_INFO(hid_state);
+	const titania_fusion_config config = hid_state->pipeline_staging.fusion;
+	const titania_results* results = titania_results_read(hid_state);
+	titania_fusion_state fusion = results->fusion;
+	const uint32_t generation = results->fusion_generation;
+	UNLOCK_INFO(hid_state);
+
+	if (!config.enabled) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	// pull has not reached the current settings yet.
+	if (generation != config.generation) {
+		memset(&fusion, 0, sizeof(titania_fusion_state));
+		fusion.q[0] = 1.0f;
+	}
+
+	titania_fusion_orientation(fusion.q, orientation);
+	orientation->sensor_time = fusion.sensor_time;
+	orientation->samples = fusion.samples;
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_get_orientation(titania_context* ctx, const titania_handle handle, titania_orientation* orientation) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (orientation == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_get_orientation_impl(ctx, handle, orientation);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
@@ -0,0 +1,305 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <math.h>
+#include <string.h>
+
+#include "structures.h"
+
+// distances in touchpad units, times in sensor ticks.
+#define TITANIA_GESTURE_TAP_SLOP (40.0f) // how far a tap may wander
+#define TITANIA_GESTURE_TAP_TICKS (750000u) // a quarter second, longer touches are not taps
+#define TITANIA_GESTURE_SWIPE_DISTANCE (200.0f)
+#define TITANIA_GESTURE_SWIPE_SPEED (1500.0f) // per second, as the finger lifts
+#define TITANIA_GESTURE_SCROLL_DISTANCE (40.0f) // both fingers together
+#define TITANIA_GESTURE_PINCH_DISTANCE (80.0f) // fingers apart or together
+#define TITANIA_GESTURE_VELOCITY_WEIGHT (0.5f) // weight of the newest touch sample in the velocities
+#define TITANIA_GESTURE_MAX_STEP (0.1f) // seconds, longer gaps don't count towards velocity
+
+typedef enum titania_gesture_mode {
+	TITANIA_GESTURE_MODE_IDLE, // nothing on the touchpad
+	TITANIA_GESTURE_MODE_PENDING, // fingers down, nothing recognised yet
+	TITANIA_GESTURE_MODE_SCROLL,
+	TITANIA_GESTURE_MODE_PINCH,
+	TITANIA_GESTURE_MODE_DONE, // a scroll or pinch ended, the rest of the touch is ignored
+} titania_gesture_mode;
+
+static void titania_gesture_queue(dualsense_state* hid_state, const titania_gesture_event* event) {
+	const unsigned int head = atomic_load_explicit(&hid_state->gesture_head, memory_order_relaxed);
+	const unsigned int tail = atomic_load_explicit(&hid_state->gesture_tail, memory_order_acquire);
+	if (head - tail >= TITANIA_GESTURE_QUEUE_SIZE) {
+		return;
+	}
+
+	hid_state->gestures[head & (TITANIA_GESTURE_QUEUE_SIZE - 1)] = *event;
+	hid_state->gestures[head & (TITANIA_GESTURE_QUEUE_SIZE - 1)].host_time = titania_host_time();
+	atomic_store_explicit(&hid_state->gesture_head, head + 1, memory_order_release);
+}
+
+// scrolls and pinches, position and velocity are taken between both fingers.
+static void titania_gesture_queue_pair(dualsense_state* hid_state, const titania_gesture_type type, const titania_gesture_phase phase, const float delta[2]) {
+	const titania_gesture_state* gesture = &hid_state->gesture;
+	titania_gesture_event event = {
+		.sensor_time = gesture->sensor_time,
+		.type = type,
+		.phase = phase,
+		.fingers = 2,
+		.position = { { gesture->pair_last[0] }, { gesture->pair_last[1] } },
+		.delta = { { delta[0] }, { delta[1] } },
+		.velocity = { { (gesture->fingers[0].velocity[0] + gesture->fingers[1].velocity[0]) / 2.0f }, { (gesture->fingers[0].velocity[1] + gesture->fingers[1].velocity[1]) / 2.0f } },
+	};
+
+	if (type == TITANIA_GESTURE_PINCH && gesture->distance_start > 0.0f) {
+		event.scale = gesture->distance_last / gesture->distance_start;
+		event.scale_velocity = gesture->distance_velocity / gesture->distance_start;
+	}
+
+	titania_gesture_queue(hid_state, &event);
+}
+
+static void titania_gesture_update_pair(dualsense_state* hid_state, const float rate) {
+	titania_gesture_state* gesture = &hid_state->gesture;
+	const titania_gesture_finger* a = &gesture->fingers[0];
+	const titania_gesture_finger* b = &gesture->fingers[1];
+	const float middle[2] = { (a->last[0] + b->last[0]) / 2.0f, (a->last[1] + b->last[1]) / 2.0f };
+	const float distance = hypotf(a->last[0] - b->last[0], a->last[1] - b->last[1]);
+	if (!gesture->has_pair) {
+		memcpy(gesture->pair_start, middle, sizeof(middle));
+		memcpy(gesture->pair_last, middle, sizeof(middle));
+		gesture->distance_start = distance;
+		gesture->distance_last = distance;
+		gesture->distance_velocity = 0.0f;
+		gesture->has_pair = true;
+		return;
+	}
+
+	const float delta[2] = { middle[0] - gesture->pair_last[0], middle[1] - gesture->pair_last[1] };
+	if (rate > 0.0f) {
+		gesture->distance_velocity += TITANIA_GESTURE_VELOCITY_WEIGHT * ((distance - gesture->distance_last) * rate - gesture->distance_velocity);
+	}
+
+	const bool moved = delta[0] != 0.0f || delta[1] != 0.0f || distance != gesture->distance_last;
+	memcpy(gesture->pair_last, middle, sizeof(middle));
+	gesture->distance_last = distance;
+
+	switch (gesture->mode) {
+		case TITANIA_GESTURE_MODE_PENDING: {
+			const float travel[2] = { middle[0] - gesture->pair_start[0], middle[1] - gesture->pair_start[1] };
+			if (fabsf(distance - gesture->distance_start) > TITANIA_GESTURE_PINCH_DISTANCE) {
+				gesture->mode = TITANIA_GESTURE_MODE_PINCH;
+				titania_gesture_queue_pair(hid_state, TITANIA_GESTURE_PINCH, TITANIA_GESTURE_PHASE_BEGIN, travel);
+			} else if (travel[0] * travel[0] + travel[1] * travel[1] > TITANIA_GESTURE_SCROLL_DISTANCE * TITANIA_GESTURE_SCROLL_DISTANCE) {
+				gesture->mode = TITANIA_GESTURE_MODE_SCROLL;
+				titania_gesture_queue_pair(hid_state, TITANIA_GESTURE_SCROLL, TITANIA_GESTURE_PHASE_BEGIN, travel);
+			}
+			break;
+		}
+		case TITANIA_GESTURE_MODE_SCROLL:
+			if (moved) {
+				titania_gesture_queue_pair(hid_state, TITANIA_GESTURE_SCROLL, TITANIA_GESTURE_PHASE_UPDATE, delta);
+			}
+			break;
+		case TITANIA_GESTURE_MODE_PINCH:
+			if (moved) {
+				titania_gesture_queue_pair(hid_state, TITANIA_GESTURE_PINCH, TITANIA_GESTURE_PHASE_UPDATE, delta);
+			}
+			break;
+		default: break;
+	}
+}
+
+// every finger has lifted, taps and swipes are only known now.
+static void titania_gesture_release(dualsense_state* hid_state, const titania_gesture_finger* finger) {
+	const titania_gesture_state* gesture = &hid_state->gesture;
+	if (gesture->mode != TITANIA_GESTURE_MODE_PENDING) {
+		return;
+	}
+
+	titania_gesture_event event = {
+		.sensor_time = gesture->sensor_time,
+		.phase = TITANIA_GESTURE_PHASE_END,
+		.fingers = gesture->max_fingers,
+		.position = { { finger->last[0] }, { finger->last[1] } },
+		.delta = { { finger->last[0] - finger->start[0] }, { finger->last[1] - finger->start[1] } },
+		.velocity = { { finger->velocity[0] }, { finger->velocity[1] } },
+	};
+
+	if (gesture->max_fingers > 1) {
+		event.position = (titania_vector2) { { gesture->pair_last[0] }, { gesture->pair_last[1] } };
+		event.delta = (titania_vector2) { { gesture->pair_last[0] - gesture->pair_start[0] }, { gesture->pair_last[1] - gesture->pair_start[1] } };
+	}
+
+	if (gesture->travel <= TITANIA_GESTURE_TAP_SLOP * TITANIA_GESTURE_TAP_SLOP && gesture->sensor_time - gesture->touch_time <= TITANIA_GESTURE_TAP_TICKS) {
+		event.type = TITANIA_GESTURE_TAP;
+		titania_gesture_queue(hid_state, &event);
+		return;
+	}
+
+	const float distance = event.delta.x * event.delta.x + event.delta.y * event.delta.y;
+	const float speed = event.velocity.x * event.velocity.x + event.velocity.y * event.velocity.y;
+	if (gesture->max_fingers == 1 && distance >= TITANIA_GESTURE_SWIPE_DISTANCE * TITANIA_GESTURE_SWIPE_DISTANCE && speed >= TITANIA_GESTURE_SWIPE_SPEED * TITANIA_GESTURE_SWIPE_SPEED) {
+		event.type = TITANIA_GESTURE_SWIPE;
+		titania_gesture_queue(hid_state, &event);
+	}
+}
+
+void titania_gesture_update(dualsense_state* hid_state) {
+	if (!hid_state->pipeline->gesture.enabled) {
+		return;
+	}
+
+	titania_gesture_state* gesture = &hid_state->gesture;
+	// the touchpad samples slower than the report rate, in between the report repeats the last sample.
+	const uint8_t* report = hid_state->input.data.msg.buffer;
+	const uint8_t sequence = report[TITANIA_DECODE_TOUCH_SEQUENCE];
+	if (gesture->has_sample && sequence == gesture->sequence && memcmp(gesture->touch, report + TITANIA_DECODE_TOUCH, sizeof(gesture->touch)) == 0) {
+		return;
+	}
+
+	const uint32_t sensor_time = hid_state->input.data.msg.data.sensors.time;
+	// the sensor clock wraps every 24 minutes, unsigned subtraction absorbs it.
+	const float dt = gesture->has_sample ? (float) (sensor_time - gesture->sensor_time) / DUALSENSE_SENSOR_TICKS_PER_SECOND : 0.0f;
+	const float rate = dt > 0.0f && dt <= TITANIA_GESTURE_MAX_STEP ? 1.0f / dt : 0.0f;
+	memcpy(gesture->touch, report + TITANIA_DECODE_TOUCH, sizeof(gesture->touch));
+	gesture->sequence = sequence;
+	gesture->sensor_time = sensor_time;
+	gesture->has_sample = true;
+
+	int before = 0;
+	int after = 0;
+	int lifted = -1;
+	for (int i = 0; i < 2; ++i) {
+		titania_touchpad touch;
+		titania_decode_touch(report + TITANIA_DECODE_TOUCH + i * 4, &touch);
+		titania_gesture_finger* finger = &gesture->fingers[i];
+		const float position[2] = { (float) touch.pos.x, (float) touch.pos.y };
+		before += finger->active;
+
+		// a new id in the same slot is one finger lifting and another landing.
+		if (finger->active && (!touch.active || touch.id != finger->id)) {
+			finger->active = false;
+			lifted = i;
+		}
+
+		if (!touch.active) {
+			continue;
+		}
+
+		if (!finger->active) {
+			*finger = (titania_gesture_finger) { .id = (uint8_t) touch.id, .active = true };
+			for (int j = 0; j < 2; ++j) {
+				finger->start[j] = position[j];
+				finger->last[j] = position[j];
+			}
+		} else {
+			for (int j = 0; j < 2; ++j) {
+				if (rate > 0.0f) {
+					finger->velocity[j] += TITANIA_GESTURE_VELOCITY_WEIGHT * ((position[j] - finger->last[j]) * rate - finger->velocity[j]);
+				}
+
+				finger->last[j] = position[j];
+			}
+
+			const float travel = (position[0] - finger->start[0]) * (position[0] - finger->start[0]) + (position[1] - finger->start[1]) * (position[1] - finger->start[1]);
+			finger->travel = fmaxf(finger->travel, travel);
+		}
+
+		after++;
+	}
+
+	if (before == 0 && after > 0) {
+		gesture->mode = TITANIA_GESTURE_MODE_PENDING;
+		gesture->touch_time = sensor_time;
+		gesture->max_fingers = 0;
+		gesture->travel = 0.0f;
+	}
+
+	if (after > gesture->max_fingers) {
+		gesture->max_fingers = (uint8_t) after;
+	}
+
+	for (int i = 0; i < 2; ++i) {
+		if (gesture->fingers[i].active) {
+			gesture->travel = fmaxf(gesture->travel, gesture->fingers[i].travel);
+		}
+	}
+
+	if (after == 2) {
+		titania_gesture_update_pair(hid_state, rate);
+	} else if (gesture->has_pair) {
+		gesture->has_pair = false;
+		if (gesture->mode == TITANIA_GESTURE_MODE_SCROLL || gesture->mode == TITANIA_GESTURE_MODE_PINCH) {
+			const float none[2] = { 0.0f, 0.0f };
+			titania_gesture_queue_pair(hid_state, gesture->mode == TITANIA_GESTURE_MODE_SCROLL ? TITANIA_GESTURE_SCROLL : TITANIA_GESTURE_PINCH, TITANIA_GESTURE_PHASE_END, none);
+			gesture->mode = TITANIA_GESTURE_MODE_DONE;
+		}
+	}
+
+	if (before > 0 && after == 0) {
+		if (lifted >= 0) {
+			titania_gesture_release(hid_state, &gesture->fingers[lifted]);
+		}
+
+		gesture->mode = TITANIA_GESTURE_MODE_IDLE;
+	}
+}
+
+static titania_error titania_set_gestures_impl(titania_context* ctx, const titania_handle handle, const bool enabled) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	if (hid_state->hid_info.is_access) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	LOCK_INFO(hid_state);
+	titania_pipeline* pipeline = titania_pipeline_edit(hid_state);
+	if (pipeline == nullptr) {
+		UNLOCK_INFO(hid_state);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	pipeline->gesture.enabled = enabled;
+	pipeline->gesture.generation++;
+	titania_pipeline_publish(hid_state, pipeline);
+	UNLOCK_INFO(hid_state);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_set_gestures(titania_context* ctx, const titania_handle handle, const bool enabled) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_set_gestures_impl(ctx, handle, enabled);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_get_gestures_impl(titania_context* ctx, const titania_handle handle, titania_gesture_event* events, const size_t count, size_t* written) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	const unsigned int head = atomic_load_explicit(&hid_state->gesture_head, memory_order_acquire);
+	unsigned int tail = atomic_load_explicit(&hid_state->gesture_tail, memory_order_relaxed);
+	size_t n = 0;
+	while (n < count && tail != head) {
+		events[n++] = hid_state->gestures[tail & (TITANIA_GESTURE_QUEUE_SIZE - 1)];
+		tail++;
+	}
+
+	atomic_store_explicit(&hid_state->gesture_tail, tail, memory_order_release);
+	*written = n;
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_get_gestures(titania_context* ctx, const titania_handle handle, titania_gesture_event* events, const size_t count, size_t* written) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if ((events == nullptr && count > 0) || written == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_get_gestures_impl(ctx, handle, events, count, written);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
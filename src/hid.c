@@ -3,21 +3,15 @@
 //  SPDX-License-Identifier: MPL-2.0
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "structures.h"
 
 #include <titania_config.h>
 
-#ifdef __APPLE__
-#include <hidapi_darwin.h>
-#endif
-
 const int32_t titania_max_controllers = TITANIA_MAX_CONTROLLERS;
 
-dualsense_state state[TITANIA_MAX_CONTROLLERS];
-bool is_initialized = false;
-
 static titania_device_info device_infos[] = {
 	{ 0x054C, 0x0CE6 }, // DualSense
 	{ 0x054C, 0x0CE7 }, // DualSense Prototype (who even has this?)
@@ -26,279 +20,807 @@ static titania_device_info device_infos[] = {
 };
 
 #define COPY_VERSION_HARDWARE(name) \
-	handle->firmware.name.reserved = firmware.name.hardware.reserved; \
-	handle->firmware.name.variation = firmware.name.hardware.variation; \
-	handle->firmware.name.generation = firmware.name.hardware.generation; \
-	handle->firmware.name.revision = firmware.name.hardware.revision
+	info->name.reserved = firmware.name.hardware.reserved; \
+	info->name.variation = firmware.name.hardware.variation; \
+	info->name.generation = firmware.name.hardware.generation; \
+	info->name.revision = firmware.name.hardware.revision
 
 #define COPY_VERSION_UPDATE(name) \
-	handle->firmware.name.major = firmware.name.update.major; \
-	handle->firmware.name.minor = firmware.name.update.minor; \
-	handle->firmware.name.revision = firmware.name.update.revision
+	info->name.major = firmware.name.update.major; \
+	info->name.minor = firmware.name.update.minor; \
+	info->name.revision = firmware.name.update.revision
 
 #define COPY_VERSION_FIRMWARE(name) \
-	handle->firmware.name.major = firmware.name.firmware.major; \
-	handle->firmware.name.minor = firmware.name.firmware.minor; \
-	handle->firmware.name.revision = firmware.name.firmware.revision
+	info->name.major = firmware.name.firmware.major; \
+	info->name.minor = firmware.name.firmware.minor; \
+	info->name.revision = firmware.name.firmware.revision
 
 #define ARR_LEN(arr) sizeof(arr) / sizeof(*arr)
 
-titania_error titania_init_checked(const size_t size) {
-	if (size != sizeof(titania_hid)) {
-		return TITANIA_ERROR_INVALID_LIBRARY;
+bool titania_is_supported_device(const uint16_t vendor_id, const uint16_t product_id) {
+	for (size_t i = 0; i < ARR_LEN(device_infos); i++) {
+		if (device_infos[i].vendor_id == vendor_id && device_infos[i].product_id == product_id) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+titania_error titania_get_hids(titania_query* hids, const size_t hids_length) {
+	if (!titania_is_hidapi_initialized()) {
+		return TITANIA_ERROR_NOT_INITIALIZED;
 	}
 
-	if (is_initialized) {
+	if (hids_length == 0) {
 		return TITANIA_ERROR_OK;
 	}
 
-	if (hid_init() != 0) {
-		return TITANIA_ERROR_HIDAPI_FAIL;
+	for (size_t i = 0; i < hids_length; i++) {
+		hids[i].hid_serial[0] = 0;
+		hids[i].hid_path[0] = 0;
 	}
 
-#ifdef __APPLE__
-	hid_darwin_set_open_exclusive(0);
-#endif
+	size_t index = 0;
+
+	// every supported device is Sony's, so one enumeration filtered by product id replaces one per device_infos entry.
+	struct hid_device_info* root = hid_enumerate(0x054C, 0);
+	const struct hid_device_info* dev = root;
+	while (dev && index < hids_length) {
+		if (dev->serial_number != nullptr && wcslen(dev->serial_number) >= 0x100) {
+			hid_free_enumeration(root);
+			return TITANIA_ERROR_INVALID_DATA;
+		}
+
+		if (strlen(dev->path) >= 0x200) {
+			hid_free_enumeration(root);
+			return TITANIA_ERROR_INVALID_DATA;
+		}
 
-	memset(&state, 0, sizeof(state));
+		if ((dev->bus_type == HID_API_BUS_USB || dev->bus_type == HID_API_BUS_BLUETOOTH) && titania_is_supported_device(dev->vendor_id, dev->product_id)) {
+			hids[index].product_id = dev->product_id;
+			hids[index].vendor_id = dev->vendor_id;
+			hids[index].is_bluetooth = dev->bus_type == HID_API_BUS_BLUETOOTH;
+			hids[index].is_edge = IS_EDGE(hids[index]);
+			hids[index].is_access = IS_ACCESS(hids[index]);
+			if (dev->serial_number != nullptr) {
+				wcscpy(hids[index].hid_serial, dev->serial_number);
+			}
+			strcpy(hids[index].hid_path, dev->path);
 
-	titania_init_checksum();
+			index += 1;
+		}
+
+		dev = dev->next;
+	}
+	hid_free_enumeration(root);
 
-	is_initialized = true;
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_get_hids(titania_query* hids, const size_t hids_length) {
-	CHECK_INIT();
+#define CALIBRATE_ACCEL(slot) DUALSENSE_ACCELEROMETER_RESOLUTION / (DUALSENSE_ACCELEROMETER_RESOLUTION * DUALSENSE_ACCELEROMETER_SENSITIVITY) * (9.80665f)
 
-	if (hids_length == 0) {
-		return TITANIA_ERROR_OK;
+#define CALIBRATE_GYRO(slot) DUALSENSE_GYRO_RESOLUTION / (DUALSENSE_GYRO_RESOLUTION * DUALSENSE_GYRO_SENSITIVITY) * (360.0f / calibration_bits[slot].speed)
+
+// clears a slot, leaving the lifecycle word alone as other threads may still be probing it.
+static void titania_reset_slot(dualsense_state* slot) {
+#ifdef TITANIA_THREAD_SAFE
+	memset(&slot->input, 0, sizeof(dualsense_state) - offsetof(dualsense_state, input));
+	atomic_flag_clear(&slot->output_lock);
+	atomic_flag_clear(&slot->info_lock);
+	atomic_flag_clear(&slot->is_reconnecting);
+#else
+	memset(slot, 0, sizeof(dualsense_state));
+#endif
+}
+
+// snapshot the pending output report and reset its one-shot flags, then write the snapshot.
+// the write happens outside of the output lock so updates from other threads are never blocked by hid i/o.
+static bool titania_push_impl(dualsense_state* hid_state) {
+	LOCK_OUTPUT(hid_state);
+	if (!hid_state->hid_info.is_access) { // this likely exists on access as well, idk where yet.
+		// held pushes stay in the pending report, the next write carries all of them.
+		if (titania_ack_hold(hid_state)) {
+			UNLOCK_OUTPUT(hid_state);
+			return true;
+		}
+
+		hid_state->output.data.msg.data.state_id = ++hid_state->seq;
+		titania_ack_sent(hid_state, hid_state->seq);
 	}
 
-	for (size_t i = 0; i < hids_length; i++) {
-		hids[i].hid_serial[0] = 0;
-		hids[i].hid_path[0] = 0;
+	dualsense_state_output output = hid_state->output;
+	const uint32_t seq = hid_state->seq;
+
+	hid_state->replay_flags |= hid_state->output.data.msg.data.flags.value;
+	hid_state->replay_edge_flags |= hid_state->output.data.msg.data.edge.flags.value;
+	hid_state->output.data.msg.data.flags.value = 0;
+	const bool edge_enable = hid_state->output.data.msg.data.edge.flags.enable_switching;
+	hid_state->output.data.msg.data.edge.flags.value = 0;
+	hid_state->output.data.msg.data.edge.flags.enable_switching = edge_enable;
+	UNLOCK_OUTPUT(hid_state);
+
+	const uint8_t* buffer = output.buffer;
+	size_t size = sizeof(dualsense_output_msg_ex);
+	if (!hid_state->hid_info.is_bluetooth) {
+		buffer = output.data.msg.buffer;
+		size = sizeof(dualsense_output_msg);
+		// Regular: 48 bytes, Edge: 64 bytes, Access: 32 bytes.
+		// why.
+		if (hid_state->hid_info.is_access) {
+			size -= 0x20;
+		} else if (!hid_state->hid_info.is_edge) {
+			size -= 0x10;
+		}
+	} else {
+		output.data.msg.data.report_id = 0;
+		output.data.msg.data.bt.enable_hid = true;
+		output.data.msg.data.bt.seq = seq & 0xF;
+		output.data.bt_checksum = titania_calc_checksum(crc_seed_output, buffer, size - 4);
 	}
 
-	size_t index = 0;
+	return HID_PASS(hid_write(hid_state->hid, buffer, size));
+}
 
-	for (size_t i = 0; i < ARR_LEN(device_infos); i++) {
-		if (index >= hids_length) {
-			break;
+static bool titania_fetch_firmware(hid_device* hid, titania_firmware_info* info) {
+	dualsense_firmware_info firmware;
+	firmware.report_id = DUALSENSE_REPORT_FIRMWARE;
+	if (HID_FAIL(hid_get_feature_report(hid, (uint8_t*) &firmware, sizeof(dualsense_firmware_info)))) {
+		info->datetime[0] = 0;
+		return false;
+	}
+
+	memset(info, 0, sizeof(titania_firmware_info));
+	memcpy(info->datetime, firmware.date, sizeof(firmware.date));
+	info->datetime[sizeof(firmware.date)] = ' ';
+	memcpy(info->datetime + sizeof(firmware.date) + 1, firmware.time, sizeof(firmware.time));
+	info->datetime[sizeof(info->datetime) - 1] = 0;
+
+	info->type = firmware.type;
+	info->series = firmware.series;
+	COPY_VERSION_HARDWARE(hardware);
+	COPY_VERSION_UPDATE(update);
+	COPY_VERSION_FIRMWARE(firmware);
+	COPY_VERSION_FIRMWARE(firmware2);
+	COPY_VERSION_FIRMWARE(firmware3);
+	COPY_VERSION_FIRMWARE(device);
+	COPY_VERSION_FIRMWARE(device2);
+	COPY_VERSION_FIRMWARE(device3);
+	COPY_VERSION_FIRMWARE(mcu_firmware);
+	return true;
+}
+
+static bool titania_fetch_serial(hid_device* hid, titania_serial_info* info) {
+	dualsense_serial_info serial;
+	serial.report_id = DUALSENSE_REPORT_SERIAL;
+	if (HID_FAIL(hid_get_feature_report(hid, (uint8_t*) &serial, sizeof(dualsense_serial_info)))) {
+		info->mac[0] = 0;
+		info->paired_mac[0] = 0;
+		return false;
+	}
+
+	memset(info, 0, sizeof(titania_serial_info));
+	sprintf(info->mac, "%02x:%02x:%02x:%02x:%02x:%02x", serial.device_mac[5], serial.device_mac[4], serial.device_mac[3], serial.device_mac[2], serial.device_mac[1], serial.device_mac[0]);
+	sprintf(info->paired_mac, "%02x:%02x:%02x:%02x:%02x:%02x", serial.pair_mac[5], serial.pair_mac[4], serial.pair_mac[3], serial.pair_mac[2], serial.pair_mac[1], serial.pair_mac[0]);
+	info->mac[sizeof(info->mac) - 1] = 0;
+	info->paired_mac[sizeof(info->paired_mac) - 1] = 0;
+	info->unknown = (uint64_t) serial.unknown[0] << 16 | (uint64_t) serial.unknown[1] << 8 | (uint64_t) serial.unknown[2];
+	return true;
+}
+
+// computes the conversion scales from a calibration report, or the default coefficients if calibration is nullptr.
+static void titania_compute_calibration(titania_calibration_scale scale[6], const dualsense_calibration_info* calibration) {
+	titania_calibration_bit calibration_bits[6];
+	if (calibration != nullptr) {
+		calibration_bits[CALIBRATION_GYRO_X].max = calibration->gyro[CALIBRATION_RAW_X].max / (float) INT16_MAX;
+		calibration_bits[CALIBRATION_GYRO_Y].max = calibration->gyro[CALIBRATION_RAW_Y].max / (float) INT16_MAX;
+		calibration_bits[CALIBRATION_GYRO_Z].max = calibration->gyro[CALIBRATION_RAW_Z].max / (float) INT16_MAX;
+
+		calibration_bits[CALIBRATION_GYRO_X].min = calibration->gyro[CALIBRATION_RAW_X].min / (float) INT16_MAX;
+		calibration_bits[CALIBRATION_GYRO_Y].min = calibration->gyro[CALIBRATION_RAW_Y].min / (float) INT16_MAX;
+		calibration_bits[CALIBRATION_GYRO_Z].min = calibration->gyro[CALIBRATION_RAW_Z].min / (float) INT16_MAX;
+
+		calibration_bits[CALIBRATION_GYRO_X].bias = calibration->gyro_bias.x;
+		calibration_bits[CALIBRATION_GYRO_Y].bias = calibration->gyro_bias.y;
+		calibration_bits[CALIBRATION_GYRO_Z].bias = calibration->gyro_bias.z;
+
+		calibration_bits[CALIBRATION_GYRO_X].speed = calibration->gyro_speed.min;
+		calibration_bits[CALIBRATION_GYRO_Y].speed = calibration->gyro_speed.min;
+		calibration_bits[CALIBRATION_GYRO_Z].speed = calibration->gyro_speed.min;
+
+		calibration_bits[CALIBRATION_ACCELEROMETER_X].max = calibration->accelerometer[CALIBRATION_RAW_X].max / (float) INT16_MAX;
+		calibration_bits[CALIBRATION_ACCELEROMETER_Y].max = calibration->accelerometer[CALIBRATION_RAW_Y].max / (float) INT16_MAX;
+		calibration_bits[CALIBRATION_ACCELEROMETER_Z].max = calibration->accelerometer[CALIBRATION_RAW_Z].max / (float) INT16_MAX;
+
+		calibration_bits[CALIBRATION_ACCELEROMETER_X].min = calibration->accelerometer[CALIBRATION_RAW_X].min / (float) INT16_MAX;
+		calibration_bits[CALIBRATION_ACCELEROMETER_Y].min = calibration->accelerometer[CALIBRATION_RAW_Y].min / (float) INT16_MAX;
+		calibration_bits[CALIBRATION_ACCELEROMETER_Z].min = calibration->accelerometer[CALIBRATION_RAW_Z].min / (float) INT16_MAX;
+
+		calibration_bits[CALIBRATION_ACCELEROMETER_X].bias = 0;
+		calibration_bits[CALIBRATION_ACCELEROMETER_Y].bias = 0;
+		calibration_bits[CALIBRATION_ACCELEROMETER_Z].bias = 0;
+
+		calibration_bits[CALIBRATION_ACCELEROMETER_X].speed = 4;
+		calibration_bits[CALIBRATION_ACCELEROMETER_Y].speed = 4;
+		calibration_bits[CALIBRATION_ACCELEROMETER_Z].speed = 4;
+	} else {
+		calibration_bits[CALIBRATION_GYRO_X] = (titania_calibration_bit) { .max = DUALSENSE_GYRO_BASE, .min = -DUALSENSE_GYRO_BASE, .speed = 540 };
+		calibration_bits[CALIBRATION_GYRO_Y] = (titania_calibration_bit) { .max = DUALSENSE_GYRO_BASE, .min = -DUALSENSE_GYRO_BASE, .speed = 540 };
+		calibration_bits[CALIBRATION_GYRO_Z] = (titania_calibration_bit) { .max = DUALSENSE_GYRO_BASE, .min = -DUALSENSE_GYRO_BASE, .speed = 540 };
+		calibration_bits[CALIBRATION_ACCELEROMETER_X] = (titania_calibration_bit) { .max = DUALSENSE_ACCELEROMETER_BASE, .min = -DUALSENSE_ACCELEROMETER_BASE, .speed = 4 };
+		calibration_bits[CALIBRATION_ACCELEROMETER_Y] = (titania_calibration_bit) { .max = DUALSENSE_ACCELEROMETER_BASE, .min = -DUALSENSE_ACCELEROMETER_BASE, .speed = 4 };
+		calibration_bits[CALIBRATION_ACCELEROMETER_Z] = (titania_calibration_bit) { .max = DUALSENSE_ACCELEROMETER_BASE, .min = -DUALSENSE_ACCELEROMETER_BASE, .speed = 4 };
+	}
+
+	calibration_bits[CALIBRATION_GYRO_X].cache = CALIBRATE_GYRO(CALIBRATION_GYRO_X);
+	calibration_bits[CALIBRATION_GYRO_Y].cache = CALIBRATE_GYRO(CALIBRATION_GYRO_Y);
+	calibration_bits[CALIBRATION_GYRO_Z].cache = CALIBRATE_GYRO(CALIBRATION_GYRO_Z);
+	calibration_bits[CALIBRATION_ACCELEROMETER_X].cache = CALIBRATE_ACCEL(CALIBRATION_ACCELEROMETER_X);
+	calibration_bits[CALIBRATION_ACCELEROMETER_Y].cache = CALIBRATE_ACCEL(CALIBRATION_ACCELEROMETER_Y);
+	calibration_bits[CALIBRATION_ACCELEROMETER_Z].cache = CALIBRATE_ACCEL(CALIBRATION_ACCELEROMETER_Z);
+
+	// fold the per-sign range and the resolution into one multiplier so conversion is a single multiply.
+	for (int j = 0; j < 6; ++j) {
+		scale[j].scale[0] = calibration_bits[j].max * calibration_bits[j].cache;
+		scale[j].scale[1] = calibration_bits[j].min * calibration_bits[j].cache;
+		scale[j].bias = calibration_bits[j].bias;
+	}
+}
+
+static bool titania_fetch_calibration(hid_device* hid, titania_calibration_scale scale[6]) {
+	dualsense_calibration_info calibration;
+	calibration.report_id = DUALSENSE_REPORT_CALIBRATION;
+	if (HID_FAIL(hid_get_feature_report(hid, (uint8_t*) &calibration, sizeof(dualsense_calibration_info)))) {
+		return false;
+	}
+
+	titania_compute_calibration(scale, &calibration);
+	return true;
+}
+
+// hands firmware and serial found after open to the getters, and to pull through the pipeline for titania_data hid.
+static void titania_store_info(dualsense_state* hid_state, const titania_firmware_info* firmware, const titania_serial_info* serial) {
+	LOCK_INFO(hid_state);
+	titania_pipeline* staging = &hid_state->pipeline_staging;
+	if (firmware != nullptr) {
+		hid_state->firmware = *firmware;
+		hid_state->has_firmware = true;
+		staging->firmware = *firmware;
+		staging->has_firmware = true;
+	}
+
+	if (serial != nullptr) {
+		hid_state->serial = *serial;
+		hid_state->has_serial = true;
+		staging->serial = *serial;
+		staging->has_serial = true;
+	}
+
+	// out of memory, the staged copy still carries it to pull with the next setter.
+	titania_pipeline* pipeline = titania_pipeline_edit(hid_state);
+	if (pipeline != nullptr) {
+		titania_pipeline_publish(hid_state, pipeline);
+	}
+	UNLOCK_INFO(hid_state);
+}
+
+// runs on its own thread after open. fetches calibration and firmware and refreshes the cache entry, or, if the controller
+// was opened from the cache, re-reads the firmware version and only refreshes everything when it changed.
+// firmware is fetched even without a cache since the rumble mode depends on it.
+// calibration is handed to the pulling thread through the pending bits, firmware and serial through titania_store_info.
+static void titania_background_worker(void* userdata) {
+	dualsense_state* hid_state = userdata;
+	titania_firmware_info firmware;
+	memset(&firmware, 0, sizeof(titania_firmware_info));
+	bool has_firmware = false;
+	if (hid_state->is_cached) {
+		has_firmware = titania_fetch_firmware(hid_state->hid, &firmware);
+		if (!has_firmware) {
+			return;
 		}
 
-		const titania_device_info info = device_infos[i];
+		LOCK_INFO(hid_state);
+		const bool is_current = memcmp(&firmware, &hid_state->firmware, sizeof(titania_firmware_info)) == 0;
+		UNLOCK_INFO(hid_state);
+		if (is_current) {
+			return;
+		}
+	}
 
-		struct hid_device_info* root = hid_enumerate(info.vendor_id, info.product_id);
-		const struct hid_device_info* dev = root;
-		while (dev) {
-			if (wcslen(dev->serial_number) >= 0x100) {
-				hid_free_enumeration(root);
-				return TITANIA_ERROR_INVALID_DATA;
-			}
+	titania_cache_entry entry;
+	memset(&entry, 0, sizeof(titania_cache_entry));
+	if (hid_state->use_calibration && !hid_state->hid_info.is_access) {
+		entry.has_calibration = titania_fetch_calibration(hid_state->hid, hid_state->pending_calibration);
+		if (entry.has_calibration) {
+			memcpy(entry.calibration, hid_state->pending_calibration, sizeof(entry.calibration));
+			atomic_fetch_or_explicit(&hid_state->pending, TITANIA_PENDING_CALIBRATION, memory_order_release);
+		}
+	}
 
-			if (strlen(dev->path) >= 0x200) {
-				hid_free_enumeration(root);
-				return TITANIA_ERROR_INVALID_DATA;
-			}
+	if (!has_firmware) {
+		has_firmware = titania_fetch_firmware(hid_state->hid, &firmware);
+		if (!has_firmware) {
+			return;
+		}
+	}
 
-			if (dev->bus_type == HID_API_BUS_USB || dev->bus_type == HID_API_BUS_BLUETOOTH) {
-				hids[index].product_id = dev->product_id;
-				hids[index].vendor_id = dev->vendor_id;
-				hids[index].is_bluetooth = dev->bus_type == HID_API_BUS_BLUETOOTH;
-				hids[index].is_edge = IS_EDGE(hids[index]);
-				hids[index].is_access = IS_ACCESS(hids[index]);
-				wcscpy(hids[index].hid_serial, dev->serial_number);
-				strcpy(hids[index].hid_path, dev->path);
+	if (hid_state->cache == nullptr || hid_state->cache_key[0] == 0 || !titania_fetch_serial(hid_state->hid, &entry.serial)) {
+		titania_store_info(hid_state, &firmware, nullptr);
+		return;
+	}
 
-				index += 1;
+	entry.firmware = firmware;
+	titania_store_info(hid_state, &firmware, &entry.serial);
 
-				if (index >= hids_length) {
-					break;
-				}
+	titania_cache_store(hid_state->cache, hid_state->cache_key, &entry);
+}
+
+// swap in the calibration the background worker fetched, only the thread that pulls a handle touches calibration.
+static void titania_apply_pending(dualsense_state* hid_state) {
+	const unsigned int pending = atomic_exchange_explicit(&hid_state->pending, 0, memory_order_acquire);
+	if (pending & TITANIA_PENDING_CALIBRATION) {
+		memcpy(hid_state->calibration, hid_state->pending_calibration, sizeof(hid_state->calibration));
+		titania_compute_calibration_fixed(hid_state->calibration, hid_state->calibration_fixed);
+		// a learned gyro bias is put back on the next report, this only matters once tracking stops.
+		for (int j = 0; j < 3; ++j) {
+			hid_state->bias.calibration_bias[j] = hid_state->calibration[j].bias;
+		}
+	}
+}
+
+static titania_error titania_update_led_impl(titania_context* ctx, const titania_handle handle, const titania_led_update data);
+
+// opens a device into a slot that has already been reserved by the caller.
+// when lazy is set firmware and serial info are left for titania_get_firmware and titania_get_serial,
+// and calibration is fetched on a background thread while the default coefficients are used.
+static titania_error titania_open_slot(titania_context* ctx, const int i, const titania_hid_path path, const bool is_bluetooth, titania_hid* handle, const bool use_calibration, const bool blocking, const bool lazy) {
+	titania_reset_slot(&ctx->state[i]);
+	handle->handle = i;
+	ctx->state[i].hid = hid_open_path(path);
+	if (ctx->state[i].hid == nullptr) {
+		FREE_HANDLE(ctx, i);
+		return TITANIA_ERROR_HIDAPI_FAIL;
+	}
+
+	hid_set_nonblocking(ctx->state[i].hid, !blocking);
+	struct hid_device_info* info = hid_get_device_info(ctx->state[i].hid);
+	if (info != nullptr) {
+		handle->product_id = info->product_id;
+		handle->vendor_id = info->vendor_id;
+	} else {
+		handle->product_id = 0x0CE6; // DualSense
+		handle->vendor_id = 0x054C; // Sony
+	}
+	handle->is_bluetooth = is_bluetooth;
+	handle->is_edge = IS_EDGE((*handle));
+	handle->is_access = IS_ACCESS((*handle));
+	ctx->state[i].hid_info = *handle;
+	ctx->state[i].output.data.report_id = DUALSENSE_REPORT_BLUETOOTH;
+	ctx->state[i].output.data.msg.data.report_id = DUALSENSE_REPORT_OUTPUT;
+
+	if (ctx->state[i].hid_info.is_bluetooth) { // this is needed to reset LEDs from controller firmware
+		if (IS_ACCESS(ctx->state[i].hid_info)) {
+			ctx->state[i].output.data.msg.access.flags.reset_led = true;
+		} else {
+			ctx->state[i].output.data.msg.data.flags.reset_led = true;
+		}
+
+		titania_push_impl(&ctx->state[i]);
+	}
+
+	dualsense_state* hid_state = &ctx->state[i];
+	hid_state->use_calibration = use_calibration;
+	hid_state->blocking = blocking;
+	if (!hid_state->hid_info.is_access) {
+		titania_compute_calibration(hid_state->calibration, nullptr);
+	}
+
+	titania_cache_entry entry;
+	bool has_entry = false;
+	// the key doubles as the identity used to find the controller again after a reconnect.
+	if (info != nullptr && titania_cache_key(info->serial_number, hid_state->cache_key) && ctx->cache.map != nullptr) {
+		hid_state->cache = &ctx->cache;
+		has_entry = titania_cache_lookup(&ctx->cache, hid_state->cache_key, &entry);
+	}
+
+	const bool wants_calibration = use_calibration && !hid_state->hid_info.is_access;
+	if (has_entry) {
+		handle->firmware = entry.firmware;
+		handle->serial = entry.serial;
+		hid_state->has_firmware = true;
+		hid_state->has_serial = true;
+		if (wants_calibration && entry.has_calibration) {
+			memcpy(hid_state->calibration, entry.calibration, sizeof(hid_state->calibration));
+		}
+
+		hid_state->is_cached = !wants_calibration || entry.has_calibration;
+	} else if (lazy) {
+		memset(&handle->firmware, 0, sizeof(handle->firmware));
+		memset(&handle->serial, 0, sizeof(handle->serial));
+	} else {
+		hid_state->has_firmware = titania_fetch_firmware(hid_state->hid, &handle->firmware);
+		hid_state->has_serial = titania_fetch_serial(hid_state->hid, &handle->serial);
+		if (wants_calibration) {
+			memset(&entry, 0, sizeof(titania_cache_entry));
+			entry.has_calibration = titania_fetch_calibration(hid_state->hid, hid_state->calibration);
+			memcpy(entry.calibration, hid_state->calibration, sizeof(entry.calibration));
+		}
+
+		if (hid_state->cache != nullptr && hid_state->has_firmware && hid_state->has_serial && (!wants_calibration || entry.has_calibration)) {
+			if (!wants_calibration) {
+				memset(&entry, 0, sizeof(titania_cache_entry));
 			}
 
-			dev = dev->next;
+			entry.firmware = handle->firmware;
+			entry.serial = handle->serial;
+			titania_cache_store(hid_state->cache, hid_state->cache_key, &entry);
 		}
-		hid_free_enumeration(root);
 	}
 
+	hid_state->hid_info = *handle;
+	hid_state->firmware = handle->firmware;
+	hid_state->serial = handle->serial;
+	hid_state->decode = titania_select_decoder(handle->is_edge, handle->is_access, handle->is_bluetooth);
+	titania_compute_calibration_fixed(hid_state->calibration, hid_state->calibration_fixed);
+	titania_pipeline_init(hid_state);
+
+	// warm and lazy opens leave the feature reports to a background thread, if it can't start it runs here instead.
+	// lazy opens always need it, the rumble mode depends on the firmware version.
+	if (has_entry || lazy) {
+		hid_state->has_background_thread = titania_thread_start(&hid_state->background_thread, titania_background_worker, hid_state);
+		if (!hid_state->has_background_thread) {
+			titania_background_worker(hid_state);
+			titania_apply_pending(hid_state);
+			titania_pipeline_update(hid_state);
+			titania_results_publish(hid_state);
+			*handle = hid_state->hid_info;
+		}
+	}
+
+	// this is at the end so it's reasonably late<
+	{
+		titania_led_update update = { 0 };
+		update.color.x = 1.0;
+		update.color.y = 0.0;
+		update.color.z = 1.0;
+		update.led = TITANIA_LED_PLAYER_1;
+		update.access.enable_profile_led = true;
+		update.access.enable_center_led = true;
+		update.access.enable_second_center_led = false;
+		update.access.update_profile = false;
+		titania_update_led_impl(ctx, i, update);
+		titania_push_impl(&ctx->state[i]);
+	}
+
+	PUBLISH_HANDLE(ctx, i);
 	return TITANIA_ERROR_OK;
 }
 
-#define CALIBRATE_ACCEL(slot) DUALSENSE_ACCELEROMETER_RESOLUTION / (DUALSENSE_ACCELEROMETER_RESOLUTION * DUALSENSE_ACCELEROMETER_SENSITIVITY) * (9.80665f)
+titania_error titania_ctx_open(titania_context* ctx, const titania_hid_path path, const bool is_bluetooth, titania_hid* handle, const bool use_calibration, const bool blocking) {
+	CHECK_INIT(ctx);
+
+	for (int i = 0; i < TITANIA_MAX_CONTROLLERS; i++) {
+		if (RESERVE_HANDLE(ctx, i)) {
+			return titania_open_slot(ctx, i, path, is_bluetooth, handle, use_calibration, blocking, false);
+		}
+	}
 
-#define CALIBRATE_GYRO(slot) DUALSENSE_GYRO_RESOLUTION / (DUALSENSE_GYRO_RESOLUTION * DUALSENSE_GYRO_SENSITIVITY) * (360.0f / state[i].calibration[slot].speed)
+	return TITANIA_ERROR_NO_SLOTS;
+}
 
-titania_error titania_open(const titania_hid_path path, const bool is_bluetooth, titania_hid* handle, const bool use_calibration, const bool blocking) {
-	CHECK_INIT();
+typedef struct titania_open_job {
+	titania_context* ctx;
+	int slot;
+	const titania_query* query;
+	titania_hid* handle;
+	bool use_calibration;
+	bool blocking;
+	titania_error result;
+} titania_open_job;
+
+static void titania_open_worker(void* userdata) {
+	titania_open_job* job = userdata;
+	job->result = titania_open_slot(job->ctx, job->slot, job->query->hid_path, job->query->is_bluetooth, job->handle, job->use_calibration, job->blocking, true);
+}
 
-	for (int i = 0; i < TITANIA_MAX_CONTROLLERS; i++) {
-		if (state[i].hid == nullptr) {
-			memset(&state[i], 0, sizeof(dualsense_state));
-			handle->handle = i;
-			state[i].hid = hid_open_path(path);
-			if (state[i].hid == nullptr) {
-				return TITANIA_ERROR_HIDAPI_FAIL;
-			}
+titania_error titania_ctx_open_many(titania_context* ctx, const titania_query* queries, const size_t count, titania_hid* handles, titania_error* results, const bool use_calibration, const bool blocking) {
+	CHECK_INIT(ctx);
 
-			hid_set_nonblocking(state[i].hid, !blocking);
-			struct hid_device_info* info = hid_get_device_info(state[i].hid);
-			if (info != nullptr) {
-				handle->product_id = info->product_id;
-				handle->vendor_id = info->vendor_id;
-			} else {
-				handle->product_id = 0x0CE6; // DualSense
-				handle->vendor_id = 0x054C; // Sony
-			}
-			handle->is_bluetooth = is_bluetooth;
-			state[i].hid_info = *handle;
-			handle->is_edge = IS_EDGE(state[i].hid_info);
-			handle->is_access = IS_ACCESS(state[i].hid_info);
-			state[i].output.data.report_id = DUALSENSE_REPORT_BLUETOOTH;
-			state[i].output.data.msg.data.report_id = DUALSENSE_REPORT_OUTPUT;
-
-			if (state[i].hid_info.is_bluetooth) { // this is needed to reset LEDs from controller firmware
-				if (IS_ACCESS(state[i].hid_info)) {
-					state[i].output.data.msg.access.flags.reset_led = true;
-				} else {
-					state[i].output.data.msg.data.flags.reset_led = true;
-				}
+	if (queries == nullptr || handles == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
 
-				titania_push(&handle->handle, 1);
-			}
+	titania_open_job jobs[TITANIA_MAX_CONTROLLERS];
+	titania_thread threads[TITANIA_MAX_CONTROLLERS];
+	bool started[TITANIA_MAX_CONTROLLERS] = { 0 };
+	size_t job_count = 0;
+
+	// slots are claimed up front on this thread so the workers never race for them.
+	int slot = 0;
+	for (size_t i = 0; i < count; ++i) {
+		handles[i].handle = TITANIA_INVALID_ID;
+		if (results != nullptr) {
+			results[i] = TITANIA_ERROR_NO_SLOTS;
+		}
 
-			dualsense_firmware_info firmware;
-			firmware.report_id = DUALSENSE_REPORT_FIRMWARE;
-			if (HID_PASS(hid_get_feature_report(state[i].hid, (uint8_t*) &firmware, sizeof(dualsense_firmware_info)))) {
-				memset(handle->firmware.datetime, 0, sizeof(handle->firmware.datetime));
-				memcpy(handle->firmware.datetime, firmware.date, sizeof(firmware.date));
-				handle->firmware.datetime[sizeof(firmware.date)] = ' ';
-				memcpy(handle->firmware.datetime + sizeof(firmware.date) + 1, firmware.time, sizeof(firmware.time));
-				handle->firmware.datetime[sizeof(handle->firmware.datetime) - 1] = 0;
-
-				handle->firmware.type = firmware.type;
-				handle->firmware.series = firmware.series;
-				COPY_VERSION_HARDWARE(hardware);
-				COPY_VERSION_UPDATE(update);
-				COPY_VERSION_FIRMWARE(firmware);
-				COPY_VERSION_FIRMWARE(firmware2);
-				COPY_VERSION_FIRMWARE(firmware3);
-				COPY_VERSION_FIRMWARE(device);
-				COPY_VERSION_FIRMWARE(device2);
-				COPY_VERSION_FIRMWARE(device3);
-				COPY_VERSION_FIRMWARE(mcu_firmware);
-			} else {
-				handle->firmware.datetime[0] = 0;
-			}
+		while (slot < TITANIA_MAX_CONTROLLERS && !RESERVE_HANDLE(ctx, slot)) {
+			slot++;
+		}
 
-			dualsense_serial_info serial;
-			serial.report_id = DUALSENSE_REPORT_SERIAL;
-			if (HID_PASS(hid_get_feature_report(state[i].hid, (uint8_t*) &serial, sizeof(dualsense_serial_info)))) {
-				sprintf(handle->serial.mac,
-					"%02x:%02x:%02x:%02x:%02x:%02x",
-					serial.device_mac[5],
-					serial.device_mac[4],
-					serial.device_mac[3],
-					serial.device_mac[2],
-					serial.device_mac[1],
-					serial.device_mac[0]);
-				sprintf(handle->serial.paired_mac,
-					"%02x:%02x:%02x:%02x:%02x:%02x",
-					serial.pair_mac[5],
-					serial.pair_mac[4],
-					serial.pair_mac[3],
-					serial.pair_mac[2],
-					serial.pair_mac[1],
-					serial.pair_mac[0]);
-				handle->serial.mac[sizeof(handle->serial.mac) - 1] = 0;
-				handle->serial.paired_mac[sizeof(handle->serial.paired_mac) - 1] = 0;
-				handle->serial.unknown = (uint64_t) serial.unknown[0] << 16 | (uint64_t) serial.unknown[1] << 8 | (uint64_t) serial.unknown[2];
-			} else {
-				handle->serial.mac[0] = 0;
-				handle->serial.paired_mac[0] = 0;
-			}
+		if (slot >= TITANIA_MAX_CONTROLLERS) {
+			continue;
+		}
 
-			if (!state[i].hid_info.is_access) {
-				dualsense_calibration_info calibration;
-				calibration.report_id = DUALSENSE_REPORT_CALIBRATION;
-				if (use_calibration && HID_PASS(hid_get_feature_report(state[i].hid, (uint8_t*) &calibration, sizeof(dualsense_calibration_info)))) {
-					state[i].calibration[CALIBRATION_GYRO_X].max = calibration.gyro[CALIBRATION_RAW_X].max / (float) INT16_MAX;
-					state[i].calibration[CALIBRATION_GYRO_Y].max = calibration.gyro[CALIBRATION_RAW_Y].max / (float) INT16_MAX;
-					state[i].calibration[CALIBRATION_GYRO_Z].max = calibration.gyro[CALIBRATION_RAW_Z].max / (float) INT16_MAX;
-
-					state[i].calibration[CALIBRATION_GYRO_X].min = calibration.gyro[CALIBRATION_RAW_X].min / (float) INT16_MAX;
-					state[i].calibration[CALIBRATION_GYRO_Y].min = calibration.gyro[CALIBRATION_RAW_Y].min / (float) INT16_MAX;
-					state[i].calibration[CALIBRATION_GYRO_Z].min = calibration.gyro[CALIBRATION_RAW_Z].min / (float) INT16_MAX;
-
-					state[i].calibration[CALIBRATION_GYRO_X].bias = calibration.gyro_bias.x;
-					state[i].calibration[CALIBRATION_GYRO_Y].bias = calibration.gyro_bias.y;
-					state[i].calibration[CALIBRATION_GYRO_Z].bias = calibration.gyro_bias.z;
-
-					state[i].calibration[CALIBRATION_GYRO_X].speed = calibration.gyro_speed.min;
-					state[i].calibration[CALIBRATION_GYRO_Y].speed = calibration.gyro_speed.min;
-					state[i].calibration[CALIBRATION_GYRO_Z].speed = calibration.gyro_speed.min;
-
-					state[i].calibration[CALIBRATION_ACCELEROMETER_X].max = calibration.accelerometer[CALIBRATION_RAW_X].max / (float) INT16_MAX;
-					state[i].calibration[CALIBRATION_ACCELEROMETER_Y].max = calibration.accelerometer[CALIBRATION_RAW_Y].max / (float) INT16_MAX;
-					state[i].calibration[CALIBRATION_ACCELEROMETER_Z].max = calibration.accelerometer[CALIBRATION_RAW_Z].max / (float) INT16_MAX;
-
-					state[i].calibration[CALIBRATION_ACCELEROMETER_X].min = calibration.accelerometer[CALIBRATION_RAW_X].min / (float) INT16_MAX;
-					state[i].calibration[CALIBRATION_ACCELEROMETER_Y].min = calibration.accelerometer[CALIBRATION_RAW_Y].min / (float) INT16_MAX;
-					state[i].calibration[CALIBRATION_ACCELEROMETER_Z].min = calibration.accelerometer[CALIBRATION_RAW_Z].min / (float) INT16_MAX;
-
-					state[i].calibration[CALIBRATION_ACCELEROMETER_X].bias = 0;
-					state[i].calibration[CALIBRATION_ACCELEROMETER_Y].bias = 0;
-					state[i].calibration[CALIBRATION_ACCELEROMETER_Z].bias = 0;
-
-					state[i].calibration[CALIBRATION_ACCELEROMETER_X].speed = 4;
-					state[i].calibration[CALIBRATION_ACCELEROMETER_Y].speed = 4;
-					state[i].calibration[CALIBRATION_ACCELEROMETER_Z].speed = 4;
-				} else {
-					state[i].calibration[CALIBRATION_GYRO_X] = (titania_calibration_bit) { DUALSENSE_GYRO_BASE, -DUALSENSE_GYRO_BASE, 0, 540, 0 };
-					state[i].calibration[CALIBRATION_GYRO_Y] = (titania_calibration_bit) { DUALSENSE_GYRO_BASE, -DUALSENSE_GYRO_BASE, 0, 540, 0 };
-					state[i].calibration[CALIBRATION_GYRO_Z] = (titania_calibration_bit) { DUALSENSE_GYRO_BASE, -DUALSENSE_GYRO_BASE, 0, 540, 0 };
-					state[i].calibration[CALIBRATION_ACCELEROMETER_X] = (titania_calibration_bit) { DUALSENSE_ACCELEROMETER_BASE, -DUALSENSE_ACCELEROMETER_BASE, 0, 4, 0 };
-					state[i].calibration[CALIBRATION_ACCELEROMETER_Y] = (titania_calibration_bit) { DUALSENSE_ACCELEROMETER_BASE, -DUALSENSE_ACCELEROMETER_BASE, 0, 4, 0 };
-					state[i].calibration[CALIBRATION_ACCELEROMETER_Z] = (titania_calibration_bit) { DUALSENSE_ACCELEROMETER_BASE, -DUALSENSE_ACCELEROMETER_BASE, 0, 4, 0 };
-				}
+		jobs[job_count] = (titania_open_job) { ctx, slot++, &queries[i], &handles[i], use_calibration, blocking, TITANIA_ERROR_OK };
+		job_count++;
+	}
 
-				state[i].calibration[CALIBRATION_GYRO_X].cache = CALIBRATE_GYRO(CALIBRATION_GYRO_X);
-				state[i].calibration[CALIBRATION_GYRO_Y].cache = CALIBRATE_GYRO(CALIBRATION_GYRO_Y);
-				state[i].calibration[CALIBRATION_GYRO_Z].cache = CALIBRATE_GYRO(CALIBRATION_GYRO_Z);
-				state[i].calibration[CALIBRATION_ACCELEROMETER_X].cache = CALIBRATE_ACCEL(CALIBRATION_ACCELEROMETER_X);
-				state[i].calibration[CALIBRATION_ACCELEROMETER_Y].cache = CALIBRATE_ACCEL(CALIBRATION_ACCELEROMETER_Y);
-				state[i].calibration[CALIBRATION_ACCELEROMETER_Z].cache = CALIBRATE_ACCEL(CALIBRATION_ACCELEROMETER_Z);
+	for (size_t i = 0; i < job_count; ++i) {
+		started[i] = titania_thread_start(&threads[i], titania_open_worker, &jobs[i]);
+		if (!started[i]) {
+			titania_open_worker(&jobs[i]);
+		}
+	}
+
+	titania_error result = job_count < count ? TITANIA_ERROR_NO_SLOTS : TITANIA_ERROR_OK;
+	for (size_t i = 0; i < job_count; ++i) {
+		if (started[i]) {
+			titania_thread_join(threads[i]);
+		}
+
+		const size_t index = (size_t) (jobs[i].query - queries);
+		if (results != nullptr) {
+			results[index] = jobs[i].result;
+		}
+
+		if (IS_TITANIA_BAD(jobs[i].result)) {
+			handles[index].handle = TITANIA_INVALID_ID;
+			if (IS_TITANIA_OKAY(result)) {
+				result = jobs[i].result;
 			}
+		}
+	}
 
-			state[i].hid_info = *handle;
+	return result;
+}
 
-			// this is at the end so it's reasonably late<
-			{
-				titania_led_update update = { 0 };
-				update.color.x = 1.0;
-				update.color.y = 0.0;
-				update.color.z = 1.0;
-				update.led = TITANIA_LED_PLAYER_1;
-				update.access.enable_profile_led = true;
-				update.access.enable_center_led = true;
-				update.access.enable_second_center_led = false;
-				update.access.update_profile = false;
-				titania_update_led(handle->handle, update);
-				titania_push(&handle->handle, 1);
+static titania_error titania_get_firmware_impl(titania_context* ctx, const titania_handle handle, titania_firmware_info* firmware) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	LOCK_INFO(hid_state);
+	const bool has_firmware = hid_state->has_firmware;
+	if (has_firmware) {
+		*firmware = hid_state->firmware;
+	}
+	UNLOCK_INFO(hid_state);
+
+	if (has_firmware) {
+		return TITANIA_ERROR_OK;
+	}
+
+	titania_firmware_info info;
+	if (!titania_fetch_firmware(hid_state->hid, &info)) {
+		return TITANIA_ERROR_HIDAPI_FAIL;
+	}
+
+	titania_store_info(hid_state, &info, nullptr);
+
+	*firmware = info;
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_get_firmware(titania_context* ctx, const titania_handle handle, titania_firmware_info* firmware) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (firmware == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_get_firmware_impl(ctx, handle, firmware);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_get_serial_impl(titania_context* ctx, const titania_handle handle, titania_serial_info* serial) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	LOCK_INFO(hid_state);
+	const bool has_serial = hid_state->has_serial;
+	if (has_serial) {
+		*serial = hid_state->serial;
+	}
+	UNLOCK_INFO(hid_state);
+
+	if (has_serial) {
+		return TITANIA_ERROR_OK;
+	}
+
+	titania_serial_info info;
+	if (!titania_fetch_serial(hid_state->hid, &info)) {
+		return TITANIA_ERROR_HIDAPI_FAIL;
+	}
+
+	titania_store_info(hid_state, nullptr, &info);
+
+	*serial = info;
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_get_serial(titania_context* ctx, const titania_handle handle, titania_serial_info* serial) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (serial == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_get_serial_impl(ctx, handle, serial);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+#define TITANIA_RECONNECT_INTERVAL (100000000ull) // nanoseconds between looks for a detached controller
+
+// the identity of a controller hidapi has no serial number for, taken from the MAC the controller reports about itself.
+static bool titania_serial_key(const titania_serial_info* serial, char key[TITANIA_CACHE_KEY_SIZE]) {
+	wchar_t mac[sizeof(titania_mac)];
+	for (size_t i = 0; i < sizeof(titania_mac); ++i) {
+		mac[i] = (wchar_t) (unsigned char) serial->mac[i];
+	}
+
+	return titania_cache_key(mac, key);
+}
+
+// open a candidate and compare the MAC it reports, usb on hidraw has no serial number to compare without opening it.
+static hid_device* titania_reconnect_probe(const char* path, const char key[TITANIA_CACHE_KEY_SIZE]) {
+	hid_device* hid = hid_open_path(path);
+	if (hid == nullptr) {
+		return nullptr;
+	}
+
+	titania_serial_info serial;
+	char device_key[TITANIA_CACHE_KEY_SIZE];
+	if (titania_fetch_serial(hid, &serial) && titania_serial_key(&serial, device_key) && memcmp(device_key, key, TITANIA_CACHE_KEY_SIZE) == 0) {
+		return hid;
+	}
+
+	hid_close(hid);
+	return nullptr;
+}
+
+// look for the controller behind a detached handle by its MAC and bind the handle to it again.
+// the caller holds a reference to the handle, the output report (including every flag pushed so far) is replayed.
+static bool titania_reconnect(titania_context* ctx, const titania_handle handle) {
+	dualsense_state* hid_state = &ctx->state[handle];
+
+	// only one thread looks for the controller, everyone else keeps seeing it as detached.
+	if (atomic_flag_test_and_set(&hid_state->is_reconnecting)) {
+		return false;
+	}
+
+	// enumeration is not free, so a controller that is gone for a while is only looked for every so often.
+	// host time is monotonic where the platform has a monotonic clock, so a wall clock step doesn't stall or rush this.
+	const uint64_t now = titania_host_time();
+	if (hid_state->reconnect_time != 0 && now - hid_state->reconnect_time < TITANIA_RECONNECT_INTERVAL) {
+		atomic_flag_clear(&hid_state->is_reconnecting);
+		return false;
+	}
+
+	hid_state->reconnect_time = now;
+
+	hid_device* hid = nullptr;
+	bool is_bluetooth = false;
+	struct hid_device_info* root = hid_enumerate(0x054C, 0);
+	for (const struct hid_device_info* dev = root; dev != nullptr && hid == nullptr; dev = dev->next) {
+		char key[TITANIA_CACHE_KEY_SIZE];
+		if ((dev->bus_type != HID_API_BUS_USB && dev->bus_type != HID_API_BUS_BLUETOOTH) || !titania_is_supported_device(dev->vendor_id, dev->product_id)) {
+			continue;
+		}
+
+		if (titania_cache_key(dev->serial_number, key)) {
+			if (memcmp(key, hid_state->cache_key, TITANIA_CACHE_KEY_SIZE) == 0) {
+				hid = hid_open_path(dev->path);
 			}
+		} else {
+			hid = titania_reconnect_probe(dev->path, hid_state->cache_key);
+		}
+
+		is_bluetooth = dev->bus_type == HID_API_BUS_BLUETOOTH;
+	}
+	hid_free_enumeration(root);
 
-			return TITANIA_ERROR_OK;
+	if (hid == nullptr) {
+		atomic_flag_clear(&hid_state->is_reconnecting);
+		return false;
+	}
+
+	hid_set_nonblocking(hid, !hid_state->blocking);
+
+	// the background worker talks to the old device without holding a reference.
+	if (hid_state->has_background_thread) {
+		titania_thread_join(hid_state->background_thread);
+		hid_state->has_background_thread = false;
+	}
+
+	BEGIN_SWAP_HANDLE(ctx, handle);
+	hid_device* old_hid = hid_state->hid;
+	hid_state->hid = hid;
+	hid_state->hid_info.is_bluetooth = is_bluetooth; // the controller may have moved between usb and bluetooth.
+	hid_state->decode = titania_select_decoder(hid_state->hid_info.is_edge, hid_state->hid_info.is_access, is_bluetooth);
+	hid_state->has_previous = false;
+	END_SWAP_HANDLE(ctx, handle);
+	hid_close(old_hid);
+
+	LOCK_OUTPUT(hid_state);
+	hid_state->output.data.msg.data.flags.value |= hid_state->replay_flags;
+	hid_state->output.data.msg.data.edge.flags.value |= hid_state->replay_edge_flags;
+	titania_ack_forget(hid_state);
+	UNLOCK_OUTPUT(hid_state);
+
+	const bool result = titania_push_impl(hid_state);
+	atomic_store(&hid_state->is_detached, !result);
+	atomic_flag_clear(&hid_state->is_reconnecting);
+	return result;
+}
+
+titania_error titania_ctx_set_reconnect(titania_context* ctx, const titania_handle handle, const bool enabled) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	ACQUIRE_HANDLE(ctx, handle);
+	dualsense_state* hid_state = &ctx->state[handle];
+	titania_error result = TITANIA_ERROR_OK;
+	if (enabled && hid_state->cache_key[0] == 0) {
+		// hidapi did not report a serial number, fall back to the MAC the controller reports about itself.
+		titania_serial_info serial;
+		result = titania_get_serial_impl(ctx, handle, &serial);
+		if (IS_TITANIA_OKAY(result) && !titania_serial_key(&serial, hid_state->cache_key)) {
+			result = TITANIA_ERROR_NOT_SUPPORTED;
 		}
 	}
 
-	return TITANIA_ERROR_NO_SLOTS;
+	if (IS_TITANIA_OKAY(result)) {
+		atomic_store(&hid_state->reconnect, enabled);
+	}
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+titania_error titania_ctx_is_connected(titania_context* ctx, const titania_handle handle, bool* connected) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (connected == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	*connected = !atomic_load(&ctx->state[handle].is_detached);
+	RELEASE_HANDLE(ctx, handle);
+	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_pull(titania_handle* handle, const size_t handle_count, titania_data* data) {
-	CHECK_INIT();
+titania_error titania_ctx_get_calibration(titania_context* ctx, const titania_handle handle, titania_calibration calibration[TITANIA_CALIBRATION_COUNT]) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (calibration == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	dualsense_state* hid_state = &ctx->state[handle];
+	LOCK_INFO(hid_state);
+	titania_results_calibration(hid_state, titania_results_read(hid_state), calibration);
+	UNLOCK_INFO(hid_state);
+	RELEASE_HANDLE(ctx, handle);
+	return TITANIA_ERROR_OK;
+}
 
-	if (handle == nullptr || data == nullptr) {
+// shared by titania_ctx_pull, titania_ctx_pull_fixed, and titania_ctx_pull_changes, exactly one of data and fixed is set.
+static titania_error titania_pull_impl(titania_context* ctx, titania_handle* handle, const size_t handle_count, titania_data* data, titania_data_fixed* fixed, uint32_t* changes) {
+	if (handle == nullptr || (data == nullptr && fixed == nullptr)) {
 		return TITANIA_ERROR_INVALID_ARGUMENT;
 	}
 
@@ -310,37 +832,149 @@ titania_error titania_pull(titania_handle* handle, const size_t handle_count, ti
 		return TITANIA_ERROR_NO_SLOTS;
 	}
 
-	titania_data invalid = { 0 };
-	invalid.hid.handle = TITANIA_INVALID_ID;
-
 	for (size_t i = 0; i < handle_count; i++) {
-		CHECK_HANDLE_VALID(handle[i]);
-		dualsense_state* hid_state = &state[handle[i]];
-		uint8_t* buffer = hid_state->input.buffer;
-		size_t size = sizeof(dualsense_input_msg_ex);
-		if (!hid_state->hid_info.is_bluetooth) {
-			buffer = hid_state->input.data.msg.buffer;
-			size = sizeof(dualsense_input_msg);
+		CHECK_HANDLE(handle[i]);
+		ACQUIRE_HANDLE(ctx, handle[i]);
+		dualsense_state* hid_state = &ctx->state[handle[i]];
+		const bool is_detached = atomic_load_explicit(&hid_state->is_detached, memory_order_relaxed);
+		int report_size = -1;
+		// a detached handle reads nothing until the controller is found again, the bus may have changed when it is.
+		if (!is_detached || titania_reconnect(ctx, handle[i])) {
+			// the read overwrites the last report in place.
+			if (changes != nullptr && hid_state->has_previous) {
+				memcpy(hid_state->previous, hid_state->input.data.msg.buffer, sizeof(hid_state->previous));
+			}
+
+			uint8_t* buffer = hid_state->input.buffer;
+			size_t size = sizeof(dualsense_input_msg_ex);
+			if (!hid_state->hid_info.is_bluetooth) {
+				buffer = hid_state->input.data.msg.buffer;
+				size = sizeof(dualsense_input_msg);
+			}
+
+			hid_state->input.data.report_id = DUALSENSE_REPORT_BLUETOOTH;
+			hid_state->input.data.msg.data.report_id = DUALSENSE_REPORT_INPUT;
+			report_size = hid_read(hid_state->hid, buffer, size);
 		}
 
-		hid_state->input.data.report_id = DUALSENSE_REPORT_BLUETOOTH;
-		hid_state->input.data.msg.data.report_id = DUALSENSE_REPORT_INPUT;
-		const int report_size = hid_read(hid_state->hid, buffer, size);
+		if (changes != nullptr) {
+			changes[i] = 0;
+		}
 
 		if (HID_PASS(report_size)) {
-			titania_convert_input(hid_state->hid_info, hid_state->input.data.msg.data, &data[i], hid_state->calibration);
-		} else if (HID_FAIL(report_size)) {
-			titania_close(handle[i]);
+			if (changes != nullptr) {
+				changes[i] = titania_diff_input(hid_state->has_previous ? hid_state->previous : nullptr, hid_state->input.data.msg.buffer, hid_state->hid_info.is_edge, hid_state->hid_info.is_access);
+			}
+
+			hid_state->has_previous = true;
+
+			// nothing below locks, settings and rings published since the last report are picked up here.
+			if (atomic_load_explicit(&hid_state->pending, memory_order_relaxed) != 0) {
+				titania_apply_pending(hid_state);
+			}
+
+			if (atomic_load_explicit(&hid_state->pipeline_next, memory_order_relaxed) != nullptr) {
+				titania_pipeline_update(hid_state);
+			}
+
+			if (atomic_load_explicit(&hid_state->history_next, memory_order_relaxed) != nullptr) {
+				titania_history_update(hid_state);
+			}
+
+			titania_bias_update(hid_state);
+			if (data != nullptr) {
+				hid_state->decode(&hid_state->hid_info, hid_state->input.data.msg.buffer, &data[i], hid_state->calibration);
+				titania_curve_apply(hid_state, &data[i], nullptr);
+				titania_remap_apply(hid_state, &data[i], nullptr);
+				titania_filter_apply(hid_state, &data[i]);
+			} else {
+				titania_convert_input_fixed(&hid_state->hid_info, &hid_state->input.data.msg.data, &fixed[i], hid_state->calibration_fixed);
+				titania_curve_apply(hid_state, nullptr, &fixed[i]);
+				titania_remap_apply(hid_state, nullptr, &fixed[i]);
+			}
+
+			titania_fusion_update(hid_state);
+			titania_pointer_update(hid_state);
+			titania_prediction_update(hid_state);
+			titania_gesture_update(hid_state);
+
+			// a non-blocking read that found nothing hands back the last report again, it is already in the history.
+			if (hid_state->history != nullptr && hid_state->history->capacity > 0 && report_size > 0) {
+				titania_history_write(hid_state, handle[i]);
+			}
+
+			titania_queue_button_events(hid_state);
+			// only a push held back for the acknowledgement that just came in takes the output lock.
+			if (titania_ack_update(hid_state)) {
+				titania_push_impl(hid_state);
+			}
+
+			titania_results_publish(hid_state);
+		}
+
+		const bool reconnect = atomic_load_explicit(&hid_state->reconnect, memory_order_relaxed);
+		if (HID_FAIL(report_size) && reconnect) {
+			// keep the handle and hand back an idle report until the controller shows up again.
+			atomic_store(&hid_state->is_detached, true);
+			if (data != nullptr) {
+				data[i] = (titania_data) { 0 };
+				data[i].hid = hid_state->hid_info;
+			} else {
+				fixed[i] = (titania_data_fixed) { 0 };
+				fixed[i].handle = handle[i];
+			}
+		}
+
+		RELEASE_HANDLE(ctx, handle[i]);
+
+		if (HID_FAIL(report_size) && !reconnect) {
+			titania_ctx_close(ctx, handle[i]);
 			handle[i] = TITANIA_INVALID_ID;
-			data[i] = invalid;
+			if (data != nullptr) {
+				data[i] = (titania_data) { 0 };
+				data[i].hid.handle = TITANIA_INVALID_ID;
+			} else {
+				fixed[i] = (titania_data_fixed) { 0 };
+				fixed[i].handle = TITANIA_INVALID_ID;
+			}
 		}
 	}
 
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_push(titania_handle* handle, const size_t handle_count) {
-	CHECK_INIT();
+titania_error titania_ctx_pull(titania_context* ctx, titania_handle* handle, const size_t handle_count, titania_data* data) {
+	CHECK_INIT(ctx);
+
+	if (data == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	return titania_pull_impl(ctx, handle, handle_count, data, nullptr, nullptr);
+}
+
+titania_error titania_ctx_pull_changes(titania_context* ctx, titania_handle* handle, const size_t handle_count, titania_data* data, uint32_t* changes) {
+	CHECK_INIT(ctx);
+
+	if (data == nullptr || changes == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	return titania_pull_impl(ctx, handle, handle_count, data, nullptr, changes);
+}
+
+titania_error titania_ctx_pull_fixed(titania_context* ctx, titania_handle* handle, const size_t handle_count, titania_data_fixed* data) {
+	CHECK_INIT(ctx);
+
+	if (data == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	return titania_pull_impl(ctx, handle, handle_count, nullptr, data, nullptr);
+}
+
+titania_error titania_ctx_push(titania_context* ctx, titania_handle* handle, const size_t handle_count) {
+	CHECK_INIT(ctx);
 
 	if (handle == nullptr) {
 		return TITANIA_ERROR_INVALID_HANDLE;
@@ -355,58 +989,35 @@ titania_error titania_push(titania_handle* handle, const size_t handle_count) {
 	}
 
 	for (size_t i = 0; i < handle_count; i++) {
-		CHECK_HANDLE_VALID(handle[i]);
-		dualsense_state* hid_state = &state[handle[i]];
-		if (!hid_state->hid_info.is_access) { // this likely exists on access as well, idk where yet.
-			hid_state->output.data.msg.data.state_id = ++hid_state->seq;
-		}
-
-		const uint8_t* buffer = hid_state->output.buffer;
-		size_t size = sizeof(dualsense_output_msg_ex);
-		if (!hid_state->hid_info.is_bluetooth) {
-			buffer = hid_state->output.data.msg.buffer;
-			size = sizeof(dualsense_output_msg);
-			// Regular: 48 bytes, Edge: 64 bytes, Access: 32 bytes.
-			// why.
-			if (hid_state->hid_info.is_access) {
-				size -= 0x20;
-			} else if (!hid_state->hid_info.is_edge) {
-				size -= 0x10;
+		CHECK_HANDLE(handle[i]);
+		ACQUIRE_HANDLE(ctx, handle[i]);
+		dualsense_state* hid_state = &ctx->state[handle[i]];
+		// a detached handle keeps collecting output, it is replayed once the controller is back.
+		bool result = atomic_load_explicit(&hid_state->is_detached, memory_order_relaxed);
+		if (!result) {
+			result = titania_push_impl(hid_state);
+			if (!result && atomic_load_explicit(&hid_state->reconnect, memory_order_relaxed)) {
+				atomic_store(&hid_state->is_detached, true);
+				result = true;
 			}
-		} else {
-			hid_state->output.data.msg.data.report_id = 0;
-			hid_state->output.data.msg.data.bt.enable_hid = true;
-			hid_state->output.data.msg.data.bt.seq = hid_state->seq & 0xF;
-			hid_state->output.data.bt_checksum = titania_calc_checksum(crc_seed_output, buffer, size - 4);
 		}
+		RELEASE_HANDLE(ctx, handle[i]);
 
-		if (HID_FAIL(hid_write(hid_state->hid, buffer, size))) {
-			titania_close(handle[i]);
+		if (!result) {
+			titania_ctx_close(ctx, handle[i]);
 			handle[i] = TITANIA_INVALID_ID;
-			continue; // invalid!
 		}
-
-		hid_state->output.data.report_id = DUALSENSE_REPORT_BLUETOOTH;
-		hid_state->output.data.msg.data.report_id = DUALSENSE_REPORT_OUTPUT;
-		hid_state->output.data.msg.data.flags.value = 0;
-		const bool edge_enable = hid_state->output.data.msg.data.edge.flags.enable_switching;
-		hid_state->output.data.msg.data.edge.flags.value = 0;
-		hid_state->output.data.msg.data.edge.flags.enable_switching = edge_enable;
-		hid_state->output.data.bt_checksum = 0;
 	}
 
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_update_led(const titania_handle handle, const titania_led_update data) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
-
-	if (IS_ACCESS(state[handle].hid_info)) {
-		return titania_update_access_led(handle, data);
+static titania_error titania_update_led_impl(titania_context* ctx, const titania_handle handle, const titania_led_update data) {
+	if (IS_ACCESS(ctx->state[handle].hid_info)) {
+		return titania_update_access_led(ctx, handle, data);
 	}
 
-	dualsense_output_msg* hid_state = &state[handle].output.data.msg.data;
+	dualsense_output_msg* hid_state = &ctx->state[handle].output.data.msg.data;
 
 	if (data.color.x >= 0.0f && data.color.y >= 0.0f && data.color.z >= 0.0f) {
 		hid_state->flags.led = true;
@@ -423,15 +1034,23 @@ titania_error titania_update_led(const titania_handle handle, const titania_led_
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_update_audio(const titania_handle handle, const titania_audio_update data) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
+titania_error titania_ctx_update_led(titania_context* ctx, const titania_handle handle, const titania_led_update data) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	LOCK_OUTPUT(&ctx->state[handle]);
+	const titania_error result = titania_update_led_impl(ctx, handle, data);
+	UNLOCK_OUTPUT(&ctx->state[handle]);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
 
-	if (IS_ACCESS(state[handle].hid_info)) {
+static titania_error titania_update_audio_impl(titania_context* ctx, const titania_handle handle, const titania_audio_update data) {
+	if (IS_ACCESS(ctx->state[handle].hid_info)) {
 		return TITANIA_ERROR_NOT_SUPPORTED;
 	}
 
-	dualsense_output_msg* hid_state = &state[handle].output.data.msg.data;
+	dualsense_output_msg* hid_state = &ctx->state[handle].output.data.msg.data;
 
 	hid_state->flags.audio_output = true;
 	hid_state->audio.flags.force_external_mic = (data.mic_selection & TITANIA_MIC_EXTERNAL) == TITANIA_MIC_EXTERNAL;
@@ -452,15 +1071,23 @@ titania_error titania_update_audio(const titania_handle handle, const titania_au
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_update_control(const titania_handle handle, const titania_control_update data) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
+titania_error titania_ctx_update_audio(titania_context* ctx, const titania_handle handle, const titania_audio_update data) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	LOCK_OUTPUT(&ctx->state[handle]);
+	const titania_error result = titania_update_audio_impl(ctx, handle, data);
+	UNLOCK_OUTPUT(&ctx->state[handle]);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
 
-	if (IS_ACCESS(state[handle].hid_info)) {
+static titania_error titania_update_control_impl(titania_context* ctx, const titania_handle handle, const titania_control_update data) {
+	if (IS_ACCESS(ctx->state[handle].hid_info)) {
 		return TITANIA_ERROR_NOT_SUPPORTED;
 	}
 
-	dualsense_output_msg* hid_state = &state[handle].output.data.msg.data;
+	dualsense_output_msg* hid_state = &ctx->state[handle].output.data.msg.data;
 
 	hid_state->flags.control1 = hid_state->flags.control2 = true;
 
@@ -491,7 +1118,7 @@ titania_error titania_update_control(const titania_handle handle, const titania_
 	hid_state->control2.reserved3 = data.reserved3;
 #endif
 
-	if (IS_EDGE(state[handle].hid_info)) {
+	if (IS_EDGE(ctx->state[handle].hid_info)) {
 		hid_state->control2.has_edge_flag = true;
 		hid_state->control2.edge_extension = true;
 		hid_state->control2.edge_disable_switching = data.edge_disable_switching_profiles;
@@ -505,15 +1132,23 @@ titania_error titania_update_control(const titania_handle handle, const titania_
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_get_control(const titania_handle handle, titania_control_update* control) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
+titania_error titania_ctx_update_control(titania_context* ctx, const titania_handle handle, const titania_control_update data) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	LOCK_OUTPUT(&ctx->state[handle]);
+	const titania_error result = titania_update_control_impl(ctx, handle, data);
+	UNLOCK_OUTPUT(&ctx->state[handle]);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
 
-	if (IS_ACCESS(state[handle].hid_info)) {
+static titania_error titania_get_control_impl(titania_context* ctx, const titania_handle handle, titania_control_update* control) {
+	if (IS_ACCESS(ctx->state[handle].hid_info)) {
 		return TITANIA_ERROR_NOT_SUPPORTED;
 	}
 
-	const dualsense_output_msg* hid_state = &state[handle].output.data.msg.data;
+	const dualsense_output_msg* hid_state = &ctx->state[handle].output.data.msg.data;
 
 	control->touch_powersave = hid_state->control1.touch_powersave;
 	control->sensor_powersave = hid_state->control1.sensor_powersave;
@@ -541,7 +1176,7 @@ titania_error titania_get_control(const titania_handle handle, titania_control_u
 	control->reserved3 = hid_state->control2.reserved3;
 #endif
 
-	if (IS_EDGE(state[handle].hid_info)) {
+	if (IS_EDGE(ctx->state[handle].hid_info)) {
 		control->edge_disable_switching_profiles = !hid_state->edge.flags.enable_switching;
 		control->edge_disable_led_indicators = !hid_state->edge.indicator.enable_led;
 		control->edge_disable_vibration_indicators = !hid_state->edge.indicator.enable_vibration;
@@ -550,6 +1185,17 @@ titania_error titania_get_control(const titania_handle handle, titania_control_u
 	return TITANIA_ERROR_OK;
 }
 
+titania_error titania_ctx_get_control(titania_context* ctx, const titania_handle handle, titania_control_update* control) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	LOCK_OUTPUT(&ctx->state[handle]);
+	const titania_error result = titania_get_control_impl(ctx, handle, control);
+	UNLOCK_OUTPUT(&ctx->state[handle]);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
 titania_error compute_effect(dualsense_effect_output* effect, dualsense_output_msg* msg, const titania_effect_update trigger, const float power_reduction) {
 	// clear
 	effect->mode = 0;
@@ -671,11 +1317,8 @@ titania_error compute_effect(dualsense_effect_output* effect, dualsense_output_m
 }
 
 // sanity check to make sure we don't (temporarily) brick the controller
-titania_error check_if_trigger_state_bad(const titania_handle handle, const uint8_t id) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
-
-	const dualsense_output_msg* hid_state = &state[handle].output.data.msg.data;
+static titania_error check_if_trigger_state_bad(titania_context* ctx, const titania_handle handle, const uint8_t id) {
+	const dualsense_output_msg* hid_state = &ctx->state[handle].output.data.msg.data;
 	if (hid_state->effects[id].mode >= 0xF0) { // these are calibration modes, will temporarily brick the controller!!
 		return TITANIA_ERROR_INVALID_DATA;
 	}
@@ -683,21 +1326,18 @@ titania_error check_if_trigger_state_bad(const titania_handle handle, const uint
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_update_effect(const titania_handle handle, const titania_effect_update left_trigger, const titania_effect_update right_trigger, const float power_reduction) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
-
-	if (IS_ACCESS(state[handle].hid_info)) {
+static titania_error titania_update_effect_impl(titania_context* ctx, const titania_handle handle, const titania_effect_update left_trigger, const titania_effect_update right_trigger, const float power_reduction) {
+	if (IS_ACCESS(ctx->state[handle].hid_info)) {
 		return TITANIA_ERROR_NOT_SUPPORTED;
 	}
 
-	dualsense_output_msg* hid_state = &state[handle].output.data.msg.data;
+	dualsense_output_msg* hid_state = &ctx->state[handle].output.data.msg.data;
 	hid_state->flags.left_trigger_motor = left_trigger.mode != TITANIA_EFFECT_NONE;
 	hid_state->flags.right_trigger_motor = right_trigger.mode != TITANIA_EFFECT_NONE;
 
 	titania_error result = compute_effect(&hid_state->effects[ADAPTIVE_TRIGGER_LEFT], hid_state, left_trigger, power_reduction);
 	if (IS_TITANIA_OKAY(result)) {
-		result = check_if_trigger_state_bad(handle, ADAPTIVE_TRIGGER_LEFT);
+		result = check_if_trigger_state_bad(ctx, handle, ADAPTIVE_TRIGGER_LEFT);
 	}
 
 	if (IS_TITANIA_BAD(result)) {
@@ -708,7 +1348,7 @@ titania_error titania_update_effect(const titania_handle handle, const titania_e
 
 	result = compute_effect(&hid_state->effects[ADAPTIVE_TRIGGER_RIGHT], hid_state, right_trigger, power_reduction);
 	if (IS_TITANIA_OKAY(result)) {
-		result = check_if_trigger_state_bad(handle, ADAPTIVE_TRIGGER_RIGHT);
+		result = check_if_trigger_state_bad(ctx, handle, ADAPTIVE_TRIGGER_RIGHT);
 	}
 
 	if (IS_TITANIA_BAD(result)) {
@@ -720,19 +1360,33 @@ titania_error titania_update_effect(const titania_handle handle, const titania_e
 	return result;
 }
 
-titania_error titania_update_rumble(const titania_handle handle, const float large_motor, const float small_motor, const float power_reduction, const bool emulate_legacy_behavior) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
+titania_error titania_ctx_update_effect(titania_context* ctx, const titania_handle handle, const titania_effect_update left_trigger, const titania_effect_update right_trigger, const float power_reduction) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	LOCK_OUTPUT(&ctx->state[handle]);
+	const titania_error result = titania_update_effect_impl(ctx, handle, left_trigger, right_trigger, power_reduction);
+	UNLOCK_OUTPUT(&ctx->state[handle]);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
 
-	if (IS_ACCESS(state[handle].hid_info)) {
+static titania_error titania_update_rumble_impl(titania_context* ctx, const titania_handle handle, const float large_motor, const float small_motor, const float power_reduction, const bool emulate_legacy_behavior) {
+	if (IS_ACCESS(ctx->state[handle].hid_info)) {
 		return TITANIA_ERROR_NOT_SUPPORTED;
 	}
 
-	const titania_hid hid = state[handle].hid_info;
-	dualsense_output_msg* hid_state = &state[handle].output.data.msg.data;
+	// this runs under the output lock, so it never talks to the device. until the background worker of a lazy open has
+	// delivered the firmware the legacy mode is used, the first update after it lands switches over.
+	dualsense_state* state = &ctx->state[handle];
+	LOCK_INFO(state);
+	const bool has_advanced_rumble = state->hid_info.is_edge || (state->has_firmware && state->firmware.update.major >= 0x224);
+	UNLOCK_INFO(state);
+
+	dualsense_output_msg* hid_state = &ctx->state[handle].output.data.msg.data;
 	hid_state->flags.rumble = true;
 
-	if (hid.is_edge || hid.firmware.update.major >= 0x224) {
+	if (has_advanced_rumble) {
 		hid_state->flags.control2 = true;
 		hid_state->control2.advanced_rumble_control = emulate_legacy_behavior;
 		hid_state->flags.haptics = !emulate_legacy_behavior;
@@ -751,10 +1405,18 @@ titania_error titania_update_rumble(const titania_handle handle, const float lar
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_bt_pair(const titania_handle handle, const titania_mac mac, const titania_link_key link_key) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
+titania_error titania_ctx_update_rumble(titania_context* ctx, const titania_handle handle, const float large_motor, const float small_motor, const float power_reduction, const bool emulate_legacy_behavior) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	LOCK_OUTPUT(&ctx->state[handle]);
+	const titania_error result = titania_update_rumble_impl(ctx, handle, large_motor, small_motor, power_reduction, emulate_legacy_behavior);
+	UNLOCK_OUTPUT(&ctx->state[handle]);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
 
+static titania_error titania_bt_pair_impl(titania_context* ctx, const titania_handle handle, const titania_mac mac, const titania_link_key link_key) {
 	dualsense_bt_pair_msg msg = { 0 };
 	memcpy(&msg.link_key, link_key, sizeof(titania_link_key));
 	uint32_t pair_mac[6];
@@ -772,49 +1434,68 @@ titania_error titania_bt_pair(const titania_handle handle, const titania_mac mac
 	msg.report_id = DUALSENSE_REPORT_PAIR;
 	msg.checksum = titania_calc_checksum(crc_seed_feature, (uint8_t*) &msg, sizeof(dualsense_bt_pair_msg) - 4);
 
-	if (HID_FAIL(hid_send_feature_report(state[handle].hid, (uint8_t*) &msg, sizeof(dualsense_bt_pair_msg)))) {
+	if (HID_FAIL(hid_send_feature_report(ctx->state[handle].hid, (uint8_t*) &msg, sizeof(dualsense_bt_pair_msg)))) {
 		return TITANIA_ERROR_HIDAPI_FAIL; // really only happens with bluetooth due to failed checksum
 	}
 
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_bt_connect(const titania_handle handle) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
+titania_error titania_ctx_bt_pair(titania_context* ctx, const titania_handle handle, const titania_mac mac, const titania_link_key link_key) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_bt_pair_impl(ctx, handle, mac, link_key);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
 
+static titania_error titania_bt_connect_impl(titania_context* ctx, const titania_handle handle) {
 	dualsense_bt_command_msg msg = { 0 };
 	msg.report_id = DUALSENSE_REPORT_COMMAND_BT;
 	msg.command = DUALSENSE_BT_COMMAND_CONNECT;
 	msg.checksum = titania_calc_checksum(crc_seed_feature, (uint8_t*) &msg, sizeof(dualsense_bt_command_msg) - 4);
 
-	if (HID_FAIL(hid_send_feature_report(state[handle].hid, (uint8_t*) &msg, sizeof(dualsense_bt_command_msg)))) {
+	if (HID_FAIL(hid_send_feature_report(ctx->state[handle].hid, (uint8_t*) &msg, sizeof(dualsense_bt_command_msg)))) {
 		return TITANIA_ERROR_HIDAPI_FAIL; // really only happens with bluetooth due to failed checksum
 	}
 
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_bt_disconnect(const titania_handle handle) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
+titania_error titania_ctx_bt_connect(titania_context* ctx, const titania_handle handle) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_bt_connect_impl(ctx, handle);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
 
+static titania_error titania_bt_disconnect_impl(titania_context* ctx, const titania_handle handle) {
 	dualsense_bt_command_msg msg = { 0 };
 	msg.report_id = DUALSENSE_REPORT_COMMAND_BT;
 	msg.command = DUALSENSE_BT_COMMAND_DISCONNECT;
 	msg.checksum = titania_calc_checksum(crc_seed_feature, (uint8_t*) &msg, sizeof(dualsense_bt_command_msg) - 4);
 
-	if (HID_FAIL(hid_send_feature_report(state[handle].hid, (uint8_t*) &msg, sizeof(dualsense_bt_command_msg)))) {
+	if (HID_FAIL(hid_send_feature_report(ctx->state[handle].hid, (uint8_t*) &msg, sizeof(dualsense_bt_command_msg)))) {
 		return TITANIA_ERROR_HIDAPI_FAIL; // really only happens with bluetooth due to failed checksum
 	}
 
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_update_edge_profile(const titania_handle handle, const titania_profile_id id, const titania_edge_profile profile) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
-	CHECK_EDGE(handle);
+titania_error titania_ctx_bt_disconnect(titania_context* ctx, const titania_handle handle) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_bt_disconnect_impl(ctx, handle);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_update_edge_profile_impl(titania_context* ctx, const titania_handle handle, const titania_profile_id id, const titania_edge_profile profile) {
+	CHECK_EDGE(ctx, handle);
 
 	if (id == TITANIA_PROFILE_NONE) {
 		return TITANIA_ERROR_OK;
@@ -838,12 +1519,15 @@ titania_error titania_update_edge_profile(const titania_handle handle, const tit
 		default: return TITANIA_ERROR_INVALID_PROFILE;
 	}
 
+	// even a partial write leaves the stored profile different from the cached one.
+	titania_invalidate_edge_profile(&ctx->state[handle], id);
+
 	for (int i = 0; i < 3; ++i) {
 		output[i].report_id = report_id;
 		output[i].profile_part = i;
 		output[i].checksum = titania_calc_checksum(crc_seed_feature_profile, (uint8_t*) &output[i], sizeof(*output) - 4);
 
-		if (HID_FAIL(hid_send_feature_report(state[handle].hid, (uint8_t*) &output[i], sizeof(dualsense_edge_profile_blob)))) {
+		if (HID_FAIL(hid_send_feature_report(ctx->state[handle].hid, (uint8_t*) &output[i], sizeof(dualsense_edge_profile_blob)))) {
 			return TITANIA_ERROR_HIDAPI_FAIL; // really only happens with bluetooth due to failed checksum
 		}
 	}
@@ -851,10 +1535,17 @@ titania_error titania_update_edge_profile(const titania_handle handle, const tit
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_update_access_profile(const titania_handle handle, const titania_profile_id id, const titania_access_profile profile) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
-	CHECK_ACCESS(handle);
+titania_error titania_ctx_update_edge_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id id, const titania_edge_profile profile) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_update_edge_profile_impl(ctx, handle, id, profile);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_update_access_profile_impl(titania_context* ctx, const titania_handle handle, const titania_profile_id id, const titania_access_profile profile) {
+	CHECK_ACCESS(ctx, handle);
 
 	if (id == TITANIA_PROFILE_NONE) {
 		return TITANIA_ERROR_OK;
@@ -865,11 +1556,20 @@ titania_error titania_update_access_profile(const titania_handle handle, const t
 	}
 
 	playstation_access_profile_blob output[0x12];
-	const titania_error result = titania_convert_access_profile_output(profile, output);
+	uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE];
+	const titania_error result = titania_convert_access_profile_output(profile, profile_data, output);
 	if (IS_TITANIA_BAD(result)) {
 		return result;
 	}
 
+	// the pages are only committed as a whole, so an unchanged profile is the only write that can be skipped.
+	dualsense_state* hid_state = &ctx->state[handle];
+	if (titania_is_access_profile_cached(hid_state, id, profile_data)) {
+		return TITANIA_ERROR_OK;
+	}
+
+	titania_invalidate_access_profile(hid_state, id);
+
 	uint8_t command;
 	switch (id) {
 		case TITANIA_PROFILE_1: command = PLAYSTATION_ACCESS_UPDATE_PROFILE_1; break;
@@ -884,7 +1584,7 @@ titania_error titania_update_access_profile(const titania_handle handle, const t
 		output[i].update_op.page_id = i;
 		output[i].checksum = titania_calc_checksum(crc_seed_feature_profile, (uint8_t*) &output[i], sizeof(*output) - 4);
 
-		if (HID_FAIL(hid_send_feature_report(state[handle].hid, (uint8_t*) &output[i], sizeof(playstation_access_profile_blob)))) {
+		if (HID_FAIL(hid_send_feature_report(ctx->state[handle].hid, (uint8_t*) &output[i], sizeof(playstation_access_profile_blob)))) {
 			return TITANIA_ERROR_HIDAPI_FAIL; // really only happens with bluetooth due to failed checksum
 		}
 	}
@@ -892,17 +1592,25 @@ titania_error titania_update_access_profile(const titania_handle handle, const t
 	// this might not be necessary.
 	playstation_access_profile_blob data = { 0 };
 	data.report_id = ACCESS_REPORT_GET_PROFILE;
-	if (HID_FAIL(hid_get_feature_report(state[handle].hid, (uint8_t*) &data, sizeof(playstation_access_profile_blob)))) {
+	if (HID_FAIL(hid_get_feature_report(ctx->state[handle].hid, (uint8_t*) &data, sizeof(playstation_access_profile_blob)))) {
 		return TITANIA_ERROR_INVALID_DATA;
 	}
 
+	titania_store_access_profile(hid_state, id, profile_data);
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_delete_edge_profile(const titania_handle handle, const titania_profile_id id) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
-	CHECK_EDGE(handle);
+titania_error titania_ctx_update_access_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id id, const titania_access_profile profile) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_update_access_profile_impl(ctx, handle, id, profile);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_delete_edge_profile_impl(titania_context* ctx, const titania_handle handle, const titania_profile_id id) {
+	CHECK_EDGE(ctx, handle);
 
 	if (id == TITANIA_PROFILE_NONE) {
 		return TITANIA_ERROR_OK;
@@ -920,17 +1628,25 @@ titania_error titania_delete_edge_profile(const titania_handle handle, const tit
 		del.profile_id = id;
 	}
 	del.checksum = titania_calc_checksum(crc_seed_feature_profile, (uint8_t*) &del, sizeof(del) - 4);
-	if (HID_FAIL(hid_send_feature_report(state[handle].hid, (uint8_t*) &del, sizeof(del)))) {
+	titania_invalidate_edge_profile(&ctx->state[handle], id);
+	if (HID_FAIL(hid_send_feature_report(ctx->state[handle].hid, (uint8_t*) &del, sizeof(del)))) {
 		return TITANIA_ERROR_HIDAPI_FAIL; // really only happens with bluetooth due to failed checksum
 	}
 
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_delete_access_profile(const titania_handle handle, const titania_profile_id id) {
-	CHECK_INIT();
-	CHECK_HANDLE_VALID(handle);
-	CHECK_ACCESS(handle);
+titania_error titania_ctx_delete_edge_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id id) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_delete_edge_profile_impl(ctx, handle, id);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_delete_access_profile_impl(titania_context* ctx, const titania_handle handle, const titania_profile_id id) {
+	CHECK_ACCESS(ctx, handle);
 
 	if (id == TITANIA_PROFILE_NONE) {
 		return TITANIA_ERROR_OK;
@@ -949,15 +1665,25 @@ titania_error titania_delete_access_profile(const titania_handle handle, const t
 		del.delete_op.profile_id = id;
 	}
 	del.checksum = titania_calc_checksum(crc_seed_feature_profile, (uint8_t*) &del, sizeof(del) - 4);
-	if (HID_FAIL(hid_send_feature_report(state[handle].hid, (uint8_t*) &del, sizeof(del)))) {
+	titania_invalidate_access_profile(&ctx->state[handle], id);
+	if (HID_FAIL(hid_send_feature_report(ctx->state[handle].hid, (uint8_t*) &del, sizeof(del)))) {
 		return TITANIA_ERROR_HIDAPI_FAIL; // really only happens with bluetooth due to failed checksum
 	}
 
 	return TITANIA_ERROR_OK;
 }
 
-void titania_close(const titania_handle handle) {
-	if (!is_initialized) {
+titania_error titania_ctx_delete_access_profile(titania_context* ctx, const titania_handle handle, const titania_profile_id id) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_delete_access_profile_impl(ctx, handle, id);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+void titania_ctx_close(titania_context* ctx, const titania_handle handle) {
+	if (ctx == nullptr || !ctx->is_initialized) {
 		return;
 	}
 
@@ -965,43 +1691,58 @@ void titania_close(const titania_handle handle) {
 		return;
 	}
 
-	if (state[handle].hid == nullptr) {
+	if (!RETIRE_HANDLE(ctx, handle)) {
 		return;
 	}
 
-	hid_close(state[handle].hid);
-	memset(&state[handle], 0, sizeof(dualsense_state));
-}
-
-void titania_exit(void) {
-	if (!is_initialized) {
-		return;
+	if (ctx->state[handle].has_background_thread) {
+		titania_thread_join(ctx->state[handle].background_thread);
 	}
 
-	for (int i = 0; i < TITANIA_MAX_CONTROLLERS; i++) {
-		titania_close(i);
-	}
+	hid_close(ctx->state[handle].hid);
+	titania_pipeline_free(&ctx->state[handle]);
+	titania_reset_slot(&ctx->state[handle]);
+	FREE_HANDLE(ctx, handle);
+}
 
-	hid_exit();
+static titania_error titania_debug_get_hid_impl(titania_context* ctx, const titania_handle handle, intptr_t* hid) {
+	*hid = (intptr_t) ctx->state[handle].hid;
 
-	is_initialized = false;
+	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_debug_get_hid(const titania_handle handle, intptr_t* hid) {
-	CHECK_INIT();
+titania_error titania_ctx_debug_get_hid(titania_context* ctx, const titania_handle handle, intptr_t* hid) {
+	CHECK_INIT(ctx);
 	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_debug_get_hid_impl(ctx, handle, hid);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_debug_convert_input_impl(titania_context* ctx, const titania_handle handle, titania_data* data) {
+	if (data == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
 
-	*hid = (intptr_t) state[handle].hid;
+	// the report, calibration, and hid info all belong to the pulling thread, only it should call this.
+	ctx->state[handle].decode(&ctx->state[handle].hid_info, ctx->state[handle].input.data.msg.buffer, data, ctx->state[handle].calibration);
 
 	return TITANIA_ERROR_OK;
 }
 
-titania_error titania_debug_get_hid_report_ids(const titania_handle handle, titania_report_id report_ids[0xFF]) {
-	CHECK_INIT();
+titania_error titania_ctx_debug_convert_input(titania_context* ctx, const titania_handle handle, titania_data* data) {
+	CHECK_INIT(ctx);
 	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_debug_convert_input_impl(ctx, handle, data);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
 
+static titania_error titania_debug_get_hid_report_ids_impl(titania_context* ctx, const titania_handle handle, titania_report_id report_ids[0xFF]) {
 	uint8_t report[HID_API_MAX_REPORT_DESCRIPTOR_SIZE];
-	const int report_size = hid_get_report_descriptor(state[handle].hid, report, HID_API_MAX_REPORT_DESCRIPTOR_SIZE);
+	const int report_size = hid_get_report_descriptor(ctx->state[handle].hid, report, HID_API_MAX_REPORT_DESCRIPTOR_SIZE);
 
 	memset(report_ids, 0, sizeof(titania_report_id) * 0xFF);
 
@@ -1073,3 +1814,12 @@ titania_error titania_debug_get_hid_report_ids(const titania_handle handle, tita
 
 	return TITANIA_ERROR_OK;
 }
+
+titania_error titania_ctx_debug_get_hid_report_ids(titania_context* ctx, const titania_handle handle, titania_report_id report_ids[0xFF]) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_debug_get_hid_report_ids_impl(ctx, handle, report_ids);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
@@ -0,0 +1,233 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "structures.h"
+
+#ifdef TITANIA_HAS_UDEV
+#include <libudev.h>
+#endif
+
+#define TITANIA_HOTPLUG_MAX_DEVICES (32)
+
+#define HID_BUS_USB (0x03)
+#define HID_BUS_BLUETOOTH (0x05)
+
+struct titania_hotplug {
+#ifdef TITANIA_HAS_UDEV
+	struct udev* udev;
+	struct udev_monitor* monitor;
+	bool primed;
+#endif
+	size_t count;
+	titania_query known[TITANIA_HOTPLUG_MAX_DEVICES];
+};
+
+static titania_query* titania_hotplug_find(titania_hotplug* hotplug, const char* path) {
+	for (size_t i = 0; i < hotplug->count; ++i) {
+		if (strcmp(hotplug->known[i].hid_path, path) == 0) {
+			return &hotplug->known[i];
+		}
+	}
+
+	return nullptr;
+}
+
+static void titania_hotplug_add(titania_hotplug* hotplug, const titania_query* query, titania_hotplug_callback_t callback, void* userdata) {
+	if (hotplug->count >= TITANIA_HOTPLUG_MAX_DEVICES || titania_hotplug_find(hotplug, query->hid_path) != nullptr) {
+		return;
+	}
+
+	hotplug->known[hotplug->count++] = *query;
+	callback(TITANIA_HOTPLUG_ADDED, query, userdata);
+}
+
+static void titania_hotplug_remove(titania_hotplug* hotplug, titania_query* known, titania_hotplug_callback_t callback, void* userdata) {
+	// copy it out first, the callback should not see the slot being reused.
+	const titania_query query = *known;
+	*known = hotplug->known[--hotplug->count];
+	callback(TITANIA_HOTPLUG_REMOVED, &query, userdata);
+}
+
+// diff a fresh enumeration against the known set, used to prime the monitor and as the fallback without udev.
+static titania_error titania_hotplug_rescan(titania_hotplug* hotplug, titania_hotplug_callback_t callback, void* userdata) {
+	titania_query* hids = malloc(sizeof(titania_query) * TITANIA_HOTPLUG_MAX_DEVICES);
+	if (hids == nullptr) {
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	const titania_error result = titania_get_hids(hids, TITANIA_HOTPLUG_MAX_DEVICES);
+	if (IS_TITANIA_BAD(result)) {
+		free(hids);
+		return result;
+	}
+
+	for (size_t i = 0; i < hotplug->count;) {
+		bool found = false;
+		for (int j = 0; j < TITANIA_HOTPLUG_MAX_DEVICES && hids[j].hid_path[0] != 0; ++j) {
+			if (strcmp(hids[j].hid_path, hotplug->known[i].hid_path) == 0) {
+				found = true;
+				break;
+			}
+		}
+
+		if (found) {
+			i++;
+		} else {
+			titania_hotplug_remove(hotplug, &hotplug->known[i], callback, userdata);
+		}
+	}
+
+	for (int j = 0; j < TITANIA_HOTPLUG_MAX_DEVICES && hids[j].hid_path[0] != 0; ++j) {
+		titania_hotplug_add(hotplug, &hids[j], callback, userdata);
+	}
+
+	free(hids);
+	return TITANIA_ERROR_OK;
+}
+
+#ifdef TITANIA_HAS_UDEV
+// build a query from a hidraw device the same way hidapi's hidraw backend would.
+static bool titania_hotplug_query_udev(struct udev_device* device, titania_query* query) {
+	const char* devnode = udev_device_get_devnode(device);
+	struct udev_device* parent = udev_device_get_parent_with_subsystem_devtype(device, "hid", nullptr);
+	if (devnode == nullptr || parent == nullptr || strlen(devnode) >= sizeof(query->hid_path)) {
+		return false;
+	}
+
+	const char* hid_id = udev_device_get_property_value(parent, "HID_ID");
+	unsigned int bus, vendor_id, product_id;
+	if (hid_id == nullptr || sscanf(hid_id, "%x:%x:%x", &bus, &vendor_id, &product_id) != 3) {
+		return false;
+	}
+
+	if ((bus != HID_BUS_USB && bus != HID_BUS_BLUETOOTH) || !titania_is_supported_device(vendor_id, product_id)) {
+		return false;
+	}
+
+	memset(query, 0, sizeof(titania_query));
+	query->vendor_id = vendor_id;
+	query->product_id = product_id;
+	query->is_bluetooth = bus == HID_BUS_BLUETOOTH;
+	query->is_edge = IS_EDGE((*query));
+	query->is_access = IS_ACCESS((*query));
+	strcpy(query->hid_path, devnode);
+
+	const char* uniq = udev_device_get_property_value(parent, "HID_UNIQ");
+	if (uniq != nullptr) {
+		for (size_t i = 0; uniq[i] != 0 && i < sizeof(query->hid_serial) / sizeof(wchar_t) - 1; ++i) {
+			query->hid_serial[i] = (wchar_t) (unsigned char) uniq[i];
+		}
+	}
+
+	return true;
+}
+#endif
+
+titania_error titania_hotplug_create(titania_hotplug** hotplug) {
+	if (hotplug == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	*hotplug = calloc(1, sizeof(titania_hotplug));
+	if (*hotplug == nullptr) {
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+#ifdef TITANIA_HAS_UDEV
+	// any failure here leaves the monitor null, and dispatch falls back to rescanning.
+	(*hotplug)->udev = udev_new();
+	if ((*hotplug)->udev != nullptr) {
+		struct udev_monitor* monitor = udev_monitor_new_from_netlink((*hotplug)->udev, "udev");
+		if (monitor != nullptr && (udev_monitor_filter_add_match_subsystem_devtype(monitor, "hidraw", nullptr) < 0 || udev_monitor_enable_receiving(monitor) < 0)) {
+			udev_monitor_unref(monitor);
+			monitor = nullptr;
+		}
+
+		(*hotplug)->monitor = monitor;
+	}
+#endif
+
+	return TITANIA_ERROR_OK;
+}
+
+int titania_hotplug_get_fd(titania_hotplug* hotplug) {
+#ifdef TITANIA_HAS_UDEV
+	if (hotplug != nullptr && hotplug->monitor != nullptr) {
+		return udev_monitor_get_fd(hotplug->monitor);
+	}
+#else
+	(void) hotplug;
+#endif
+
+	return -1;
+}
+
+titania_error titania_hotplug_dispatch(titania_hotplug* hotplug, titania_hotplug_callback_t callback, void* userdata) {
+	if (hotplug == nullptr || callback == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+#ifdef TITANIA_HAS_UDEV
+	if (hotplug->monitor != nullptr) {
+		// the first dispatch reports everything that is already connected, udev only reports changes after that.
+		// anything queued before priming is deduplicated by path.
+		if (!hotplug->primed) {
+			const titania_error result = titania_hotplug_rescan(hotplug, callback, userdata);
+			if (IS_TITANIA_BAD(result)) {
+				return result;
+			}
+
+			hotplug->primed = true;
+		}
+
+		// the monitor socket is non-blocking, this drains whatever is queued and returns.
+		struct udev_device* device;
+		while ((device = udev_monitor_receive_device(hotplug->monitor)) != nullptr) {
+			const char* action = udev_device_get_action(device);
+			const char* devnode = udev_device_get_devnode(device);
+			if (action != nullptr && devnode != nullptr) {
+				if (strcmp(action, "add") == 0) {
+					titania_query query;
+					if (titania_hotplug_query_udev(device, &query)) {
+						titania_hotplug_add(hotplug, &query, callback, userdata);
+					}
+				} else if (strcmp(action, "remove") == 0) {
+					titania_query* known = titania_hotplug_find(hotplug, devnode);
+					if (known != nullptr) {
+						titania_hotplug_remove(hotplug, known, callback, userdata);
+					}
+				}
+			}
+
+			udev_device_unref(device);
+		}
+
+		return TITANIA_ERROR_OK;
+	}
+#endif
+
+	return titania_hotplug_rescan(hotplug, callback, userdata);
+}
+
+void titania_hotplug_destroy(titania_hotplug* hotplug) {
+	if (hotplug == nullptr) {
+		return;
+	}
+
+#ifdef TITANIA_HAS_UDEV
+	if (hotplug->monitor != nullptr) {
+		udev_monitor_unref(hotplug->monitor);
+	}
+
+	if (hotplug->udev != nullptr) {
+		udev_unref(hotplug->udev);
+	}
+#endif
+
+	free(hotplug);
+}
@@ -0,0 +1,161 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "structures.h"
+
+// every stage off, what a handle pulls with until a setter runs.
+const titania_pipeline titania_pipeline_default = { 0 };
+
+void titania_pipeline_init(dualsense_state* hid_state) {
+	hid_state->pipeline = &titania_pipeline_default;
+	hid_state->pipeline_staging = titania_pipeline_default;
+	hid_state->pipeline_staging.firmware = hid_state->hid_info.firmware;
+	hid_state->pipeline_staging.serial = hid_state->hid_info.serial;
+	hid_state->pipeline_staging.has_firmware = hid_state->has_firmware;
+	hid_state->pipeline_staging.has_serial = hid_state->has_serial;
+	hid_state->fusion.q[0] = 1.0f;
+
+	hid_state->results_back = 0;
+	atomic_store_explicit(&hid_state->results_middle, 1, memory_order_relaxed);
+	hid_state->results_front = 2;
+	titania_results_publish(hid_state);
+}
+
+titania_pipeline* titania_pipeline_edit(dualsense_state* hid_state) {
+	titania_pipeline* pipeline = malloc(sizeof(titania_pipeline));
+	if (pipeline != nullptr) {
+		*pipeline = hid_state->pipeline_staging;
+	}
+
+	return pipeline;
+}
+
+void titania_pipeline_publish(dualsense_state* hid_state, titania_pipeline* pipeline) {
+	hid_state->pipeline_staging = *pipeline;
+	// one that pull has not picked up yet never processed a report, it is simply replaced.
+	free(atomic_exchange_explicit(&hid_state->pipeline_next, pipeline, memory_order_acq_rel));
+}
+
+void titania_pipeline_update(dualsense_state* hid_state) {
+	titania_pipeline* pipeline = atomic_exchange_explicit(&hid_state->pipeline_next, nullptr, memory_order_acquire);
+	if (pipeline == nullptr) {
+		return;
+	}
+
+	const titania_pipeline* previous = hid_state->pipeline;
+	if (pipeline->fusion.generation != previous->fusion.generation) {
+		memset(&hid_state->fusion, 0, sizeof(titania_fusion_state));
+		hid_state->fusion.q[0] = 1.0f;
+	}
+
+	if (pipeline->bias.generation != previous->bias.generation) {
+		titania_bias_state* bias = &hid_state->bias;
+		if (previous->bias.enabled) {
+			// stopping, or restarting with different bins, starts over from the calibration report.
+			for (int j = 0; j < 3; ++j) {
+				hid_state->calibration[j].bias = bias->calibration_bias[j];
+				hid_state->calibration_fixed[j].bias = bias->calibration_bias[j];
+			}
+		}
+
+		memset(bias, 0, sizeof(titania_bias_state));
+		for (int j = 0; j < 3; ++j) {
+			bias->calibration_bias[j] = hid_state->calibration[j].bias;
+		}
+	}
+
+	if (pipeline->remap.generation != previous->remap.generation) {
+		memset(&hid_state->remap, 0, sizeof(titania_remap_state));
+	}
+
+	if (pipeline->filter.generation != previous->filter.generation) {
+		hid_state->filter.primed = false;
+	}
+
+	if (pipeline->gesture.generation != previous->gesture.generation) {
+		memset(&hid_state->gesture, 0, sizeof(titania_gesture_state));
+	}
+
+	if (pipeline->pointer.generation != previous->pointer.generation) {
+		memset(&hid_state->pointer, 0, sizeof(titania_pointer_state));
+	}
+
+	if (pipeline->prediction.generation != previous->prediction.generation) {
+		memset(&hid_state->prediction, 0, sizeof(titania_prediction_state));
+	}
+
+	if (pipeline->has_firmware) {
+		hid_state->hid_info.firmware = pipeline->firmware;
+	}
+
+	if (pipeline->has_serial) {
+		hid_state->hid_info.serial = pipeline->serial;
+	}
+
+	hid_state->pipeline = pipeline;
+	if (previous != &titania_pipeline_default) {
+		free((titania_pipeline*) previous);
+	}
+}
+
+void titania_pipeline_free(dualsense_state* hid_state) {
+	if (hid_state->pipeline != &titania_pipeline_default) {
+		free((titania_pipeline*) hid_state->pipeline);
+	}
+
+	free(atomic_exchange(&hid_state->pipeline_next, nullptr));
+	// history_latest is one of these two.
+	free(hid_state->history);
+	free(atomic_exchange(&hid_state->history_next, nullptr));
+	hid_state->pipeline = nullptr;
+	hid_state->history = nullptr;
+	hid_state->history_latest = nullptr;
+}
+
+void titania_results_publish(dualsense_state* hid_state) {
+	titania_results* results = &hid_state->results[hid_state->results_back];
+	const titania_pipeline* pipeline = hid_state->pipeline;
+	memcpy(results->calibration, hid_state->calibration, sizeof(results->calibration));
+	for (int j = 0; j < 3; ++j) {
+		results->calibration_bias[j] = pipeline->bias.enabled ? hid_state->bias.calibration_bias[j] : hid_state->calibration[j].bias;
+	}
+
+	titania_bias_result(hid_state, &results->gyro_bias);
+	results->bias_generation = pipeline->bias.generation;
+	results->fusion = hid_state->fusion;
+	results->fusion_generation = pipeline->fusion.generation;
+	results->pointer[0] = hid_state->pointer.total[0];
+	results->pointer[1] = hid_state->pointer.total[1];
+	results->pointer_samples = hid_state->pointer.samples;
+	results->pointer_time = hid_state->pointer.sensor_time;
+	results->pointer_generation = pipeline->pointer.generation;
+	// the prediction carries a whole titania_data, it is only copied while it is used.
+	if (pipeline->prediction.model != TITANIA_PREDICTION_NONE) {
+		results->prediction = hid_state->prediction;
+	} else {
+		results->prediction.count = 0;
+	}
+
+	results->prediction_generation = pipeline->prediction.generation;
+	results->ack = hid_state->ack_stats;
+	hid_state->results_back = titania_triple_publish(&hid_state->results_middle, hid_state->results_back);
+}
+
+const titania_results* titania_results_read(dualsense_state* hid_state) {
+	hid_state->results_front = titania_triple_take(&hid_state->results_middle, hid_state->results_front);
+	return &hid_state->results[hid_state->results_front];
+}
+
+void titania_results_calibration(const dualsense_state* hid_state, const titania_results* results, titania_calibration_scale calibration[6]) {
+	memcpy(calibration, results->calibration, sizeof(results->calibration));
+	// pull puts the calibration report bias back before it learns with new settings.
+	if (results->bias_generation != hid_state->pipeline_staging.bias.generation) {
+		for (int j = 0; j < 3; ++j) {
+			calibration[j].bias = results->calibration_bias[j];
+		}
+	}
+}
@@ -0,0 +1,221 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <math.h>
+#include <string.h>
+
+#include "structures.h"
+
+#define TITANIA_POINTER_MAX_STEP (0.1f) // seconds, longer gaps move nothing
+#define TITANIA_POINTER_GRAVITY_TIME (0.5f) // seconds for the accelerometer to pull the up vector back, the gyro carries it in between
+#define TITANIA_POINTER_PLAYER_RELAX (1.41f) // how much of the roll axis player space lets into yaw
+#define TITANIA_POINTER_DEGREES (DUALSENSE_GYRO_RADIANS * (180.0f / 3.14159265358979f))
+
+static float titania_pointer_clamp(const float value) { return value < 0.0f ? 0.0f : value > 1.0f ? 1.0f : value; }
+
+static bool titania_pointer_normalize(float v[3]) {
+	const float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+	if (length <= 0.0f) {
+		return false;
+	}
+
+	for (int j = 0; j < 3; ++j) {
+		v[j] /= length;
+	}
+
+	return true;
+}
+
+// carries the up vector along with the rotation, then leans it towards what the accelerometer reads.
+static void titania_pointer_gravity(titania_pointer_state* pointer, const float gyro[3], float accelerometer[3], const float dt) {
+	const float* up = pointer->up;
+	const float turned[3] = {
+		up[0] + (up[1] * gyro[2] - up[2] * gyro[1]) * dt,
+		up[1] + (up[2] * gyro[0] - up[0] * gyro[2]) * dt,
+		up[2] + (up[0] * gyro[1] - up[1] * gyro[0]) * dt,
+	};
+
+	const float weight = titania_pointer_clamp(dt / TITANIA_POINTER_GRAVITY_TIME);
+	const bool has_accelerometer = titania_pointer_normalize(accelerometer);
+	for (int j = 0; j < 3; ++j) {
+		pointer->up[j] = has_accelerometer ? turned[j] + (accelerometer[j] - turned[j]) * weight : turned[j];
+	}
+
+	if (!titania_pointer_normalize(pointer->up)) {
+		memcpy(pointer->up, accelerometer, sizeof(pointer->up));
+	}
+}
+
+// yaw and pitch rates in degrees per second for the configured space.
+static void titania_pointer_rotate(const titania_pointer_state* pointer, const titania_gyro_space space, const float gyro[3], float* yaw, float* pitch) {
+	const float* up = pointer->up;
+	switch (space) {
+		case TITANIA_GYRO_SPACE_WORLD: {
+			*yaw = gyro[0] * up[0] + gyro[1] * up[1] + gyro[2] * up[2];
+			// pitch around the controller's right axis laid flat, nothing while that axis points straight up or down.
+			const float flat = sqrtf(fmaxf(0.0f, 1.0f - up[0] * up[0]));
+			*pitch = flat > 1e-3f ? (gyro[0] - up[0] * *yaw) / flat : 0.0f;
+			break;
+		}
+		case TITANIA_GYRO_SPACE_PLAYER: {
+			const float world_yaw = gyro[1] * up[1] + gyro[2] * up[2];
+			const float local_yaw = sqrtf(gyro[1] * gyro[1] + gyro[2] * gyro[2]);
+			*yaw = copysignf(fminf(fabsf(world_yaw) * TITANIA_POINTER_PLAYER_RELAX, local_yaw), world_yaw);
+			*pitch = gyro[0];
+			break;
+		}
+		default:
+			*yaw = gyro[1];
+			*pitch = gyro[0];
+			break;
+	}
+}
+
+void titania_pointer_update(dualsense_state* hid_state) {
+	const titania_gyro_pointer* config = &hid_state->pipeline->pointer.settings;
+	if (!hid_state->pipeline->pointer.enabled) {
+		return;
+	}
+
+	titania_pointer_state* pointer = &hid_state->pointer;
+	const dualsense_sensors* sensors = &hid_state->input.data.msg.data.sensors;
+	const titania_calibration_scale* calibration = hid_state->calibration;
+	float accelerometer[3] = {
+		titania_fusion_calibrate(sensors->accelerometer.x, &calibration[CALIBRATION_ACCELEROMETER_X]),
+		titania_fusion_calibrate(sensors->accelerometer.y, &calibration[CALIBRATION_ACCELEROMETER_Y]),
+		titania_fusion_calibrate(sensors->accelerometer.z, &calibration[CALIBRATION_ACCELEROMETER_Z]),
+	};
+
+	// the sensor clock wraps every 24 minutes, unsigned subtraction absorbs it.
+	const float dt = pointer->has_sample ? (float) (sensors->time - pointer->sensor_time) / DUALSENSE_SENSOR_TICKS_PER_SECOND : 0.0f;
+	if (pointer->has_sample && dt <= 0.0f) { // the same sample read twice.
+		return;
+	}
+
+	pointer->sensor_time = sensors->time;
+	if (!pointer->has_sample || dt > TITANIA_POINTER_MAX_STEP) {
+		pointer->has_sample = titania_pointer_normalize(accelerometer);
+		memcpy(pointer->up, accelerometer, sizeof(pointer->up));
+		return;
+	}
+
+	const float gyro[3] = {
+		titania_fusion_calibrate(sensors->gyro.x - calibration[CALIBRATION_GYRO_X].bias, &calibration[CALIBRATION_GYRO_X]) * TITANIA_POINTER_DEGREES,
+		titania_fusion_calibrate(sensors->gyro.y - calibration[CALIBRATION_GYRO_Y].bias, &calibration[CALIBRATION_GYRO_Y]) * TITANIA_POINTER_DEGREES,
+		titania_fusion_calibrate(sensors->gyro.z - calibration[CALIBRATION_GYRO_Z].bias, &calibration[CALIBRATION_GYRO_Z]) * TITANIA_POINTER_DEGREES,
+	};
+
+	const float radians = 3.14159265358979f / 180.0f;
+	titania_pointer_gravity(pointer, (const float[3]) { gyro[0] * radians, gyro[1] * radians, gyro[2] * radians }, accelerometer, dt);
+
+	float yaw;
+	float pitch;
+	titania_pointer_rotate(pointer, config->space, gyro, &yaw, &pitch);
+
+	// sensitivity follows how fast the controller turns, and slow turns are tightened towards zero.
+	const float speed = sqrtf(yaw * yaw + pitch * pitch);
+	const float ramp = config->max_speed > config->min_speed ? titania_pointer_clamp((speed - config->min_speed) / (config->max_speed - config->min_speed)) : 0.0f;
+	const float tightening = config->tightening > 0.0f && speed < config->tightening ? speed / config->tightening : 1.0f;
+	const float sensitivity_x = config->min_sensitivity.x + (config->max_sensitivity.x - config->min_sensitivity.x) * ramp;
+	const float sensitivity_y = config->min_sensitivity.y + (config->max_sensitivity.y - config->min_sensitivity.y) * ramp;
+
+	// turning left and tilting the front up both read positive, the pointer goes left and up.
+	pointer->total[0] -= yaw * sensitivity_x * tightening * dt;
+	pointer->total[1] -= pitch * sensitivity_y * tightening * dt;
+	pointer->samples++;
+}
+
+static titania_error titania_set_gyro_pointer_impl(titania_context* ctx, const titania_handle handle, const titania_gyro_pointer* config) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	if (hid_state->hid_info.is_access) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	LOCK_INFO(hid_state);
+	titania_pipeline* pipeline = titania_pipeline_edit(hid_state);
+	if (pipeline == nullptr) {
+		UNLOCK_INFO(hid_state);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	if (config == nullptr) {
+		pipeline->pointer.enabled = false;
+		pipeline->pointer.generation++;
+	} else {
+		// movement collected so far is kept, a new curve only applies from the next report.
+		pipeline->pointer.settings = *config;
+		pipeline->pointer.enabled = true;
+	}
+
+	titania_pipeline_publish(hid_state, pipeline);
+	UNLOCK_INFO(hid_state);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_set_gyro_pointer(titania_context* ctx, const titania_handle handle, const titania_gyro_pointer* pointer) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (pointer != nullptr) {
+		if (pointer->space < 0 || pointer->space >= TITANIA_GYRO_SPACE_MAX) {
+			return TITANIA_ERROR_INVALID_ARGUMENT;
+		}
+
+		if (!(pointer->min_speed >= 0.0f && pointer->max_speed >= 0.0f && pointer->tightening >= 0.0f)) {
+			return TITANIA_ERROR_INVALID_ARGUMENT;
+		}
+
+		if (isnan(pointer->min_sensitivity.x) || isnan(pointer->min_sensitivity.y) || isnan(pointer->max_sensitivity.x) || isnan(pointer->max_sensitivity.y)) {
+			return TITANIA_ERROR_INVALID_ARGUMENT;
+		}
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_set_gyro_pointer_impl(ctx, handle, pointer);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+// pull only ever adds to its total, the getter hands out what was added since the last call.
+static titania_error titania_get_gyro_pointer_impl(titania_context* ctx, const titania_handle handle, titania_pointer_delta* delta) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	LOCK_INFO(hid_state);
+	if (!hid_state->pipeline_staging.pointer.enabled) {
+		UNLOCK_INFO(hid_state);
+		memset(delta, 0, sizeof(titania_pointer_delta));
+		return TITANIA_ERROR_OK;
+	}
+
+	const titania_results* results = titania_results_read(hid_state);
+	if (results->pointer_generation != hid_state->pointer_taken_generation) {
+		// pull started the total over.
+		hid_state->pointer_taken[0] = 0.0;
+		hid_state->pointer_taken[1] = 0.0;
+		hid_state->pointer_taken_samples = 0;
+		hid_state->pointer_taken_generation = results->pointer_generation;
+	}
+
+	delta->delta = (titania_vector2) { { (float) (results->pointer[0] - hid_state->pointer_taken[0]) }, { (float) (results->pointer[1] - hid_state->pointer_taken[1]) } };
+	delta->samples = results->pointer_samples - hid_state->pointer_taken_samples;
+	delta->sensor_time = results->pointer_time;
+	hid_state->pointer_taken[0] = results->pointer[0];
+	hid_state->pointer_taken[1] = results->pointer[1];
+	hid_state->pointer_taken_samples = results->pointer_samples;
+	UNLOCK_INFO(hid_state);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_get_gyro_pointer(titania_context* ctx, const titania_handle handle, titania_pointer_delta* delta) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (delta == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_get_gyro_pointer_impl(ctx, handle, delta);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
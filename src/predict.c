@@ -0,0 +1,223 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <math.h>
+#include <string.h>
+
+#include "structures.h"
+
+#define TITANIA_PREDICTION_MAX_HORIZON (100000000ll) // nanoseconds
+#define TITANIA_PREDICTION_MAX_GAP (100000000ull) // nanoseconds between reports, longer gaps start over
+#define TITANIA_PREDICTION_DRIFT (10000) // the clock offset may creep up by one part in this, about the skew between two crystals
+#define TITANIA_PREDICTION_STICK_MAX (255.0f / 256.0f)
+
+static float titania_prediction_clamp(const float value, const float low, const float high) { return value < low ? low : value > high ? high : value; }
+
+void titania_prediction_update(dualsense_state* hid_state) {
+	if (hid_state->pipeline->prediction.model == TITANIA_PREDICTION_NONE) {
+		return;
+	}
+
+	titania_prediction_state* prediction = &hid_state->prediction;
+	const dualsense_sensors* sensors = &hid_state->input.data.msg.data.sensors;
+	// the sensor clock wraps every 24 minutes, adding up the steps keeps it going.
+	const uint32_t step = sensors->time - (uint32_t) prediction->sensor_ticks;
+	if (prediction->count > 0 && step == 0) { // the same sample read twice.
+		return;
+	}
+
+	prediction->sensor_ticks = prediction->count > 0 ? prediction->sensor_ticks + step : sensors->time;
+	const uint64_t time = prediction->sensor_ticks * 1000ull / 3ull;
+	const uint64_t host_time = titania_host_time();
+	const int64_t offset = (int64_t) (host_time - time);
+	if (prediction->count > 0 && time - prediction->time[prediction->head] > TITANIA_PREDICTION_MAX_GAP) {
+		prediction->count = 0;
+	}
+
+	// reports only ever arrive late, the quickest one is the closest to the real offset between the clocks.
+	if (prediction->count == 0) {
+		prediction->clock_offset = offset;
+	} else {
+		const int64_t drift = (int64_t) ((time - prediction->time[prediction->head]) / TITANIA_PREDICTION_DRIFT);
+		prediction->clock_offset = offset < prediction->clock_offset + drift ? offset : prediction->clock_offset + drift;
+	}
+
+	titania_data* data = &prediction->latest;
+	hid_state->decode(&hid_state->hid_info, hid_state->input.data.msg.buffer, data, hid_state->calibration);
+	titania_curve_apply(hid_state, data, nullptr);
+
+	const titania_calibration_scale* calibration = hid_state->calibration;
+	prediction->head = (prediction->head + 1) % TITANIA_PREDICTION_SAMPLES;
+	prediction->time[prediction->head] = time;
+	float* value = prediction->value[prediction->head];
+	value[0] = data->sticks[TITANIA_LEFT].x;
+	value[1] = data->sticks[TITANIA_LEFT].y;
+	value[2] = data->sticks[TITANIA_RIGHT].x;
+	value[3] = data->sticks[TITANIA_RIGHT].y;
+	value[4] = data->triggers[TITANIA_LEFT].level;
+	value[5] = data->triggers[TITANIA_RIGHT].level;
+	value[6] = data->sensors.gyro.x;
+	value[7] = data->sensors.gyro.y;
+	value[8] = data->sensors.gyro.z;
+	value[9] = titania_fusion_calibrate(sensors->gyro.x - calibration[CALIBRATION_GYRO_X].bias, &calibration[CALIBRATION_GYRO_X]) * DUALSENSE_GYRO_RADIANS;
+	value[10] = titania_fusion_calibrate(sensors->gyro.y - calibration[CALIBRATION_GYRO_Y].bias, &calibration[CALIBRATION_GYRO_Y]) * DUALSENSE_GYRO_RADIANS;
+	value[11] = titania_fusion_calibrate(sensors->gyro.z - calibration[CALIBRATION_GYRO_Z].bias, &calibration[CALIBRATION_GYRO_Z]) * DUALSENSE_GYRO_RADIANS;
+	if (prediction->count < TITANIA_PREDICTION_SAMPLES) {
+		prediction->count++;
+	}
+}
+
+static titania_error titania_set_prediction_impl(titania_context* ctx, const titania_handle handle, const titania_prediction_model model) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	if (hid_state->hid_info.is_access) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	LOCK_INFO(hid_state);
+	titania_pipeline* pipeline = titania_pipeline_edit(hid_state);
+	if (pipeline == nullptr) {
+		UNLOCK_INFO(hid_state);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	// switching models keeps the reports collected so far, turning prediction off drops them.
+	pipeline->prediction.model = model;
+	if (model == TITANIA_PREDICTION_NONE) {
+		pipeline->prediction.generation++;
+	}
+
+	titania_pipeline_publish(hid_state, pipeline);
+	UNLOCK_INFO(hid_state);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_set_prediction(titania_context* ctx, const titania_handle handle, const titania_prediction_model model) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (model < 0 || model >= TITANIA_PREDICTION_MAX) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_set_prediction_impl(ctx, handle, model);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+// q * exp(angle / 2), the rotation is in controller space like the gyro.
+static void titania_prediction_rotate(const float q[4], const float angle[3], float out[4]) {
+	const float length = sqrtf(angle[0] * angle[0] + angle[1] * angle[1] + angle[2] * angle[2]);
+	if (length <= 0.0f) {
+		memcpy(out, q, sizeof(float) * 4);
+		return;
+	}
+
+	const float s = sinf(length / 2.0f) / length;
+	const float d[4] = { cosf(length / 2.0f), angle[0] * s, angle[1] * s, angle[2] * s };
+	out[0] = q[0] * d[0] - q[1] * d[1] - q[2] * d[2] - q[3] * d[3];
+	out[1] = q[0] * d[1] + q[1] * d[0] + q[2] * d[3] - q[3] * d[2];
+	out[2] = q[0] * d[2] - q[1] * d[3] + q[2] * d[0] + q[3] * d[1];
+	out[3] = q[0] * d[3] + q[1] * d[2] - q[2] * d[1] + q[3] * d[0];
+}
+
+static titania_error titania_predict_impl(titania_context* ctx, const titania_handle handle, const uint64_t target_host_time, titania_data* data, titania_orientation* orientation) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	LOCK_INFO(hid_state);
+	const titania_prediction_model model = hid_state->pipeline_staging.prediction.model;
+	const bool has_fusion = hid_state->pipeline_staging.fusion.enabled;
+	const titania_results* results = titania_results_read(hid_state);
+	titania_prediction_state prediction = results->prediction;
+	titania_fusion_state fusion = results->fusion;
+	// whatever pull made with settings that were replaced since is left out.
+	if (results->prediction_generation != hid_state->pipeline_staging.prediction.generation) {
+		prediction.count = 0;
+	}
+
+	if (results->fusion_generation != hid_state->pipeline_staging.fusion.generation) {
+		memset(&fusion, 0, sizeof(titania_fusion_state));
+		fusion.q[0] = 1.0f;
+	}
+
+	titania_calibration_scale calibration[6];
+	titania_results_calibration(hid_state, results, calibration);
+	UNLOCK_INFO(hid_state);
+
+	if (model == TITANIA_PREDICTION_NONE || (orientation != nullptr && !has_fusion)) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	if (prediction.count == 0) {
+		return TITANIA_ERROR_INVALID_DATA;
+	}
+
+	const uint32_t newest = prediction.head;
+	const uint32_t older = (newest + TITANIA_PREDICTION_SAMPLES - 1) % TITANIA_PREDICTION_SAMPLES;
+	int64_t horizon = (int64_t) (target_host_time - (uint64_t) prediction.clock_offset - prediction.time[newest]);
+	horizon = horizon < 0 ? 0 : horizon > TITANIA_PREDICTION_MAX_HORIZON ? TITANIA_PREDICTION_MAX_HORIZON : horizon;
+	const float h = (float) horizon / 1000000000.0f;
+
+	// sticks and triggers keep their rate between the last two reports. the gyro is a rate already,
+	// it only changes when it is predicted to keep accelerating.
+	const int lanes = model == TITANIA_PREDICTION_ACCELERATION ? TITANIA_PREDICTION_LANES : 6;
+	float rate[TITANIA_PREDICTION_LANES] = { 0 };
+	if (prediction.count >= 2) {
+		const float dt = (float) (prediction.time[newest] - prediction.time[older]) / 1000000000.0f;
+		for (int j = 0; j < lanes; ++j) {
+			rate[j] = (prediction.value[newest][j] - prediction.value[older][j]) / dt;
+		}
+	}
+
+	float value[TITANIA_PREDICTION_LANES];
+	for (int j = 0; j < TITANIA_PREDICTION_LANES; ++j) {
+		value[j] = prediction.value[newest][j] + rate[j] * h;
+	}
+
+	*data = prediction.latest;
+	data->time.sensor += (uint32_t) (horizon * 3 / 1000);
+	data->sticks[TITANIA_LEFT].x = titania_prediction_clamp(value[0], 0.0f, TITANIA_PREDICTION_STICK_MAX);
+	data->sticks[TITANIA_LEFT].y = titania_prediction_clamp(value[1], 0.0f, TITANIA_PREDICTION_STICK_MAX);
+	data->sticks[TITANIA_RIGHT].x = titania_prediction_clamp(value[2], 0.0f, TITANIA_PREDICTION_STICK_MAX);
+	data->sticks[TITANIA_RIGHT].y = titania_prediction_clamp(value[3], 0.0f, TITANIA_PREDICTION_STICK_MAX);
+	data->triggers[TITANIA_LEFT].level = titania_prediction_clamp(value[4], 0.0f, 1.0f);
+	data->triggers[TITANIA_RIGHT].level = titania_prediction_clamp(value[5], 0.0f, 1.0f);
+
+	// the gyro can't read past the int16 range of the sensor.
+	float* gyro[3] = { &data->sensors.gyro.x, &data->sensors.gyro.y, &data->sensors.gyro.z };
+	for (int j = 0; j < 3; ++j) {
+		const float limit = fmaxf(fabsf(calibration[j].scale[0]), fabsf(calibration[j].scale[1])) * 32768.0f;
+		*gyro[j] = titania_prediction_clamp(value[6 + j], -limit, limit);
+	}
+
+	if (orientation != nullptr) {
+		// the turn between the newest report and the target, the average rate over it is halfway to the predicted rate.
+		const float angle[3] = {
+			(prediction.value[newest][9] + value[9]) / 2.0f * h,
+			(prediction.value[newest][10] + value[10]) / 2.0f * h,
+			(prediction.value[newest][11] + value[11]) / 2.0f * h,
+		};
+
+		float q[4];
+		titania_prediction_rotate(fusion.q, angle, q);
+		titania_fusion_orientation(q, orientation);
+		orientation->sensor_time = data->time.sensor;
+		orientation->samples = fusion.samples;
+	}
+
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_ctx_predict(titania_context* ctx, const titania_handle handle, const uint64_t target_host_time, titania_data* data, titania_orientation* orientation) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (data == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_predict_impl(ctx, handle, target_host_time, data, orientation);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
@@ -0,0 +1,279 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#include <string.h>
+
+#include "structures.h"
+
+// titania_edge_button_id to the titania_button_mask bit it presses.
+static const uint32_t titania_remap_edge_mask[TITANIA_BUTTON_ID_MAX] = {
+	[TITANIA_BUTTON_ID_UP] = TITANIA_BUTTON_MASK_DPAD_UP,
+	[TITANIA_BUTTON_ID_LEFT] = TITANIA_BUTTON_MASK_DPAD_LEFT,
+	[TITANIA_BUTTON_ID_DOWN] = TITANIA_BUTTON_MASK_DPAD_DOWN,
+	[TITANIA_BUTTON_ID_RIGHT] = TITANIA_BUTTON_MASK_DPAD_RIGHT,
+	[TITANIA_BUTTON_ID_CIRCLE] = TITANIA_BUTTON_MASK_CIRCLE,
+	[TITANIA_BUTTON_ID_CROSS] = TITANIA_BUTTON_MASK_CROSS,
+	[TITANIA_BUTTON_ID_SQUARE] = TITANIA_BUTTON_MASK_SQUARE,
+	[TITANIA_BUTTON_ID_TRIANGLE] = TITANIA_BUTTON_MASK_TRIANGLE,
+	[TITANIA_BUTTON_ID_R1] = TITANIA_BUTTON_MASK_R1,
+	[TITANIA_BUTTON_ID_R2] = TITANIA_BUTTON_MASK_R2,
+	[TITANIA_BUTTON_ID_R3] = TITANIA_BUTTON_MASK_R3,
+	[TITANIA_BUTTON_ID_L1] = TITANIA_BUTTON_MASK_L1,
+	[TITANIA_BUTTON_ID_L2] = TITANIA_BUTTON_MASK_L2,
+	[TITANIA_BUTTON_ID_L3] = TITANIA_BUTTON_MASK_L3,
+	[TITANIA_BUTTON_ID_LEFT_PADDLE] = TITANIA_BUTTON_MASK_EDGE_LEFT_PADDLE,
+	[TITANIA_BUTTON_ID_RIGHT_PADDLE] = TITANIA_BUTTON_MASK_EDGE_RIGHT_PADDLE,
+	[TITANIA_BUTTON_ID_OPTION] = TITANIA_BUTTON_MASK_OPTION,
+	[TITANIA_BUTTON_ID_TOUCH] = TITANIA_BUTTON_MASK_TOUCH,
+};
+
+// the physical button behind each slot of titania_edge_button_remap.
+static const uint32_t titania_remap_edge_source[0x10] = {
+	TITANIA_BUTTON_MASK_DPAD_UP,
+	TITANIA_BUTTON_MASK_DPAD_DOWN,
+	TITANIA_BUTTON_MASK_DPAD_LEFT,
+	TITANIA_BUTTON_MASK_DPAD_RIGHT,
+	TITANIA_BUTTON_MASK_CIRCLE,
+	TITANIA_BUTTON_MASK_CROSS,
+	TITANIA_BUTTON_MASK_SQUARE,
+	TITANIA_BUTTON_MASK_TRIANGLE,
+	TITANIA_BUTTON_MASK_R1,
+	TITANIA_BUTTON_MASK_R2,
+	TITANIA_BUTTON_MASK_R3,
+	TITANIA_BUTTON_MASK_L1,
+	TITANIA_BUTTON_MASK_L2,
+	TITANIA_BUTTON_MASK_L3,
+	TITANIA_BUTTON_MASK_EDGE_LEFT_PADDLE,
+	TITANIA_BUTTON_MASK_EDGE_RIGHT_PADDLE,
+};
+
+// titania_access_button_id to the titania_button_mask bit it presses.
+static const uint32_t titania_remap_access_mask[TITANIA_ACCESS_BUTTON_ID_MAX] = {
+	[TITANIA_ACCESS_BUTTON_ID_NONE] = 0,
+	[TITANIA_ACCESS_BUTTON_ID_CIRCLE] = TITANIA_BUTTON_MASK_CIRCLE,
+	[TITANIA_ACCESS_BUTTON_ID_CROSS] = TITANIA_BUTTON_MASK_CROSS,
+	[TITANIA_ACCESS_BUTTON_ID_TRIANGLE] = TITANIA_BUTTON_MASK_TRIANGLE,
+	[TITANIA_ACCESS_BUTTON_ID_SQUARE] = TITANIA_BUTTON_MASK_SQUARE,
+	[TITANIA_ACCESS_BUTTON_ID_UP] = TITANIA_BUTTON_MASK_DPAD_UP,
+	[TITANIA_ACCESS_BUTTON_ID_DOWN] = TITANIA_BUTTON_MASK_DPAD_DOWN,
+	[TITANIA_ACCESS_BUTTON_ID_LEFT] = TITANIA_BUTTON_MASK_DPAD_LEFT,
+	[TITANIA_ACCESS_BUTTON_ID_RIGHT] = TITANIA_BUTTON_MASK_DPAD_RIGHT,
+	[TITANIA_ACCESS_BUTTON_ID_L1] = TITANIA_BUTTON_MASK_L1,
+	[TITANIA_ACCESS_BUTTON_ID_R1] = TITANIA_BUTTON_MASK_R1,
+	[TITANIA_ACCESS_BUTTON_ID_L2] = TITANIA_BUTTON_MASK_L2,
+	[TITANIA_ACCESS_BUTTON_ID_R2] = TITANIA_BUTTON_MASK_R2,
+	[TITANIA_ACCESS_BUTTON_ID_L3] = TITANIA_BUTTON_MASK_L3,
+	[TITANIA_ACCESS_BUTTON_ID_R3] = TITANIA_BUTTON_MASK_R3,
+	[TITANIA_ACCESS_BUTTON_ID_OPTIONS] = TITANIA_BUTTON_MASK_OPTION,
+	[TITANIA_ACCESS_BUTTON_ID_CREATE] = TITANIA_BUTTON_MASK_CREATE,
+	[TITANIA_ACCESS_BUTTON_ID_PLAYSTATION] = TITANIA_BUTTON_MASK_PLAYSTATION,
+	[TITANIA_ACCESS_BUTTON_ID_TOUCH] = TITANIA_BUTTON_MASK_TOUCH,
+};
+
+// the physical button behind each slot of titania_access_profile_buttons.
+static const uint32_t titania_remap_access_source[10] = {
+	TITANIA_ACCESS_BUTTON_MASK_CENTER,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON1,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON2,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON3,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON4,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON5,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON6,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON7,
+	TITANIA_ACCESS_BUTTON_MASK_BUTTON8,
+	TITANIA_ACCESS_BUTTON_MASK_STICK,
+};
+
+static int titania_remap_bit(const uint32_t mask) {
+	int bit = 0;
+	while (bit < 31 && (mask & (1u << bit)) == 0) {
+		bit++;
+	}
+
+	return bit;
+}
+
+static uint32_t titania_remap_pack_buttons(const titania_buttons* buttons) {
+	const bool pressed[25] = {
+		buttons->dpad_up, buttons->dpad_right, buttons->dpad_down, buttons->dpad_left,
+		buttons->square, buttons->cross, buttons->circle, buttons->triangle,
+		buttons->l1, buttons->r1, buttons->l2, buttons->r2,
+		buttons->create, buttons->option, buttons->l3, buttons->r3,
+		buttons->playstation, buttons->touch, buttons->mute, buttons->reserved,
+		buttons->edge_f1, buttons->edge_f2, buttons->edge_left_paddle, buttons->edge_right_paddle,
+		buttons->touchpad,
+	};
+
+	uint32_t mask = 0;
+	for (int bit = 0; bit < 25; ++bit) {
+		mask |= (uint32_t) pressed[bit] << bit;
+	}
+
+	return mask;
+}
+
+// spreads the output of every source bit over four byte-indexed tables, so remapping a word is four lookups.
+static void titania_remap_compile(titania_remap_config* remap, const uint32_t target[32]) {
+	memset(remap->table, 0, sizeof(remap->table));
+	for (int byte = 0; byte < 4; ++byte) {
+		for (int value = 0; value < 256; ++value) {
+			uint32_t output = 0;
+			for (int bit = 0; bit < 8; ++bit) {
+				if (value & (1 << bit)) {
+					output |= target[byte * 8 + bit];
+				}
+			}
+
+			remap->table[byte][value] = output;
+		}
+	}
+}
+
+static uint32_t titania_remap_shuffle(const titania_remap_config* remap, const uint32_t source) { return remap->table[0][source & 0xFF] | remap->table[1][(source >> 8) & 0xFF] | remap->table[2][(source >> 16) & 0xFF] | remap->table[3][source >> 24]; }
+
+void titania_remap_apply(dualsense_state* hid_state, titania_data* data, titania_data_fixed* fixed) {
+	const titania_remap_config* config = &hid_state->pipeline->remap;
+	if (!config->enabled) {
+		return;
+	}
+
+	titania_remap_state* remap = &hid_state->remap;
+	const dualsense_input_msg* input = &hid_state->input.data.msg.data;
+	uint32_t source = hid_state->hid_info.is_access ? titania_convert_access_buttons(input) : titania_convert_buttons(input, false);
+
+	// toggles flip on press and hold their target until the next press.
+	remap->latched ^= source & ~remap->previous & config->toggle;
+	remap->previous = source;
+	source = (source & ~config->toggle) | remap->latched;
+
+	const uint32_t buttons = titania_remap_shuffle(config, source);
+	if (data != nullptr) {
+		titania_expand_buttons(buttons, &data->buttons);
+	}
+
+	if (fixed != nullptr) {
+		fixed->buttons = buttons;
+	}
+}
+
+// hands the compiled remap (or nullptr to turn remapping off) to pull, toggles start over.
+static titania_error titania_remap_publish(dualsense_state* hid_state, const titania_remap_config* remap) {
+	LOCK_INFO(hid_state);
+	titania_pipeline* pipeline = titania_pipeline_edit(hid_state);
+	if (pipeline == nullptr) {
+		UNLOCK_INFO(hid_state);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	const uint32_t generation = pipeline->remap.generation + 1;
+	if (remap != nullptr) {
+		pipeline->remap = *remap;
+	} else {
+		pipeline->remap.enabled = false;
+	}
+
+	pipeline->remap.generation = generation;
+	titania_pipeline_publish(hid_state, pipeline);
+	UNLOCK_INFO(hid_state);
+	return TITANIA_ERROR_OK;
+}
+
+static titania_error titania_set_button_remap_impl(titania_context* ctx, const titania_handle handle, const titania_edge_button_remap* buttons, const titania_buttons* disabled) {
+	dualsense_state* hid_state = &ctx->state[handle];
+	if (hid_state->hid_info.is_access) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	if (buttons == nullptr && disabled == nullptr) {
+		return titania_remap_publish(hid_state, nullptr);
+	}
+
+	// buttons without a slot in titania_edge_button_remap keep their place.
+	uint32_t target[32];
+	for (int bit = 0; bit < 32; ++bit) {
+		target[bit] = 1u << bit;
+	}
+
+	if (buttons != nullptr) {
+		for (int j = 0; j < 0x10; ++j) {
+			target[titania_remap_bit(titania_remap_edge_source[j])] = titania_remap_edge_mask[buttons->values[j]];
+		}
+	}
+
+	if (disabled != nullptr) {
+		const uint32_t mask = titania_remap_pack_buttons(disabled);
+		for (int bit = 0; bit < 32; ++bit) {
+			if (mask & (1u << bit)) {
+				target[bit] = 0;
+			}
+		}
+	}
+
+	titania_remap_config remap = { 0 };
+	titania_remap_compile(&remap, target);
+	remap.enabled = true;
+	return titania_remap_publish(hid_state, &remap);
+}
+
+titania_error titania_ctx_set_button_remap(titania_context* ctx, const titania_handle handle, const titania_edge_button_remap* buttons, const titania_buttons* disabled) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (buttons != nullptr) {
+		for (int j = 0; j < 0x10; ++j) {
+			if (buttons->values[j] < 0 || buttons->values[j] >= TITANIA_BUTTON_ID_MAX) {
+				return TITANIA_ERROR_INVALID_ARGUMENT;
+			}
+		}
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_set_button_remap_impl(ctx, handle, buttons, disabled);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
+
+static titania_error titania_set_access_button_remap_impl(titania_context* ctx, const titania_handle handle, const titania_access_profile_buttons* buttons) {
+	CHECK_ACCESS(ctx, handle);
+
+	dualsense_state* hid_state = &ctx->state[handle];
+	if (buttons == nullptr) {
+		return titania_remap_publish(hid_state, nullptr);
+	}
+
+	// everything comes from the raw access buttons, the playstation button is the only one without a profile slot.
+	uint32_t target[32] = { 0 };
+	target[titania_remap_bit(TITANIA_ACCESS_BUTTON_MASK_PLAYSTATION)] = TITANIA_BUTTON_MASK_PLAYSTATION;
+
+	titania_remap_config remap = { 0 };
+	for (int j = 0; j < 10; ++j) {
+		const titania_access_profile_button* button = &buttons->values[j];
+		target[titania_remap_bit(titania_remap_access_source[j])] = titania_remap_access_mask[button->primary] | titania_remap_access_mask[button->secondary];
+		if (button->toggle) {
+			remap.toggle |= titania_remap_access_source[j];
+		}
+	}
+
+	titania_remap_compile(&remap, target);
+	remap.enabled = true;
+	return titania_remap_publish(hid_state, &remap);
+}
+
+titania_error titania_ctx_set_access_button_remap(titania_context* ctx, const titania_handle handle, const titania_access_profile_buttons* buttons) {
+	CHECK_INIT(ctx);
+	CHECK_HANDLE(handle);
+
+	if (buttons != nullptr) {
+		for (int j = 0; j < 10; ++j) {
+			if (buttons->values[j].primary < 0 || buttons->values[j].primary >= TITANIA_ACCESS_BUTTON_ID_MAX || buttons->values[j].secondary < 0 || buttons->values[j].secondary >= TITANIA_ACCESS_BUTTON_ID_MAX) {
+				return TITANIA_ERROR_INVALID_ARGUMENT;
+			}
+		}
+	}
+
+	ACQUIRE_HANDLE(ctx, handle);
+	const titania_error result = titania_set_access_button_remap_impl(ctx, handle, buttons);
+	RELEASE_HANDLE(ctx, handle);
+	return result;
+}
@@ -0,0 +1,380 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "structures.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define TITANIA_SHARED_MAGIC (0x4D485354) // TSHM
+#define TITANIA_SHARED_VERSION (1)
+#define TITANIA_SHARED_RETRIES (16) // reads of the newest report before giving up, each one only fails if the reader stalled for a whole ring
+
+static_assert((TITANIA_SHARED_HISTORY & (TITANIA_SHARED_HISTORY - 1)) == 0, "TITANIA_SHARED_HISTORY is not a power of two");
+static_assert((TITANIA_SHARED_COMMANDS & (TITANIA_SHARED_COMMANDS - 1)) == 0, "TITANIA_SHARED_COMMANDS is not a power of two");
+// an atomic that falls back to a lock would only be atomic within one process.
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "atomic_uint is not lock free");
+
+// a seqlock per report: odd while the publisher writes it, 2 * (report number + 1) once it is complete.
+typedef struct titania_shared_entry {
+	atomic_uint sequence;
+	titania_data data;
+} titania_shared_entry;
+
+typedef struct titania_shared_slot {
+	alignas(TITANIA_CACHE_LINE) atomic_uint head; // reports published so far, the newest is at (head - 1) & (TITANIA_SHARED_HISTORY - 1)
+	atomic_uint connected;
+	titania_shared_entry entries[TITANIA_SHARED_HISTORY];
+} titania_shared_slot;
+
+// a bounded queue with many producers (the readers) and a single consumer (the publisher).
+// a cell is free for report number n while its sequence is n, and holds it once the sequence is n + 1.
+typedef struct titania_shared_cell {
+	atomic_uint sequence;
+	titania_shared_command command;
+} titania_shared_cell;
+
+// the layout is checked field by field on open, a reader built with different sizes refuses to attach.
+typedef struct titania_shared_segment {
+	atomic_uint magic; // written last by the publisher
+	uint32_t version;
+	uint32_t slot_count;
+	uint32_t data_size;
+	uint32_t command_size;
+	uint32_t history;
+	uint32_t commands;
+	alignas(TITANIA_CACHE_LINE) atomic_uint command_head;
+	alignas(TITANIA_CACHE_LINE) atomic_uint command_tail;
+	titania_shared_cell cells[TITANIA_SHARED_COMMANDS];
+	titania_shared_slot slots[TITANIA_MAX_CONTROLLERS];
+} titania_shared_segment;
+
+struct titania_shared {
+	titania_shared_segment* segment;
+#ifdef _WIN32
+	HANDLE mapping;
+#endif
+	bool is_publisher;
+};
+
+static bool titania_shared_path(const char* name, char path[TITANIA_SHARED_NAME_SIZE + 8]) {
+	if (name == nullptr) {
+		name = TITANIA_SHARED_DEFAULT_NAME;
+	}
+
+	const size_t length = strlen(name);
+	if (length == 0 || length >= TITANIA_SHARED_NAME_SIZE || strchr(name, '/') != nullptr || strchr(name, '\\') != nullptr) {
+		return false;
+	}
+
+#ifdef _WIN32
+	snprintf(path, TITANIA_SHARED_NAME_SIZE + 8, "Local\\%s", name);
+#else
+	snprintf(path, TITANIA_SHARED_NAME_SIZE + 8, "/%s", name);
+#endif
+	return true;
+}
+
+static titania_error titania_shared_map(const char* name, const bool create, titania_shared** shared) {
+	if (shared == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	char path[TITANIA_SHARED_NAME_SIZE + 8];
+	if (!titania_shared_path(name, path)) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	titania_shared* result = calloc(1, sizeof(titania_shared));
+	if (result == nullptr) {
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+#ifdef _WIN32
+	const uint64_t size = sizeof(titania_shared_segment);
+	HANDLE mapping = create ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD) (size >> 32), (DWORD) size, path) : OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, path);
+	if (mapping == nullptr) {
+		free(result);
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	titania_shared_segment* segment = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(titania_shared_segment));
+	if (segment == nullptr) {
+		CloseHandle(mapping);
+		free(result);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+
+	result->mapping = mapping;
+#else
+	// readers have to write too, the command queue lives in the same segment.
+	const int file = shm_open(path, create ? O_RDWR | O_CREAT : O_RDWR, 0660);
+	if (file < 0) {
+		free(result);
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || (create && info.st_size != sizeof(titania_shared_segment) && ftruncate(file, sizeof(titania_shared_segment)) != 0) || (!create && info.st_size < (off_t) sizeof(titania_shared_segment))) {
+		close(file);
+		free(result);
+		return create ? TITANIA_ERROR_INVALID_ARGUMENT : TITANIA_ERROR_INVALID_LIBRARY;
+	}
+
+	titania_shared_segment* segment = mmap(nullptr, sizeof(titania_shared_segment), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	close(file); // the mapping keeps the segment alive.
+	if (segment == MAP_FAILED) {
+		free(result);
+		return TITANIA_ERROR_OUT_OF_MEMORY;
+	}
+#endif
+
+	result->segment = segment;
+	result->is_publisher = create;
+	*shared = result;
+	return TITANIA_ERROR_OK;
+}
+
+static void titania_shared_unmap(titania_shared* shared) {
+#ifdef _WIN32
+	UnmapViewOfFile(shared->segment);
+	CloseHandle(shared->mapping);
+#else
+	munmap(shared->segment, sizeof(titania_shared_segment));
+#endif
+	free(shared);
+}
+
+titania_error titania_shared_create(const char* name, titania_shared** shared) {
+	const titania_error result = titania_shared_map(name, true, shared);
+	if (IS_TITANIA_BAD(result)) {
+		return result;
+	}
+
+	// readers still attached to a previous publisher see the magic go away, then every slot start over.
+	titania_shared_segment* segment = (*shared)->segment;
+	atomic_store_explicit(&segment->magic, 0, memory_order_release);
+	memset((uint8_t*) segment + sizeof(atomic_uint), 0, sizeof(titania_shared_segment) - sizeof(atomic_uint));
+	segment->version = TITANIA_SHARED_VERSION;
+	segment->slot_count = TITANIA_MAX_CONTROLLERS;
+	segment->data_size = sizeof(titania_data);
+	segment->command_size = sizeof(titania_shared_command);
+	segment->history = TITANIA_SHARED_HISTORY;
+	segment->commands = TITANIA_SHARED_COMMANDS;
+	for (uint32_t i = 0; i < TITANIA_SHARED_COMMANDS; ++i) {
+		atomic_init(&segment->cells[i].sequence, i);
+	}
+
+	atomic_store_explicit(&segment->magic, TITANIA_SHARED_MAGIC, memory_order_release);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_shared_open(const char* name, titania_shared** shared) {
+	const titania_error result = titania_shared_map(name, false, shared);
+	if (IS_TITANIA_BAD(result)) {
+		return result;
+	}
+
+	const titania_shared_segment* segment = (*shared)->segment;
+	if (atomic_load_explicit(&segment->magic, memory_order_acquire) != TITANIA_SHARED_MAGIC || segment->version != TITANIA_SHARED_VERSION || segment->slot_count != TITANIA_MAX_CONTROLLERS || segment->data_size != sizeof(titania_data) || segment->command_size != sizeof(titania_shared_command) || segment->history != TITANIA_SHARED_HISTORY || segment->commands != TITANIA_SHARED_COMMANDS) {
+		titania_shared_unmap(*shared);
+		*shared = nullptr;
+		return TITANIA_ERROR_INVALID_LIBRARY;
+	}
+
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_shared_publish(titania_shared* shared, const titania_data* data) {
+	if (shared == nullptr || data == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	if (!shared->is_publisher) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	CHECK_HANDLE(data->hid.handle);
+
+	titania_shared_slot* slot = &shared->segment->slots[data->hid.handle];
+	const uint32_t head = atomic_load_explicit(&slot->head, memory_order_relaxed);
+	titania_shared_entry* entry = &slot->entries[head & (TITANIA_SHARED_HISTORY - 1)];
+	atomic_store_explicit(&entry->sequence, head * 2 + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	memcpy(&entry->data, data, sizeof(titania_data));
+	atomic_store_explicit(&entry->sequence, head * 2 + 2, memory_order_release);
+	atomic_store_explicit(&slot->head, head + 1, memory_order_release);
+	atomic_store_explicit(&slot->connected, 1, memory_order_release);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_shared_disconnect(titania_shared* shared, const titania_handle handle) {
+	if (shared == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	if (!shared->is_publisher) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	CHECK_HANDLE(handle);
+
+	atomic_store_explicit(&shared->segment->slots[handle].connected, 0, memory_order_release);
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_shared_get_commands(titania_shared* shared, titania_shared_command* commands, const size_t count, size_t* written) {
+	if (shared == nullptr || commands == nullptr || written == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	if (!shared->is_publisher) {
+		return TITANIA_ERROR_NOT_SUPPORTED;
+	}
+
+	titania_shared_segment* segment = shared->segment;
+	size_t n = 0;
+	while (n < count) {
+		const uint32_t position = atomic_load_explicit(&segment->command_head, memory_order_relaxed);
+		titania_shared_cell* cell = &segment->cells[position & (TITANIA_SHARED_COMMANDS - 1)];
+		// empty, or a reader claimed the cell and is still filling it in.
+		if (atomic_load_explicit(&cell->sequence, memory_order_acquire) != position + 1) {
+			break;
+		}
+
+		commands[n++] = cell->command;
+		atomic_store_explicit(&cell->sequence, position + TITANIA_SHARED_COMMANDS, memory_order_release);
+		atomic_store_explicit(&segment->command_head, position + 1, memory_order_relaxed);
+	}
+
+	*written = n;
+	return TITANIA_ERROR_OK;
+}
+
+// copies report number n out of its entry, false if the publisher overwrote it (or is overwriting it) meanwhile.
+static bool titania_shared_load(const titania_shared_slot* slot, const uint32_t n, titania_data* data) {
+	const titania_shared_entry* entry = &slot->entries[n & (TITANIA_SHARED_HISTORY - 1)];
+	const uint32_t expected = n * 2 + 2;
+	if (atomic_load_explicit(&entry->sequence, memory_order_acquire) != expected) {
+		return false;
+	}
+
+	memcpy(data, &entry->data, sizeof(titania_data));
+	atomic_thread_fence(memory_order_acquire);
+	return atomic_load_explicit(&entry->sequence, memory_order_relaxed) == expected;
+}
+
+titania_error titania_shared_read(titania_shared* shared, const titania_handle handle, titania_data* data, uint32_t* sequence) {
+	if (shared == nullptr || data == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	CHECK_HANDLE(handle);
+
+	const titania_shared_slot* slot = &shared->segment->slots[handle];
+	for (int attempt = 0; attempt < TITANIA_SHARED_RETRIES; ++attempt) {
+		const uint32_t head = atomic_load_explicit(&slot->head, memory_order_acquire);
+		if (head == 0 || atomic_load_explicit(&slot->connected, memory_order_acquire) == 0) {
+			return TITANIA_ERROR_INVALID_HANDLE;
+		}
+
+		if (titania_shared_load(slot, head - 1, data)) {
+			if (sequence != nullptr) {
+				*sequence = head;
+			}
+
+			return TITANIA_ERROR_OK;
+		}
+
+		titania_cpu_relax();
+	}
+
+	return TITANIA_ERROR_INVALID_DATA;
+}
+
+titania_error titania_shared_read_history(titania_shared* shared, const titania_handle handle, titania_data* data, const size_t count, size_t* written) {
+	if (shared == nullptr || data == nullptr || written == nullptr) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	CHECK_HANDLE(handle);
+
+	*written = 0;
+	const titania_shared_slot* slot = &shared->segment->slots[handle];
+	const uint32_t head = atomic_load_explicit(&slot->head, memory_order_acquire);
+	if (head == 0 || atomic_load_explicit(&slot->connected, memory_order_acquire) == 0) {
+		return TITANIA_ERROR_INVALID_HANDLE;
+	}
+
+	uint32_t available = head < TITANIA_SHARED_HISTORY ? head : TITANIA_SHARED_HISTORY;
+	if (available > count) {
+		available = (uint32_t) count;
+	}
+
+	// the oldest reports are the ones the publisher reaches first, any it overwrote are skipped.
+	size_t n = 0;
+	for (uint32_t i = head - available; i != head; ++i) {
+		if (titania_shared_load(slot, i, &data[n])) {
+			n++;
+		}
+	}
+
+	*written = n;
+	return TITANIA_ERROR_OK;
+}
+
+titania_error titania_shared_send(titania_shared* shared, const titania_shared_command* command) {
+	if (shared == nullptr || command == nullptr || command->type < 0 || command->type >= TITANIA_SHARED_COMMAND_MAX) {
+		return TITANIA_ERROR_INVALID_ARGUMENT;
+	}
+
+	CHECK_HANDLE(command->handle);
+
+	titania_shared_segment* segment = shared->segment;
+	uint32_t position = atomic_load_explicit(&segment->command_tail, memory_order_relaxed);
+	titania_shared_cell* cell;
+	for (;;) {
+		cell = &segment->cells[position & (TITANIA_SHARED_COMMANDS - 1)];
+		const int32_t difference = (int32_t) (atomic_load_explicit(&cell->sequence, memory_order_acquire) - position);
+		if (difference == 0) {
+			if (atomic_compare_exchange_weak_explicit(&segment->command_tail, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+				break;
+			}
+		} else if (difference < 0) { // the publisher has not taken the command a full queue ago yet.
+			return TITANIA_ERROR_NO_SLOTS;
+		} else { // another reader took the cell first.
+			position = atomic_load_explicit(&segment->command_tail, memory_order_relaxed);
+		}
+	}
+
+	cell->command = *command;
+	atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+	return TITANIA_ERROR_OK;
+}
+
+void titania_shared_destroy(titania_shared* shared) {
+	if (shared == nullptr) {
+		return;
+	}
+
+	if (shared->is_publisher) {
+		for (int i = 0; i < TITANIA_MAX_CONTROLLERS; ++i) {
+			atomic_store_explicit(&shared->segment->slots[i].connected, 0, memory_order_release);
+		}
+	}
+
+	titania_shared_unmap(shared);
+}
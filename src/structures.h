@@ -8,11 +8,15 @@
 #define TITANIA_STRUCTURES_H
 
 #include <assert.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include <hidapi.h>
 
 #include <titania.h>
+#include <titania_decode.h>
 
 #include <titania_config.h>
 #include <titania_config_internal.h>
@@ -25,6 +29,8 @@ static_assert(__STDC_VERSION__ >= 202000L, "a c2x compiler is required");
 #include "common.h"
 #include "edge.h"
 #include "enums.h"
+#include "sync.h"
+#include "thread.h"
 #include <titania_config.h>
 
 #ifdef TITANIA_HAS_PACK
@@ -197,6 +203,7 @@ typedef struct PACKED dualsense_input_msg {
 } dualsense_input_msg;
 
 static_assert(sizeof(dualsense_input_msg) == 0x40, "dualsense_input_msg is not 64 bytes");
+static_assert(sizeof(dualsense_input_msg) == TITANIA_RAW_REPORT_SIZE, "dualsense_input_msg is not TITANIA_RAW_REPORT_SIZE bytes");
 
 typedef struct PACKED dualsense_input_msg_ex {
 	uint8_t report_id;
@@ -473,22 +480,15 @@ typedef struct titania_calibration_bit {
 	int speed;
 } titania_calibration_bit;
 
-typedef struct PACKED dualsense_state {
-	hid_device* hid;
-	titania_hid hid_info;
-	titania_calibration_bit calibration[6];
-	uint32_t seq;
+typedef union PACKED dualsense_state_input {
+	dualsense_input_msg_ex data;
+	uint8_t buffer[sizeof(dualsense_input_msg_ex)];
+} dualsense_state_input;
 
-	union PACKED dualsense_state_input {
-		dualsense_input_msg_ex data;
-		uint8_t buffer[sizeof(dualsense_input_msg_ex)];
-	} input;
-
-	union PACKED dualsense_state_output {
-		dualsense_output_msg_ex data;
-		uint8_t buffer[sizeof(dualsense_output_msg_ex)];
-	} output;
-} dualsense_state;
+typedef union PACKED dualsense_state_output {
+	dualsense_output_msg_ex data;
+	uint8_t buffer[sizeof(dualsense_output_msg_ex)];
+} dualsense_state_output;
 
 typedef struct PACKED dualsense_bt_pair_msg {
 	uint8_t report_id;
@@ -513,23 +513,679 @@ static_assert(sizeof(dualsense_bt_command_msg) == 0x30, "dualsense_bt_command_ms
 #endif
 #undef PACKED
 
-extern uint32_t crc_seed_input;
-extern uint32_t crc_seed_output;
-extern uint32_t crc_seed_feature;
-extern uint32_t crc_seed_feature_profile;
-extern uint32_t crc_seed_titania;
+// the public titania_calibration, kept under its old name since it is also the cache file layout.
+typedef titania_calibration titania_calibration_scale;
+
+static_assert(sizeof(titania_calibration_scale) == 12, "titania_calibration_scale is not 12 bytes");
+
+// titania_calibration_scale as Q16 multipliers that land directly in the titania_data_fixed fixed point format.
+typedef struct titania_calibration_fixed {
+	int32_t scale[2];
+	int32_t bias;
+} titania_calibration_fixed;
+
+// stick curves compiled into one table per stick, indexed by the raw axis byte. both axes share the table.
+typedef struct titania_curve_state {
+	float value[2][256]; // what titania_data reports
+	int8_t fixed[2][256]; // what titania_data_fixed reports
+	bool enabled[2];
+} titania_curve_state;
+
+#define TITANIA_ACK_QUEUE_SIZE (16) // writes waiting for the controller to echo their state id
+
+typedef struct titania_ack_entry {
+	uint32_t state_id;
+	uint64_t host_time; // when the report was written
+} titania_ack_entry;
+
+// output reports written but not echoed back by an input report yet, for titania_get_output_ack.
+// titania_push adds writes under output_lock and the pulling thread retires them, neither waits for the other.
+// the indices only ever grow and are masked with TITANIA_ACK_QUEUE_SIZE - 1.
+typedef struct titania_ack_state {
+	titania_ack_entry in_flight[TITANIA_ACK_QUEUE_SIZE];
+	atomic_uint head; // the oldest write still waiting, only moved by the pulling thread
+	atomic_uint tail; // only moved by titania_push
+	atomic_uint pushed_state_id;
+	atomic_uint deferred; // pushes held back since the last write
+	atomic_uint dropped; // writes there was no room to track, counted as lost
+	bool backpressure; // guarded by output_lock
+} titania_ack_state;
+
+// what the pulling thread learns from the echoed state ids.
+typedef struct titania_ack_stats {
+	uint32_t acked_state_id;
+	uint32_t acked;
+	uint32_t lost;
+	uint64_t latency; // nanoseconds
+	uint64_t min_latency;
+	uint64_t average_latency;
+} titania_ack_stats;
+
+#define TITANIA_PREDICTION_SAMPLES (2) // enough for a rate
+#define TITANIA_PREDICTION_LANES (12) // sticks (4), triggers (2), gyro as titania_data reports it (3), gyro in radians per second (3)
+
+// the last few reports on the unwrapped sensor timeline, for titania_predict.
+typedef struct titania_prediction_state {
+	titania_data latest; // decoded with stick curves applied
+	float value[TITANIA_PREDICTION_SAMPLES][TITANIA_PREDICTION_LANES];
+	uint64_t time[TITANIA_PREDICTION_SAMPLES]; // sensor nanoseconds, unwrapped
+	uint64_t sensor_ticks; // unwrapped sensor clock of the newest report
+	int64_t clock_offset; // host minus sensor nanoseconds, the smallest seen
+	uint32_t count;
+	uint32_t head; // slot of the newest report
+} titania_prediction_state;
+
+typedef struct titania_prediction_config {
+	titania_prediction_model model;
+	uint32_t generation; // changed whenever the collected reports should be dropped
+} titania_prediction_config;
+
+typedef struct titania_pointer_state {
+	float up[3]; // unit vector away from the ground in controller space, for world and player space
+	double total[2]; // everything collected since the pointer was turned on, titania_get_gyro_pointer hands out the difference
+	uint32_t samples; // reports that went into total, wraps
+	uint32_t sensor_time;
+	bool has_sample;
+} titania_pointer_state;
+
+typedef struct titania_pointer_config {
+	titania_gyro_pointer settings;
+	uint32_t generation; // changed whenever the collected movement should be dropped
+	bool enabled;
+} titania_pointer_config;
+
+typedef struct titania_gesture_finger {
+	float start[2];
+	float last[2];
+	float velocity[2]; // units per second, smoothed over touch samples
+	float travel; // squared, the furthest the finger got from start
+	uint8_t id;
+	bool active;
+} titania_gesture_finger;
+
+// the touchpad as of the last touch sample, and what the fingers on it are doing.
+typedef struct titania_gesture_state {
+	titania_gesture_finger fingers[2];
+	float pair_start[2]; // between both fingers, when the second one landed
+	float pair_last[2];
+	float distance_start;
+	float distance_last;
+	float distance_velocity;
+	float travel; // squared, the furthest any finger got since the first one landed
+	uint32_t sensor_time; // of the last touch sample
+	uint32_t touch_time; // when the first finger landed
+	uint8_t touch[8]; // the raw touch points of the last touch sample
+	uint8_t sequence;
+	uint8_t max_fingers;
+	uint8_t mode;
+	bool has_sample;
+	bool has_pair;
+} titania_gesture_state;
+
+typedef struct titania_gesture_config {
+	uint32_t generation; // changed whenever recognition should start over
+	bool enabled;
+} titania_gesture_config;
+
+// button remaps compiled into one table per byte of the packed source buttons, the output is the four lookups or'd together.
+// the source is titania_convert_buttons, or titania_convert_access_buttons on access controllers.
+typedef struct titania_remap_config {
+	uint32_t table[4][256]; // titania_button_mask
+	uint32_t toggle; // source buttons that latch instead of being held
+	uint32_t generation; // changed whenever the toggles should start over
+	bool enabled;
+} titania_remap_config;
+
+typedef struct titania_remap_state {
+	uint32_t previous; // the source buttons of the last report
+	uint32_t latched; // toggles that are currently on
+} titania_remap_state;
+
+#define TITANIA_FILTER_LANES (16) // sticks (4), triggers (2), gyro (3), accelerometer (3), and padding
+
+// filter settings for every channel side by side, so one pass over the lanes filters everything.
+// a lane's mode is picked by its weights instead of a branch: median selects the median of 3 input,
+// one_euro selects the adaptive smoothing factor over alpha, and alpha is 1 for lanes that pass through.
+// kept at the alignment malloc gives, titania_pipeline is allocated.
+typedef struct titania_filter_config {
+	float alpha[TITANIA_FILTER_LANES];
+	float median[TITANIA_FILTER_LANES];
+	float one_euro[TITANIA_FILTER_LANES];
+	float min_cutoff[TITANIA_FILTER_LANES];
+	float beta[TITANIA_FILTER_LANES];
+	float derivative_cutoff[TITANIA_FILTER_LANES];
+	uint32_t generation; // changed whenever the filter should restart
+	bool enabled;
+} titania_filter_config;
+
+typedef struct titania_filter_state {
+	alignas(64) float value[TITANIA_FILTER_LANES]; // the last output
+	alignas(64) float speed[TITANIA_FILTER_LANES]; // smoothed derivative, one euro only
+	alignas(64) float history[2][TITANIA_FILTER_LANES]; // the last two inputs, median of 3 only
+	uint64_t host_time; // access controllers have no sensor clock, so they are timed by the host.
+	uint32_t sensor_time;
+	bool primed; // value and history hold a real report
+} titania_filter_state;
+
+// one temperature range of the learned gyro bias, in raw sensor units.
+typedef struct titania_bias_bin {
+	float bias[3];
+	uint32_t samples;
+} titania_bias_bin;
+
+// online gyro bias, the means and variances are exponential averages over the last few dozen reports.
+typedef struct titania_bias_state {
+	titania_bias_bin bins[TITANIA_GYRO_BIAS_BINS];
+	float gyro_mean[3];
+	float gyro_variance[3];
+	float accelerometer_mean[3];
+	float accelerometer_variance[3];
+	int32_t calibration_bias[3]; // the calibration report bias, put back when tracking stops.
+	int32_t temperature;
+	uint32_t rest_time; // sensor time the current rest started at
+	uint32_t sensor_time; // sensor time of the last report learned from
+	uint32_t samples;
+	bool at_rest;
+	bool learned;
+} titania_bias_state;
+
+typedef struct titania_bias_config {
+	uint32_t generation; // changed whenever learning should start over
+	bool enabled;
+	bool use_temperature;
+} titania_bias_config;
+
+// orientation filter state, q is w, x, y, z so it can be worked on as one vector.
+typedef struct titania_fusion_state {
+	alignas(16) float q[4];
+	uint32_t sensor_time;
+	uint32_t samples;
+} titania_fusion_state;
+
+typedef struct titania_fusion_config {
+	float gain;
+	uint32_t generation; // changed whenever the filter should start over
+	bool enabled;
+} titania_fusion_config;
+
+// everything the pull pipeline is configured with. setters change a copy and hand it to pull whole, pull swaps
+// it in before the next report it reads, so reading a handle never waits for a setter.
+typedef struct titania_pipeline {
+	titania_curve_state curve;
+	titania_remap_config remap;
+	titania_filter_config filter;
+	titania_fusion_config fusion;
+	titania_bias_config bias;
+	titania_pointer_config pointer;
+	titania_prediction_config prediction;
+	titania_gesture_config gesture;
+	// firmware and serial found after open, for titania_data hid.
+	titania_firmware_info firmware;
+	titania_serial_info serial;
+	bool has_firmware;
+	bool has_serial;
+} titania_pipeline;
+
+// what pull hands back to the getters after every report. the generations say which settings the results were made with.
+typedef struct titania_results {
+	titania_calibration_scale calibration[6];
+	int32_t calibration_bias[3]; // the calibration report bias, what a new bias setting starts from
+	titania_gyro_bias gyro_bias;
+	titania_fusion_state fusion;
+	titania_prediction_state prediction;
+	titania_ack_stats ack;
+	double pointer[2]; // titania_pointer_state total
+	uint32_t pointer_samples;
+	uint32_t pointer_time;
+	uint32_t bias_generation;
+	uint32_t fusion_generation;
+	uint32_t pointer_generation;
+	uint32_t prediction_generation;
+} titania_results;
+
+// a ring of raw reports for titania_get_history. pull is the only writer: started moves before a slot is overwritten
+// and written after, so a reader can tell which of the reports it copied were overwritten meanwhile.
+typedef struct titania_history {
+	atomic_uint started;
+	atomic_uint written;
+	uint32_t capacity; // what titania_set_history asked for
+	uint32_t mask; // slots - 1, a power of two so the counters can wrap
+	titania_raw_report reports[];
+} titania_history;
+
+#define TITANIA_CACHE_MAGIC (0x43544954u) // TITC
+#define TITANIA_CACHE_VERSION (1)
+#define TITANIA_CACHE_ENTRIES (64)
+#define TITANIA_CACHE_KEY_SIZE (16) // 12 hex digits of the MAC, zero padded
+
+// one controller's derived calibration and device info, the checksum covers everything after it.
+typedef struct titania_cache_entry {
+	char key[TITANIA_CACHE_KEY_SIZE];
+	uint32_t checksum;
+	uint32_t has_calibration;
+	uint64_t stamp;
+	titania_calibration_scale calibration[6];
+	titania_firmware_info firmware;
+	titania_serial_info serial;
+} titania_cache_entry;
+
+typedef struct titania_cache_file {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entry_size;
+	uint32_t entry_count;
+	uint64_t stamp;
+	titania_cache_entry entries[TITANIA_CACHE_ENTRIES];
+} titania_cache_file;
+
+typedef struct titania_cache {
+	atomic_flag lock;
+	titania_cache_file* map;
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE mapping;
+#else
+	int file;
+#endif
+} titania_cache;
+
+// a raw profile as last read from (or written to) the controller, and its conversion.
+typedef struct titania_edge_profile_cache {
+	bool has_data;
+	bool has_profile;
+	uint8_t data[TITANIA_MERGED_REPORT_EDGE_SIZE];
+	titania_edge_profile profile;
+} titania_edge_profile_cache;
+
+typedef struct titania_access_profile_cache {
+	bool has_data;
+	bool has_profile;
+	uint8_t data[TITANIA_MERGED_REPORT_ACCESS_SIZE];
+	titania_access_profile profile;
+} titania_access_profile_cache;
+
+#define TITANIA_ACCESS_PROFILE_COUNT (4)
+
+#define TITANIA_PENDING_CALIBRATION (1u << 0)
+
+typedef struct dualsense_state {
+	// hot, touched on every pull. starts on its own cache line so controllers polled from different cores don't false-share.
+	// apart from the atomics, only the thread that pulls a handle touches this block once it is open.
+#ifdef TITANIA_THREAD_SAFE
+	alignas(TITANIA_CACHE_LINE) atomic_uint lifecycle;
+	dualsense_state_input input;
+#else
+	alignas(TITANIA_CACHE_LINE) dualsense_state_input input;
+#endif
+	hid_device* hid;
+	uint32_t seq;
+	atomic_uint pending; // TITANIA_PENDING_* bits, set by the background worker once the matching pending_* fields are filled.
+	titania_decode_fn decode; // picked from the controller type and bus at open and reconnect.
+	const titania_pipeline* pipeline; // what this report is processed with, titania_pipeline_default until a setter runs.
+	_Atomic(titania_pipeline*) pipeline_next; // published by setters, swapped in by pull.
+	titania_history* history; // the ring pull writes to, or nullptr.
+	_Atomic(titania_history*) history_next; // published by titania_set_history, swapped in by pull.
+	unsigned int results_back; // the results buffer pull fills next.
+	titania_calibration_scale calibration[6];
+	titania_calibration_fixed calibration_fixed[6]; // derived from calibration whenever it changes.
+	alignas(8) uint8_t previous[TITANIA_RAW_REPORT_SIZE]; // the report before the current one, for titania_pull_changes.
+	bool has_previous;
+
+	// hot, touched on every update and push.
+	alignas(TITANIA_CACHE_LINE) dualsense_state_output output;
+	uint16_t replay_flags; // every mutator flag pushed so far, replayed after a reconnect.
+	uint8_t replay_edge_flags; // the same for the edge mutator flags.
+	titania_ack_state ack;
+#ifdef TITANIA_THREAD_SAFE
+	atomic_flag output_lock;
+#endif
+
+	// cold, identity, firmware, and serial. hid_info is what pull reports, its firmware and serial reach it through the pipeline.
+	alignas(TITANIA_CACHE_LINE) titania_hid hid_info;
+#ifdef TITANIA_THREAD_SAFE
+	atomic_flag info_lock;
+#endif
+	bool has_firmware; // guarded by info_lock, like firmware and serial.
+	bool has_serial;
+	bool use_calibration;
+	bool is_cached; // firmware, serial, and calibration came from the cache and only need revalidating.
+	bool has_background_thread;
+	bool blocking;
+	atomic_bool reconnect;
+	atomic_bool is_detached; // the device went away, the handle stays valid until it is found again.
+	atomic_flag is_reconnecting;
+	uint64_t reconnect_time; // host time the controller was last looked for.
+	titania_thread background_thread;
+	titania_cache* cache;
+	char cache_key[TITANIA_CACHE_KEY_SIZE];
+	titania_calibration_scale pending_calibration[6];
+	titania_firmware_info firmware; // what titania_get_firmware reports.
+	titania_serial_info serial; // what titania_get_serial reports.
+	titania_pipeline pipeline_staging; // the newest settings, what setters copy and change. guarded by info_lock.
+	titania_history* history_latest; // the newest ring, what titania_get_history reads. guarded by info_lock.
+
+	// handed from the pulling thread to the getters through a triple buffer, results_back is pull's and results_front is
+	// guarded by info_lock, the third buffer is whichever index results_middle holds.
+	titania_results results[3];
+	atomic_uint results_middle;
+	unsigned int results_front;
+	double pointer_taken[2]; // what titania_get_gyro_pointer has handed out of the pointer total, guarded by info_lock.
+	uint32_t pointer_taken_samples;
+	uint32_t pointer_taken_generation;
+
+	// pipeline state, only touched by the pulling thread.
+	titania_fusion_state fusion;
+	titania_bias_state bias;
+	titania_remap_state remap;
+	titania_filter_state filter;
+	titania_gesture_state gesture;
+	titania_pointer_state pointer;
+	titania_prediction_state prediction;
+	titania_ack_stats ack_stats;
+
+	// indexed by profile id - TITANIA_PROFILE_TRIANGLE (or TITANIA_PROFILE_DEFAULT), guarded by info_lock.
+	union {
+		titania_edge_profile_cache edge_profiles[TITANIA_EDGE_PROFILE_COUNT];
+		titania_access_profile_cache access_profiles[TITANIA_ACCESS_PROFILE_COUNT];
+	};
+
+	// button events, a single producer (the pulling thread) and a single consumer (titania_get_events).
+	// the indices only ever grow and are masked with TITANIA_EVENT_QUEUE_SIZE - 1.
+	alignas(TITANIA_CACHE_LINE) atomic_uint event_head;
+	uint32_t event_buttons; // the buttons of the previous report, only touched by the producer.
+	alignas(TITANIA_CACHE_LINE) atomic_uint event_tail;
+	titania_button_event events[TITANIA_EVENT_QUEUE_SIZE];
+
+	// touchpad gestures, a single producer (the pulling thread) and a single consumer (titania_get_gestures).
+	alignas(TITANIA_CACHE_LINE) atomic_uint gesture_head;
+	alignas(TITANIA_CACHE_LINE) atomic_uint gesture_tail;
+	titania_gesture_event gestures[TITANIA_GESTURE_QUEUE_SIZE];
+} dualsense_state;
+
+static_assert((TITANIA_EVENT_QUEUE_SIZE & (TITANIA_EVENT_QUEUE_SIZE - 1)) == 0, "TITANIA_EVENT_QUEUE_SIZE is not a power of two");
+static_assert((TITANIA_GESTURE_QUEUE_SIZE & (TITANIA_GESTURE_QUEUE_SIZE - 1)) == 0, "TITANIA_GESTURE_QUEUE_SIZE is not a power of two");
+
+static_assert(alignof(dualsense_state) == TITANIA_CACHE_LINE, "dualsense_state is not cache line aligned");
+static_assert(sizeof(dualsense_state) % TITANIA_CACHE_LINE == 0, "dualsense_state is not padded to a cache line");
+static_assert(offsetof(dualsense_state, output) % TITANIA_CACHE_LINE == 0, "dualsense_state.output does not start on a cache line");
+static_assert(offsetof(dualsense_state, hid_info) % TITANIA_CACHE_LINE == 0, "dualsense_state.hid_info does not start on a cache line");
+
+extern const uint32_t crc_seed_input;
+extern const uint32_t crc_seed_output;
+extern const uint32_t crc_seed_feature;
+extern const uint32_t crc_seed_feature_profile;
+extern const uint32_t crc_seed_titania;
+
+struct titania_context {
+	dualsense_state state[TITANIA_MAX_CONTROLLERS];
+	titania_cache cache;
+	bool is_initialized;
+};
 
-extern dualsense_state state[TITANIA_MAX_CONTROLLERS];
-extern bool is_initialized;
+extern titania_context titania_default_context;
+
+extern const titania_pipeline titania_pipeline_default;
 
 /**
- * @brief convert dualsense input report to titania's representation
+ * @brief check if hidapi has been initialized by any context
+ */
+bool titania_is_hidapi_initialized(void);
+
+/**
+ * @brief convert dualsense input report to titania's integer representation
  * @param hid_info: hid device info
  * @param input: the input to convert
  * @param data: the data to convert into
- * @param calibration: calibration data
+ * @param calibration: calibration data from titania_compute_calibration_fixed
+ */
+void titania_convert_input_fixed(const titania_hid* hid_info, const dualsense_input_msg* input, titania_data_fixed* data, const titania_calibration_fixed calibration[6]);
+
+/**
+ * @brief derive the fixed point calibration used by titania_convert_input_fixed
+ * @param scale: the float calibration
+ * @param fixed: where to store the fixed point calibration
+ */
+void titania_compute_calibration_fixed(const titania_calibration_scale scale[6], titania_calibration_fixed fixed[6]);
+
+/**
+ * @brief reshape the sticks of converted input with the curves set by titania_set_stick_curve
+ * @param hid_state: the controller state
+ * @param data: the converted input to update, or nullptr
+ * @param fixed: the fixed point input to update, or nullptr
  */
-void titania_convert_input(const titania_hid hid_info, const dualsense_input_msg input, titania_data* data, titania_calibration_bit calibration[6]);
+void titania_curve_apply(const dualsense_state* hid_state, titania_data* data, titania_data_fixed* fixed);
+
+/**
+ * @brief replace the buttons of converted input with the remap set by titania_set_button_remap or titania_set_access_button_remap
+ * @param hid_state: the controller state
+ * @param data: the converted input to update, or nullptr
+ * @param fixed: the fixed point input to update, or nullptr
+ */
+void titania_remap_apply(dualsense_state* hid_state, titania_data* data, titania_data_fixed* fixed);
+
+/**
+ * @brief run the filters set with titania_set_filter over converted input
+ * @param hid_state: the controller state
+ * @param data: the converted input to filter in place
+ */
+void titania_filter_apply(dualsense_state* hid_state, titania_data* data);
+
+/**
+ * @brief keep the current input report for titania_predict
+ * @param hid_state: the controller state
+ */
+void titania_prediction_update(dualsense_state* hid_state);
+
+/**
+ * @brief turn the gyro of the current input report into pointer movement
+ * @param hid_state: the controller state
+ */
+void titania_pointer_update(dualsense_state* hid_state);
+
+/**
+ * @brief feed the touch points of the current input report to the gesture recogniser, and queue whatever it recognises
+ * @param hid_state: the controller state
+ */
+void titania_gesture_update(dualsense_state* hid_state);
+
+/**
+ * @brief fold the current input report into the gyro bias estimate and apply it to the calibration
+ * @param hid_state: the controller state
+ */
+void titania_bias_update(dualsense_state* hid_state);
+
+/**
+ * @brief calibrate a raw motion sensor value keeping its direction, unlike titania_data which reports the sign of the calibrated range
+ * @param value: the raw value, minus the bias for the gyro
+ * @param calibration: the calibration of the axis
+ * @return the calibrated value
+ */
+float titania_fusion_calibrate(int32_t value, const titania_calibration_scale* calibration);
+
+/**
+ * @brief fill in the orientation and gravity of titania_orientation from a fusion quaternion
+ * @param q: the quaternion, w x y z
+ * @param orientation: where to store it, sensor_time and samples are left alone
+ */
+void titania_fusion_orientation(const float q[4], titania_orientation* orientation);
+
+/**
+ * @brief fold the current input report into the orientation filter
+ * @param hid_state: the controller state
+ */
+void titania_fusion_update(dualsense_state* hid_state);
+
+/**
+ * @brief hand out the current gyro bias estimate, for titania_get_gyro_bias
+ * @param hid_state: the controller state
+ * @param bias: where to store it
+ */
+void titania_bias_result(const dualsense_state* hid_state, titania_gyro_bias* bias);
+
+/**
+ * @brief start a handle on titania_pipeline_default with empty results, before it is published
+ * @param hid_state: the controller state, with its calibration filled in
+ */
+void titania_pipeline_init(dualsense_state* hid_state);
+
+/**
+ * @brief copy the staged pipeline for a setter to change, call with the info lock held
+ * @param hid_state: the controller state
+ * @return the copy, or nullptr when out of memory
+ */
+titania_pipeline* titania_pipeline_edit(dualsense_state* hid_state);
+
+/**
+ * @brief stage a pipeline from titania_pipeline_edit and hand it to the next pull, call with the info lock held
+ * @param hid_state: the controller state
+ * @param pipeline: the changed copy, owned by the handle from now on
+ */
+void titania_pipeline_publish(dualsense_state* hid_state, titania_pipeline* pipeline);
+
+/**
+ * @brief swap in the pipeline a setter published, starting over the stages whose generation changed. pulling thread only
+ * @param hid_state: the controller state
+ */
+void titania_pipeline_update(dualsense_state* hid_state);
+
+/**
+ * @brief free the pipelines and history of a handle that is being closed
+ * @param hid_state: the controller state
+ */
+void titania_pipeline_free(dualsense_state* hid_state);
+
+/**
+ * @brief hand the results of the current report to the getters. pulling thread only
+ * @param hid_state: the controller state
+ */
+void titania_results_publish(dualsense_state* hid_state);
+
+/**
+ * @brief get the newest results published by pull, call with the info lock held
+ * @param hid_state: the controller state
+ * @return the results, valid until the info lock is released
+ */
+const titania_results* titania_results_read(dualsense_state* hid_state);
+
+/**
+ * @brief get the calibration of published results as it will be once pull reaches the staged settings, call with the info lock held
+ * @param hid_state: the controller state
+ * @param results: the results from titania_results_read
+ * @param calibration: where to store the calibration
+ */
+void titania_results_calibration(const dualsense_state* hid_state, const titania_results* results, titania_calibration_scale calibration[6]);
+
+/**
+ * @brief swap in the ring published by titania_set_history. pulling thread only
+ * @param hid_state: the controller state
+ */
+void titania_history_update(dualsense_state* hid_state);
+
+/**
+ * @brief add the current input report to the history ring. pulling thread only
+ * @param hid_state: the controller state
+ * @param handle: the handle the report was read from
+ */
+void titania_history_write(dualsense_state* hid_state, titania_handle handle);
+
+/**
+ * @brief decide whether a push waits for the controller to acknowledge the previous one, call with the output lock held
+ * @param hid_state: the controller state
+ * @return true if the push should not be written yet
+ */
+bool titania_ack_hold(dualsense_state* hid_state);
+
+/**
+ * @brief track a written output report until the controller echoes its state id, call with the output lock held
+ * @param hid_state: the controller state
+ * @param state_id: the state id written in the report
+ */
+void titania_ack_sent(dualsense_state* hid_state, uint32_t state_id);
+
+/**
+ * @brief stop waiting for the reports written so far, they went to a connection that is gone. call from the pulling thread with the output lock held
+ * @param hid_state: the controller state
+ */
+void titania_ack_forget(dualsense_state* hid_state);
+
+/**
+ * @brief acknowledge the output reports echoed back by the current input report. pulling thread only, takes no lock
+ * @param hid_state: the controller state
+ * @return true if a held push can be written now
+ */
+bool titania_ack_update(dualsense_state* hid_state);
+
+/**
+ * @brief get the host monotonic clock, or the wall clock where there is none
+ * @return nanoseconds
+ */
+uint64_t titania_host_time(void);
+
+/**
+ * @brief queue press and release events for the buttons that changed in the current input report
+ * @param hid_state: the controller state
+ */
+void titania_queue_button_events(dualsense_state* hid_state);
+
+/**
+ * @brief unpack a titania_button_mask into titania_buttons, edge_reserved is left alone
+ * @param mask: the packed buttons
+ * @param buttons: where to store the buttons
+ */
+void titania_expand_buttons(uint32_t mask, titania_buttons* buttons);
+
+/**
+ * @brief pack the access buttons of an input report into a titania_access_button_mask
+ * @param input: the input to convert
+ */
+uint32_t titania_convert_access_buttons(const dualsense_input_msg* input);
+
+/**
+ * @brief find which groups differ between two input reports
+ * @param previous: the older report, or nullptr to mark every group the controller has
+ * @param current: the newer report
+ * @param is_edge: whether the reports came from an edge controller
+ * @param is_access: whether the reports came from an access controller
+ * @return titania_change_mask bits
+ */
+uint32_t titania_diff_input(const uint8_t previous[TITANIA_RAW_REPORT_SIZE], const uint8_t current[TITANIA_RAW_REPORT_SIZE], bool is_edge, bool is_access);
+
+/**
+ * @brief pack the buttons of an input report into a titania_button_mask
+ * @param input: the input to convert
+ * @param is_access: whether the report came from an access controller, which has no touchpad
+ */
+uint32_t titania_convert_buttons(const dualsense_input_msg* input, bool is_access);
+
+/**
+ * @brief forget the cached copy of an edge profile, or all of them for TITANIA_PROFILE_ALL
+ * @param hid_state: the controller state
+ * @param profile_id: the profile that changed
+ */
+void titania_invalidate_edge_profile(dualsense_state* hid_state, titania_profile_id profile_id);
+
+/**
+ * @brief forget the cached copy of an access profile, or all of them for TITANIA_PROFILE_ALL
+ * @param hid_state: the controller state
+ * @param profile_id: the profile that changed
+ */
+void titania_invalidate_access_profile(dualsense_state* hid_state, titania_profile_id profile_id);
+
+/**
+ * @brief remember an access profile that was just written to the controller
+ * @param hid_state: the controller state
+ * @param profile_id: the profile that was written
+ * @param profile_data: the merged profile
+ */
+void titania_store_access_profile(dualsense_state* hid_state, titania_profile_id profile_id, const uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE]);
+
+/**
+ * @brief check whether an access profile is cached with exactly this content
+ * @param hid_state: the controller state
+ * @param profile_id: the profile to check
+ * @param profile_data: the merged profile
+ */
+bool titania_is_access_profile_cached(dualsense_state* hid_state, titania_profile_id profile_id, const uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE]);
 
 /**
  * @brief convert a titania profile to dualsense edge's representation
@@ -541,21 +1197,62 @@ titania_error titania_convert_edge_profile_output(titania_edge_profile input, du
 /**
  * @brief convert a titania profile to access's representation
  * @param input: the input to convert
+ * @param profile_data: the merged profile, as titania_debug_get_access_profile would return it
  * @param output: the profile to convert into
  */
-titania_error titania_convert_access_profile_output(titania_access_profile input, playstation_access_profile_blob output[0x12]);
+titania_error titania_convert_access_profile_output(titania_access_profile input, uint8_t profile_data[TITANIA_MERGED_REPORT_ACCESS_SIZE], playstation_access_profile_blob output[0x12]);
 
 /**
  * @brief update LED state of an access controller
+ * @param ctx: the context that owns the controller
  * @param handle: the controller to update
  * @param data: led update data
  */
-titania_error titania_update_access_led(const titania_handle handle, const titania_led_update data);
+titania_error titania_update_access_led(titania_context* ctx, const titania_handle handle, const titania_led_update data);
+
+/**
+ * @brief check if a device is one titania supports
+ * @param vendor_id: usb vendor id
+ * @param product_id: usb product id
+ */
+bool titania_is_supported_device(const uint16_t vendor_id, const uint16_t product_id);
+
+/**
+ * @brief map a cache file, creating it if it does not exist
+ * @param cache: the cache to open into, any previous mapping is closed
+ * @param path: path to the cache file
+ */
+titania_error titania_cache_open(titania_cache* cache, const char* path);
+
+/**
+ * @brief unmap a cache file
+ * @param cache: the cache to close
+ */
+void titania_cache_close(titania_cache* cache);
+
+/**
+ * @brief derive a cache key from a hid serial number
+ * @param serial: the hid serial number, usually the MAC address
+ * @param key: the key to write
+ * @return false if the serial number is not a MAC address
+ */
+bool titania_cache_key(const wchar_t* serial, char key[TITANIA_CACHE_KEY_SIZE]);
+
+/**
+ * @brief find a cache entry
+ * @param cache: the cache to search
+ * @param key: the key to search for
+ * @param entry: the entry to copy into
+ */
+bool titania_cache_lookup(titania_cache* cache, const char key[TITANIA_CACHE_KEY_SIZE], titania_cache_entry* entry);
 
 /**
- * @brief initializes checksum tables
+ * @brief add or replace a cache entry, evicting the oldest entry if the cache is full
+ * @param cache: the cache to store into
+ * @param entry: the entry to store, the key, stamp, and checksum are filled in
+ * @param key: the key to store under
  */
-void titania_init_checksum(void);
+void titania_cache_store(titania_cache* cache, const char key[TITANIA_CACHE_KEY_SIZE], titania_cache_entry* entry);
 
 /**
  * @brief calculates a bluetooth checksum
@@ -0,0 +1,131 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#ifndef TITANIA_SYNC_H
+#define TITANIA_SYNC_H
+
+#include <titania_config.h>
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "thread.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#define titania_cpu_relax() _mm_pause()
+#elif defined(_M_ARM64)
+#include <intrin.h>
+#define titania_cpu_relax() __yield()
+#elif defined(__aarch64__) || defined(__arm__)
+#define titania_cpu_relax() __asm__ volatile("yield")
+#else
+#define titania_cpu_relax() ((void) 0)
+#endif
+
+#define TITANIA_SPIN_LIMIT (128) // pauses before a waiter starts giving its core away
+
+// pause for a while, then yield, a wait can last as long as a blocking hid_read on another thread
+// or as long as the holder of a spin lock is preempted.
+static inline void titania_spin_backoff(unsigned int* spins) {
+	if (*spins < TITANIA_SPIN_LIMIT) {
+		++*spins;
+		titania_cpu_relax();
+	} else {
+		titania_thread_yield();
+	}
+}
+
+static inline void titania_spin_lock(atomic_flag* lock) {
+	unsigned int spins = 0;
+	while (atomic_flag_test_and_set_explicit(lock, memory_order_acquire)) {
+		titania_spin_backoff(&spins);
+	}
+}
+
+static inline void titania_spin_unlock(atomic_flag* lock) { atomic_flag_clear_explicit(lock, memory_order_release); }
+
+// three buffers handed from one writer to one reader without either of them waiting. the writer fills its back buffer
+// and swaps it into the middle, the reader swaps its front buffer for the middle one whenever that is fresh.
+#define TITANIA_TRIPLE_FRESH (4u)
+
+// publish the back buffer, returns the index of the next back buffer.
+static inline unsigned int titania_triple_publish(atomic_uint* middle, const unsigned int back) { return atomic_exchange_explicit(middle, back | TITANIA_TRIPLE_FRESH, memory_order_acq_rel) & 3u; }
+
+// pick up the newest buffer if there is one, returns the index of the front buffer.
+static inline unsigned int titania_triple_take(atomic_uint* middle, const unsigned int front) {
+	if ((atomic_load_explicit(middle, memory_order_relaxed) & TITANIA_TRIPLE_FRESH) == 0) {
+		return front;
+	}
+
+	return atomic_exchange_explicit(middle, front, memory_order_acq_rel) & 3u;
+}
+
+#ifdef TITANIA_THREAD_SAFE
+// slot lifecycle word: the top bits track the slot state, the rest count threads currently using the handle.
+#define TITANIA_SLOT_OPEN (0x80000000u)
+#define TITANIA_SLOT_RESERVED (0x40000000u)
+#define TITANIA_SLOT_SWAPPING (0x20000000u)
+#define TITANIA_SLOT_USERS (0x1FFFFFFFu)
+
+// claim a free slot for titania_open, nothing can acquire it until it is published.
+static inline bool titania_slot_reserve(atomic_uint* slot) {
+	unsigned int expected = 0;
+	return atomic_compare_exchange_strong(slot, &expected, TITANIA_SLOT_RESERVED);
+}
+
+static inline void titania_slot_publish(atomic_uint* slot) { atomic_store(slot, TITANIA_SLOT_RESERVED | TITANIA_SLOT_OPEN); }
+
+static inline void titania_slot_free(atomic_uint* slot) { atomic_store(slot, 0); }
+
+// take a reference on an open slot, fails if the slot is not open or is being closed, waits while the device is swapped.
+static inline bool titania_slot_acquire(atomic_uint* slot) {
+	unsigned int value = atomic_load(slot);
+	unsigned int spins = 0;
+	do {
+		if ((value & TITANIA_SLOT_OPEN) == 0) {
+			return false;
+		}
+
+		if (value & TITANIA_SLOT_SWAPPING) {
+			titania_spin_backoff(&spins);
+			value = atomic_load(slot);
+			continue;
+		}
+	} while (!atomic_compare_exchange_weak(slot, &value, value + 1));
+	return true;
+}
+
+static inline void titania_slot_release(atomic_uint* slot) { atomic_fetch_sub(slot, 1); }
+
+// hold new references back and wait until the caller's own reference is the only one left, so the device can be replaced.
+static inline void titania_slot_begin_swap(atomic_uint* slot) {
+	atomic_fetch_or(slot, TITANIA_SLOT_SWAPPING);
+	unsigned int spins = 0;
+	while ((atomic_load(slot) & TITANIA_SLOT_USERS) > 1) {
+		titania_spin_backoff(&spins);
+	}
+}
+
+static inline void titania_slot_end_swap(atomic_uint* slot) { atomic_fetch_and(slot, ~TITANIA_SLOT_SWAPPING); }
+
+// stop handing out references and wait until every thread using the slot has left, only one closer wins.
+static inline bool titania_slot_retire(atomic_uint* slot) {
+	const unsigned int value = atomic_fetch_and(slot, ~TITANIA_SLOT_OPEN);
+	if ((value & TITANIA_SLOT_OPEN) == 0) {
+		return false;
+	}
+
+	unsigned int spins = 0;
+	while ((atomic_load(slot) & TITANIA_SLOT_USERS) != 0) {
+		titania_spin_backoff(&spins);
+	}
+
+	return true;
+}
+#endif
+
+#endif // TITANIA_SYNC_H
@@ -0,0 +1,95 @@
+//  titania project
+//  https://nothg.chronovore.dev/library/titania/
+//  SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#ifndef TITANIA_THREAD_H
+#define TITANIA_THREAD_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <titania_config_internal.h>
+
+#ifndef TITANIA_HAS_NULLPTR
+#define nullptr ((void*) 0)
+#endif
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <process.h>
+#include <windows.h>
+
+typedef HANDLE titania_thread;
+#else
+#include <pthread.h>
+#include <sched.h>
+
+typedef pthread_t titania_thread;
+#endif
+
+typedef void (*titania_thread_callback_t)(void* userdata);
+
+typedef struct titania_thread_start_info {
+	titania_thread_callback_t callback;
+	void* userdata;
+} titania_thread_start_info;
+
+#ifdef _WIN32
+static unsigned __stdcall titania_thread_trampoline(void* arg) {
+#else
+static void* titania_thread_trampoline(void* arg) {
+#endif
+	titania_thread_start_info info = *(titania_thread_start_info*) arg;
+	free(arg);
+	info.callback(info.userdata);
+#ifdef _WIN32
+	return 0;
+#else
+	return nullptr;
+#endif
+}
+
+static inline bool titania_thread_start(titania_thread* thread, titania_thread_callback_t callback, void* userdata) {
+	titania_thread_start_info* info = malloc(sizeof(titania_thread_start_info));
+	if (info == nullptr) {
+		return false;
+	}
+
+	info->callback = callback;
+	info->userdata = userdata;
+
+#ifdef _WIN32
+	*thread = (HANDLE) _beginthreadex(nullptr, 0, titania_thread_trampoline, info, 0, nullptr);
+	if (*thread == nullptr) {
+#else
+	if (pthread_create(thread, nullptr, titania_thread_trampoline, info) != 0) {
+#endif
+		free(info);
+		return false;
+	}
+
+	return true;
+}
+
+static inline void titania_thread_join(titania_thread thread) {
+#ifdef _WIN32
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#else
+	pthread_join(thread, nullptr);
+#endif
+}
+
+static inline void titania_thread_yield(void) {
+#ifdef _WIN32
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+#endif // TITANIA_THREAD_H
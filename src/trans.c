@@ -2,6 +2,8 @@
 //  https://nothg.chronovore.dev/library/titania/
 //  SPDX-License-Identifier: MPL-2.0
 
+#include <string.h>
+
 #include "structures.h"
 
 #include <titania_config_internal.h>
@@ -11,211 +13,221 @@
 #pragma STDC CX_LIMITED_RANGE ON
 #endif
 
-#define CHECK_DPAD(V, A, B, C) V.dpad == DUALSENSE_DPAD_##A || V.dpad == DUALSENSE_DPAD_##B || V.dpad == DUALSENSE_DPAD_##C
+// value * scale[value < 0] like the float decoders in titania_decode.h, but for Q16 multipliers with rounding.
+#define CALIBRATE_FIXED_SCALE(value, slot) titania_saturate_int16(((int64_t) (value) * calibration[slot].scale[(value) < 0] + (1 << 15)) >> 16)
+
+#define CALIBRATE_FIXED(value, slot) CALIBRATE_FIXED_SCALE((int32_t) (value), slot)
+
+#define CALIBRATE_FIXED_BIAS(value, slot) CALIBRATE_FIXED_SCALE((int32_t) (value) - calibration[slot].bias, slot)
+
+// dpad hat value to the four dpad bits of titania_button_mask.
+static const uint8_t titania_dpad_mask[16] = {
+	[DUALSENSE_DPAD_U] = TITANIA_BUTTON_MASK_DPAD_UP,
+	[DUALSENSE_DPAD_UR] = TITANIA_BUTTON_MASK_DPAD_UP | TITANIA_BUTTON_MASK_DPAD_RIGHT,
+	[DUALSENSE_DPAD_R] = TITANIA_BUTTON_MASK_DPAD_RIGHT,
+	[DUALSENSE_DPAD_DR] = TITANIA_BUTTON_MASK_DPAD_RIGHT | TITANIA_BUTTON_MASK_DPAD_DOWN,
+	[DUALSENSE_DPAD_D] = TITANIA_BUTTON_MASK_DPAD_DOWN,
+	[DUALSENSE_DPAD_DL] = TITANIA_BUTTON_MASK_DPAD_DOWN | TITANIA_BUTTON_MASK_DPAD_LEFT,
+	[DUALSENSE_DPAD_L] = TITANIA_BUTTON_MASK_DPAD_LEFT,
+	[DUALSENSE_DPAD_UL] = TITANIA_BUTTON_MASK_DPAD_UP | TITANIA_BUTTON_MASK_DPAD_LEFT,
+};
+
+uint32_t titania_convert_buttons(const dualsense_input_msg* input, const bool is_access) {
+	// buttons past the dpad are laid out in the same order as titania_button_mask.
+	uint32_t raw_buttons;
+	memcpy(&raw_buttons, &input->buttons, sizeof(raw_buttons));
+	uint32_t mask = titania_dpad_mask[raw_buttons & 0xF] | (raw_buttons & 0x00FFFFF0);
+	if (!is_access && (!input->touch[DUALSENSE_LEFT].id.idle || !input->touch[DUALSENSE_RIGHT].id.idle)) {
+		mask |= TITANIA_BUTTON_MASK_TOUCHPAD;
+	}
+
+	return mask;
+}
+
+void titania_expand_buttons(const uint32_t mask, titania_buttons* buttons) {
+	buttons->dpad_up = (mask & TITANIA_BUTTON_MASK_DPAD_UP) != 0;
+	buttons->dpad_right = (mask & TITANIA_BUTTON_MASK_DPAD_RIGHT) != 0;
+	buttons->dpad_down = (mask & TITANIA_BUTTON_MASK_DPAD_DOWN) != 0;
+	buttons->dpad_left = (mask & TITANIA_BUTTON_MASK_DPAD_LEFT) != 0;
+	buttons->square = (mask & TITANIA_BUTTON_MASK_SQUARE) != 0;
+	buttons->cross = (mask & TITANIA_BUTTON_MASK_CROSS) != 0;
+	buttons->circle = (mask & TITANIA_BUTTON_MASK_CIRCLE) != 0;
+	buttons->triangle = (mask & TITANIA_BUTTON_MASK_TRIANGLE) != 0;
+	buttons->l1 = (mask & TITANIA_BUTTON_MASK_L1) != 0;
+	buttons->r1 = (mask & TITANIA_BUTTON_MASK_R1) != 0;
+	buttons->l2 = (mask & TITANIA_BUTTON_MASK_L2) != 0;
+	buttons->r2 = (mask & TITANIA_BUTTON_MASK_R2) != 0;
+	buttons->create = (mask & TITANIA_BUTTON_MASK_CREATE) != 0;
+	buttons->option = (mask & TITANIA_BUTTON_MASK_OPTION) != 0;
+	buttons->l3 = (mask & TITANIA_BUTTON_MASK_L3) != 0;
+	buttons->r3 = (mask & TITANIA_BUTTON_MASK_R3) != 0;
+	buttons->playstation = (mask & TITANIA_BUTTON_MASK_PLAYSTATION) != 0;
+	buttons->touch = (mask & TITANIA_BUTTON_MASK_TOUCH) != 0;
+	buttons->mute = (mask & TITANIA_BUTTON_MASK_MUTE) != 0;
+	buttons->reserved = (mask & TITANIA_BUTTON_MASK_RESERVED) != 0;
+	buttons->edge_f1 = (mask & TITANIA_BUTTON_MASK_EDGE_F1) != 0;
+	buttons->edge_f2 = (mask & TITANIA_BUTTON_MASK_EDGE_F2) != 0;
+	buttons->edge_left_paddle = (mask & TITANIA_BUTTON_MASK_EDGE_LEFT_PADDLE) != 0;
+	buttons->edge_right_paddle = (mask & TITANIA_BUTTON_MASK_EDGE_RIGHT_PADDLE) != 0;
+	buttons->touchpad = (mask & TITANIA_BUTTON_MASK_TOUCHPAD) != 0;
+}
+
+uint32_t titania_convert_access_buttons(const dualsense_input_msg* input) {
+	uint16_t raw_buttons;
+	memcpy(&raw_buttons, &input->access.raw_button, sizeof(raw_buttons));
+	uint32_t mask = raw_buttons & 0x0FFF;
+	for (int i = 0; i < 4; ++i) {
+		if (input->access.e[i].x != 0 || input->access.e[i].y != 0) {
+			mask |= TITANIA_ACCESS_BUTTON_MASK_E1 << i;
+		}
+	}
+
+	return mask;
+}
+
+// bits of 64-bit word w (bytes 8w to 8w + 7, little endian) covering report bytes first to last.
+#define CHANGE_BYTES(w, first, last) \
+	((first) > (w) * 8 + 7 || (last) < (w) * 8 ? 0ull : (~0ull << (8 * ((first) > (w) * 8 ? (first) - (w) * 8 : 0))) & (~0ull >> (8 * ((last) < (w) * 8 + 7 ? (w) * 8 + 7 - (last) : 0))))
+
+#define CHANGE_BIT(w, byte, bit) ((byte) / 8 == (w) ? 1ull << (((byte) % 8) * 8 + (bit)) : 0ull)
+
+#define CHANGE_ROW(group) { group(0), group(1), group(2), group(3), group(4), group(5), group(6), group(7) }
+
+// offsets match titania_decode.h, the touchpad button is derived from the touch idle bits.
+#define CHANGE_DUALSENSE_BUTTONS(w) (CHANGE_BYTES(w, 8, 11) | CHANGE_BIT(w, 33, 7) | CHANGE_BIT(w, 37, 7))
+#define CHANGE_DUALSENSE_STICKS(w) CHANGE_BYTES(w, 1, 4)
+#define CHANGE_DUALSENSE_TRIGGERS(w) (CHANGE_BYTES(w, 5, 6) | CHANGE_BYTES(w, 42, 43) | CHANGE_BYTES(w, 48, 48))
+#define CHANGE_DUALSENSE_TOUCH(w) CHANGE_BYTES(w, 33, 40)
+#define CHANGE_DUALSENSE_SENSORS(w) (CHANGE_BYTES(w, 16, 27) | CHANGE_BYTES(w, 32, 32))
+#define CHANGE_DUALSENSE_BATTERY(w) CHANGE_BYTES(w, 53, 53)
+#define CHANGE_DUALSENSE_DEVICE(w) CHANGE_BYTES(w, 54, 55)
+#define CHANGE_EDGE_STATE(w) CHANGE_BYTES(w, 49, 52)
+#define CHANGE_ACCESS_BUTTONS(w) CHANGE_BYTES(w, 8, 11)
+#define CHANGE_ACCESS_STICKS(w) CHANGE_BYTES(w, 1, 4)
+#define CHANGE_ACCESS_BATTERY(w) CHANGE_BYTES(w, 37, 37)
+#define CHANGE_ACCESS_STATE(w) (CHANGE_BYTES(w, 16, 36) | CHANGE_BYTES(w, 38, 53))
+#define CHANGE_NONE(w) 0ull
+
+// indexed by titania_change_mask bit, then by word.
+static const uint64_t titania_change_dualsense[9][8] = {
+	CHANGE_ROW(CHANGE_DUALSENSE_BUTTONS),
+	CHANGE_ROW(CHANGE_DUALSENSE_STICKS),
+	CHANGE_ROW(CHANGE_DUALSENSE_TRIGGERS),
+	CHANGE_ROW(CHANGE_DUALSENSE_TOUCH),
+	CHANGE_ROW(CHANGE_DUALSENSE_SENSORS),
+	CHANGE_ROW(CHANGE_DUALSENSE_BATTERY),
+	CHANGE_ROW(CHANGE_DUALSENSE_DEVICE),
+	CHANGE_ROW(CHANGE_EDGE_STATE),
+	CHANGE_ROW(CHANGE_NONE),
+};
+
+static const uint64_t titania_change_access[9][8] = {
+	CHANGE_ROW(CHANGE_ACCESS_BUTTONS),
+	CHANGE_ROW(CHANGE_ACCESS_STICKS),
+	CHANGE_ROW(CHANGE_NONE),
+	CHANGE_ROW(CHANGE_NONE),
+	CHANGE_ROW(CHANGE_NONE),
+	CHANGE_ROW(CHANGE_ACCESS_BATTERY),
+	CHANGE_ROW(CHANGE_NONE),
+	CHANGE_ROW(CHANGE_NONE),
+	CHANGE_ROW(CHANGE_ACCESS_STATE),
+};
+
+uint32_t titania_diff_input(const uint8_t previous[TITANIA_RAW_REPORT_SIZE], const uint8_t current[TITANIA_RAW_REPORT_SIZE], const bool is_edge, const bool is_access) {
+	uint64_t diff[8];
+	for (int w = 0; w < 8; ++w) {
+		if (previous == nullptr) {
+			diff[w] = ~0ull;
+			continue;
+		}
+
+		uint64_t a, b;
+		memcpy(&a, previous + w * 8, sizeof(a));
+		memcpy(&b, current + w * 8, sizeof(b));
+		diff[w] = a ^ b;
+	}
+
+	const uint64_t (*masks)[8] = is_access ? titania_change_access : titania_change_dualsense;
+	// the edge state shares its bytes with the battery timestamp on other controllers.
+	const int groups = is_access || is_edge ? 9 : 7;
+	uint32_t changes = 0;
+	for (int g = 0; g < groups; ++g) {
+		uint64_t hit = 0;
+		for (int w = 0; w < 8; ++w) {
+			hit |= diff[w] & masks[g][w];
+		}
+
+		if (hit != 0) {
+			changes |= 1u << g;
+		}
+	}
 
-#define CALIBRATE(value, slot) (value < 0 ? value * calibration[slot].min : value * calibration[slot].max) * calibration[slot].cache
+	return changes;
+}
 
-#define CALIBRATE_BIAS(value, slot) CALIBRATE(value - calibration[slot].bias, slot)
+static int32_t titania_fix_scale(const float scale, const int shift) {
+	const double value = (double) scale * (1 << (shift + 16));
+	return (int32_t) (value < 0 ? value - 0.5 : value + 0.5);
+}
 
-void titania_convert_input_access(const dualsense_input_msg input, titania_data* data) {
-	data->battery.state = input.access.battery.state + 1;
-	if (data->battery.state == TITANIA_BATTERY_FULL) {
-		data->battery.level = 1.0f;
-	} else {
-		data->battery.level = input.access.battery.level * 0.1 + 0.10;
+void titania_compute_calibration_fixed(const titania_calibration_scale scale[6], titania_calibration_fixed fixed[6]) {
+	for (int j = 0; j < 6; ++j) {
+		const int shift = j < CALIBRATION_ACCELEROMETER_X ? TITANIA_FIXED_GYRO_SHIFT : TITANIA_FIXED_ACCELEROMETER_SHIFT;
+		fixed[j].scale[0] = titania_fix_scale(scale[j].scale[0], shift);
+		fixed[j].scale[1] = titania_fix_scale(scale[j].scale[1], shift);
+		fixed[j].bias = scale[j].bias;
 	}
+}
+
+static int16_t titania_saturate_int16(const int64_t value) {
+	return value > INT16_MAX ? INT16_MAX : value < INT16_MIN ? INT16_MIN : (int16_t) value;
+}
 
-	data->access_device.buttons.button1 = input.access.raw_button.button1;
-	data->access_device.buttons.button2 = input.access.raw_button.button2;
-	data->access_device.buttons.button3 = input.access.raw_button.button3;
-	data->access_device.buttons.button4 = input.access.raw_button.button4;
-	data->access_device.buttons.button5 = input.access.raw_button.button5;
-	data->access_device.buttons.button6 = input.access.raw_button.button6;
-	data->access_device.buttons.button7 = input.access.raw_button.button7;
-	data->access_device.buttons.button8 = input.access.raw_button.button8;
-	data->access_device.buttons.center_button = input.access.raw_button.center_button;
-	data->access_device.buttons.stick_button = input.access.raw_button.stick_button;
-	data->access_device.buttons.playstation = input.access.raw_button.playstation;
-	data->access_device.buttons.profile = input.access.raw_button.profile;
-	data->access_device.buttons.reserved = input.access.raw_button.reserved;
-	data->access_device.buttons.e1 = input.access.e[0].x != 0 || input.access.e[0].y != 0;
-	data->access_device.buttons.e2 = input.access.e[1].x != 0 || input.access.e[1].y != 0;
-	data->access_device.buttons.e3 = input.access.e[2].x != 0 || input.access.e[2].y != 0;
-	data->access_device.buttons.e4 = input.access.e[3].x != 0 || input.access.e[3].y != 0;
-
-	data->access_device.raw_stick.x = DENORM_CLAMP_INT8(input.access.raw_stick.x);
-	data->access_device.raw_stick.y = DENORM_CLAMP_INT8(input.access.raw_stick.y);
-
-	data->access_device.sticks[TITANIA_PRIMARY].x = DENORM_CLAMP_INT8(input.access.stick1.x);
-	data->access_device.sticks[TITANIA_PRIMARY].y = DENORM_CLAMP_INT8(input.access.stick1.y);
-	data->access_device.sticks[TITANIA_SECONDARY].x = DENORM_CLAMP_INT8(input.access.stick2.x);
-	data->access_device.sticks[TITANIA_SECONDARY].y = DENORM_CLAMP_INT8(input.access.stick2.y);
-
-	data->access_device.current_profile_id = input.access.profile_id + 1;
-	data->access_device.profile_switching_disabled = input.access.profile_switching_disabled;
-
-	data->access_device.extensions[TITANIA_EXTENSION1].pos.x = DENORM_CLAMP_UINT8(input.access.e[PLAYSTATION_ACCESS_EXTENSION1].x);
-	data->access_device.extensions[TITANIA_EXTENSION1].pos.y = DENORM_CLAMP_UINT8(input.access.e[PLAYSTATION_ACCESS_EXTENSION1].y);
-	data->access_device.extensions[TITANIA_EXTENSION1].type = input.access.e1e2.left_port;
-
-	data->access_device.extensions[TITANIA_EXTENSION2].pos.x = DENORM_CLAMP_UINT8(input.access.e[PLAYSTATION_ACCESS_EXTENSION2].x);
-	data->access_device.extensions[TITANIA_EXTENSION2].pos.y = DENORM_CLAMP_UINT8(input.access.e[PLAYSTATION_ACCESS_EXTENSION2].y);
-	data->access_device.extensions[TITANIA_EXTENSION2].type = input.access.e1e2.right_port;
-
-	data->access_device.extensions[TITANIA_EXTENSION3].pos.x = DENORM_CLAMP_UINT8(input.access.e[PLAYSTATION_ACCESS_EXTENSION3].x);
-	data->access_device.extensions[TITANIA_EXTENSION3].pos.y = DENORM_CLAMP_UINT8(input.access.e[PLAYSTATION_ACCESS_EXTENSION3].y);
-	data->access_device.extensions[TITANIA_EXTENSION3].type = input.access.e3e4.left_port;
-
-	data->access_device.extensions[TITANIA_EXTENSION4].pos.x = DENORM_CLAMP_UINT8(input.access.e[PLAYSTATION_ACCESS_EXTENSION4].x);
-	data->access_device.extensions[TITANIA_EXTENSION4].pos.y = DENORM_CLAMP_UINT8(input.access.e[PLAYSTATION_ACCESS_EXTENSION4].y);
-	data->access_device.extensions[TITANIA_EXTENSION4].type = input.access.e3e4.right_port;
-
-	data->access_device.unknown1 = input.access.unknown1;
-	data->access_device.unknown2 = input.access.unknown2;
-	data->access_device.unknown3 = input.access.unknown3;
-	data->access_device.unknown4 = input.access.unknown4;
-	data->access_device.unknown5 = input.access.unknown5;
-	data->access_device.unknown6 = input.access.unknown6;
-	data->access_device.unknown7 = input.access.unknown7;
-	data->access_device.unknown8 = input.access.unknown8;
-	data->access_device.unknown9 = input.access.unknown9;
+static uint8_t titania_battery_percent(const dualsense_battery_state battery) {
+	return battery.state + 1 == TITANIA_BATTERY_FULL ? 100 : battery.level * 10 + 10;
 }
 
-void titania_convert_input(const titania_hid hid_info, const dualsense_input_msg input, titania_data* data, titania_calibration_bit calibration[6]) {
-	*data = (titania_data) { 0 };
-	data->hid = hid_info;
-
-	data->time.checksum = input.checksum;
-	data->time.sequence = input.sequence;
-	data->time.system = input.firmware_time;
-
-	data->buttons.dpad_up = CHECK_DPAD(input.buttons, U, UR, UL);
-	data->buttons.dpad_down = CHECK_DPAD(input.buttons, D, DR, DL);
-	data->buttons.dpad_left = CHECK_DPAD(input.buttons, L, UL, DL);
-	data->buttons.dpad_right = CHECK_DPAD(input.buttons, R, UR, DR);
-	data->buttons.square = input.buttons.square;
-	data->buttons.cross = input.buttons.cross;
-	data->buttons.circle = input.buttons.circle;
-	data->buttons.triangle = input.buttons.triangle;
-	data->buttons.l1 = input.buttons.l1;
-	data->buttons.r1 = input.buttons.r1;
-	data->buttons.l2 = input.buttons.l2;
-	data->buttons.r2 = input.buttons.r2;
-	data->buttons.create = input.buttons.create;
-	data->buttons.option = input.buttons.option;
-	data->buttons.l3 = input.buttons.l3;
-	data->buttons.r3 = input.buttons.r3;
-	data->buttons.playstation = input.buttons.playstation;
-	data->buttons.touch = input.buttons.touch;
-	data->buttons.mute = input.buttons.mute;
-	data->buttons.reserved = input.buttons.reserved;
-	data->buttons.edge_f1 = input.buttons.edge_f1;
-	data->buttons.edge_f2 = input.buttons.edge_f2;
-	data->buttons.edge_left_paddle = input.buttons.edge_left_paddle;
-	data->buttons.edge_right_paddle = input.buttons.edge_right_paddle;
-	data->buttons.edge_reserved = input.buttons.edge_reserved;
-
-	data->sticks[TITANIA_LEFT].x = DENORM_CLAMP_INT8(input.sticks[DUALSENSE_LEFT].x);
-	data->sticks[TITANIA_LEFT].y = DENORM_CLAMP_INT8(input.sticks[DUALSENSE_LEFT].y);
-	data->sticks[TITANIA_RIGHT].x = DENORM_CLAMP_INT8(input.sticks[DUALSENSE_RIGHT].x);
-	data->sticks[TITANIA_RIGHT].y = DENORM_CLAMP_INT8(input.sticks[DUALSENSE_RIGHT].y);
-
-	if (IS_ACCESS(hid_info)) {
-		titania_convert_input_access(input, data);
+void titania_convert_input_fixed(const titania_hid* hid_info, const dualsense_input_msg* input, titania_data_fixed* data, const titania_calibration_fixed calibration[6]) {
+	*data = (titania_data_fixed) { 0 };
+	data->handle = hid_info->handle;
+	data->sequence = input->sequence;
+	data->buttons = titania_convert_buttons(input, hid_info->is_access);
+
+	data->sticks[TITANIA_LEFT].x = (int8_t) (input->sticks[DUALSENSE_LEFT].x - 128);
+	data->sticks[TITANIA_LEFT].y = (int8_t) (input->sticks[DUALSENSE_LEFT].y - 128);
+	data->sticks[TITANIA_RIGHT].x = (int8_t) (input->sticks[DUALSENSE_RIGHT].x - 128);
+	data->sticks[TITANIA_RIGHT].y = (int8_t) (input->sticks[DUALSENSE_RIGHT].y - 128);
+
+	if (hid_info->is_access) {
+		data->battery_state = input->access.battery.state + 1;
+		data->battery_level = titania_battery_percent(input->access.battery);
 		return;
 	}
 
-	data->time.touch_sequence = input.touch_sequence;
-	data->time.sensor = input.sensors.time;
-	data->time.driver_sequence = input.state_id;
-	data->time.battery = input.state.battery_time;
-
-	data->state_id = input.state_id;
-
-	data->triggers[TITANIA_LEFT].level = DENORM_CLAMP_UINT8(input.triggers[DUALSENSE_LEFT]);
-	data->triggers[TITANIA_LEFT].id = input.adaptive_triggers[ADAPTIVE_TRIGGER_LEFT].id;
-	data->triggers[TITANIA_LEFT].section = input.adaptive_triggers[ADAPTIVE_TRIGGER_LEFT].level;
-	data->triggers[TITANIA_LEFT].effect = input.state.trigger.left;
-	data->triggers[TITANIA_RIGHT].level = DENORM_CLAMP_UINT8(input.triggers[DUALSENSE_RIGHT]);
-	data->triggers[TITANIA_RIGHT].id = input.adaptive_triggers[ADAPTIVE_TRIGGER_RIGHT].id;
-	data->triggers[TITANIA_RIGHT].section = input.adaptive_triggers[ADAPTIVE_TRIGGER_RIGHT].level;
-	data->triggers[TITANIA_RIGHT].effect = input.state.trigger.right;
-
-	data->touch[TITANIA_PRIMARY].id = input.touch[DUALSENSE_LEFT].id.value;
-	data->touch[TITANIA_PRIMARY].active = !input.touch[DUALSENSE_LEFT].id.idle;
-	data->touch[TITANIA_SECONDARY].id = input.touch[DUALSENSE_RIGHT].id.value;
-	data->touch[TITANIA_SECONDARY].active = !input.touch[DUALSENSE_RIGHT].id.idle;
+	data->sensor_time = input->sensors.time;
+	data->battery_state = input->state.battery.state + 1;
+	data->battery_level = titania_battery_percent(input->state.battery);
+	data->temperature = input->sensors.temperature;
+
+	data->triggers[TITANIA_LEFT] = input->triggers[DUALSENSE_LEFT];
+	data->triggers[TITANIA_RIGHT] = input->triggers[DUALSENSE_RIGHT];
+
+	for (int i = 0; i < 2; ++i) {
+		data->touch[i].id = input->touch[i].id.value;
+		data->touch[i].active = !input->touch[i].id.idle;
 #ifdef _WIN32
-	data->touch[TITANIA_PRIMARY].pos.x = ((uint16_t) input.touch[DUALSENSE_LEFT].pos.x1) | ((uint16_t) input.touch[DUALSENSE_LEFT].pos.x2 << 8);
-	data->touch[TITANIA_PRIMARY].pos.x = ((uint16_t) input.touch[DUALSENSE_LEFT].pos.y1) | ((uint16_t) input.touch[DUALSENSE_LEFT].pos.y2 << 4);
-	data->touch[TITANIA_SECONDARY].pos.x = ((uint16_t) input.touch[DUALSENSE_RIGHT].pos.x1) | ((uint16_t) input.touch[DUALSENSE_RIGHT].pos.x2 << 8);
-	data->touch[TITANIA_SECONDARY].pos.x = ((uint16_t) input.touch[DUALSENSE_RIGHT].pos.y1) | ((uint16_t) input.touch[DUALSENSE_RIGHT].pos.y2 << 4);
+		data->touch[i].x = ((uint16_t) input->touch[i].pos.x1) | ((uint16_t) input->touch[i].pos.x2 << 8);
+		data->touch[i].y = ((uint16_t) input->touch[i].pos.y1) | ((uint16_t) input->touch[i].pos.y2 << 4);
 #else
-	data->touch[TITANIA_PRIMARY].pos.x = input.touch[DUALSENSE_LEFT].pos.x;
-	data->touch[TITANIA_PRIMARY].pos.y = input.touch[DUALSENSE_LEFT].pos.y;
-	data->touch[TITANIA_SECONDARY].pos.x = input.touch[DUALSENSE_RIGHT].pos.x;
-	data->touch[TITANIA_SECONDARY].pos.y = input.touch[DUALSENSE_RIGHT].pos.y;
+		data->touch[i].x = input->touch[i].pos.x;
+		data->touch[i].y = input->touch[i].pos.y;
 #endif
-	data->buttons.touchpad = data->touch[TITANIA_PRIMARY].active || data->touch[TITANIA_SECONDARY].active;
-
-	data->sensors.accelerometer.x = CALIBRATE(input.sensors.accelerometer.x, CALIBRATION_ACCELEROMETER_X);
-	data->sensors.accelerometer.y = CALIBRATE(input.sensors.accelerometer.y, CALIBRATION_ACCELEROMETER_Y);
-	data->sensors.accelerometer.z = CALIBRATE(input.sensors.accelerometer.z, CALIBRATION_ACCELEROMETER_Z);
-	data->sensors.gyro.x = CALIBRATE_BIAS(input.sensors.gyro.x, CALIBRATION_GYRO_X);
-	data->sensors.gyro.y = CALIBRATE_BIAS(input.sensors.gyro.y, CALIBRATION_GYRO_Y);
-	data->sensors.gyro.z = CALIBRATE_BIAS(input.sensors.gyro.z, CALIBRATION_GYRO_Z);
-	data->sensors.temperature = input.sensors.temperature;
-
-	data->device.headphones = input.state.device.headphones;
-	data->device.headset = input.state.device.headset;
-	data->device.muted = input.state.device.muted;
-	data->device.usb_data = input.state.device.usb_data;
-	data->device.usb_power = input.state.device.usb_power;
-	data->device.external_mic = input.state.device.external_mic;
-	data->device.haptic_filter = input.state.device.haptic_filter;
-	data->device.reserved = (uint16_t) input.state.device.reserved1 | (uint16_t) input.state.device.reserved2 << 3;
-
-	data->battery.state = input.state.battery.state + 1;
-	if (data->battery.state == TITANIA_BATTERY_FULL) {
-		data->battery.level = 1.0f;
-	} else {
-		data->battery.level = input.state.battery.level * 0.1 + 0.10;
 	}
 
-	data->bt.has_hid = input.bt.has_hid;
-	data->bt.unknown = input.bt.unknown;
-	data->bt.unknown2 = input.bt.unknown2;
-	data->bt.unknown3 = input.bt.unknown3;
-	data->bt.seq = input.bt.seq;
-
-	if (IS_EDGE(hid_info)) {
-		data->time.battery = data->time.system + data->time.sensor;
-		data->edge_device.raw_buttons.dpad_up = CHECK_DPAD(input.state.edge.override, U, UR, UL);
-		data->edge_device.raw_buttons.dpad_down = CHECK_DPAD(input.state.edge.override, D, DR, DL);
-		data->edge_device.raw_buttons.dpad_left = CHECK_DPAD(input.state.edge.override, L, UL, DL);
-		data->edge_device.raw_buttons.dpad_right = CHECK_DPAD(input.state.edge.override, R, UR, DR);
-		data->edge_device.raw_buttons.square = input.state.edge.override.square;
-		data->edge_device.raw_buttons.cross = input.state.edge.override.cross;
-		data->edge_device.raw_buttons.circle = input.state.edge.override.circle;
-		data->edge_device.raw_buttons.triangle = input.state.edge.override.triangle;
-		data->edge_device.emulating_rumble = input.state.edge.override.emulating_rumble;
-		data->edge_device.brightness = input.state.edge.override.brightness_override;
-		data->edge_device.unknown = input.state.edge.override.unknown;
-		data->edge_device.raw_buttons.playstation = input.state.edge.override.playstation;
-		data->edge_device.raw_buttons.create = input.state.edge.override.create;
-		data->edge_device.raw_buttons.option = input.state.edge.override.option;
-
-		data->edge_device.stick.disconnected = input.state.edge.input.stick_disconnected;
-		data->edge_device.stick.errored = input.state.edge.input.stick_error;
-		data->edge_device.stick.calibrating = input.state.edge.input.stick_calibrating;
-		data->edge_device.stick.unknown = input.state.edge.input.stick_unknown;
-		data->edge_device.trigger_levels[TITANIA_LEFT] = input.state.edge.input.left_trigger_level;
-		data->edge_device.trigger_levels[TITANIA_RIGHT] = input.state.edge.input.right_trigger_level;
-		data->edge_device.current_profile_id = input.state.edge.profile.id;
-		data->edge_device.profile_indicator.switching_disabled = input.state.edge.profile.disable_switching;
-		data->edge_device.profile_indicator.led = input.state.edge.profile.led_indicator;
-		data->edge_device.profile_indicator.vibration = input.state.edge.profile.vibrate_indicator;
-		data->edge_device.profile_indicator.unknown1 = input.state.edge.profile.unknown1;
-		data->edge_device.profile_indicator.unknown2 = input.state.edge.profile.unknown2;
-	}
+	data->accelerometer.x = CALIBRATE_FIXED(input->sensors.accelerometer.x, CALIBRATION_ACCELEROMETER_X);
+	data->accelerometer.y = CALIBRATE_FIXED(input->sensors.accelerometer.y, CALIBRATION_ACCELEROMETER_Y);
+	data->accelerometer.z = CALIBRATE_FIXED(input->sensors.accelerometer.z, CALIBRATION_ACCELEROMETER_Z);
+	data->gyro.x = CALIBRATE_FIXED_BIAS(input->sensors.gyro.x, CALIBRATION_GYRO_X);
+	data->gyro.y = CALIBRATE_FIXED_BIAS(input->sensors.gyro.y, CALIBRATION_GYRO_Y);
+	data->gyro.z = CALIBRATE_FIXED_BIAS(input->sensors.gyro.z, CALIBRATION_GYRO_Z);
 }
@@ -4,6 +4,14 @@
 
 #include "unicode.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TITANIA_UNICODE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define TITANIA_UNICODE_NEON
+#include <arm_neon.h>
+#endif
+
 #define TEST_CONTINUATION_CHAR(t, buf, n) \
 	if (++buf >= endp) { \
 		return (titania_unicode_result) { .failed = true, .error = TITANIA_UNICODE_OUT_OF_SPACE }; \
@@ -243,3 +251,208 @@ titania_unicode_result titania_utf32_to_utf16(const titania_char32* utf32, const
 
 	return (titania_unicode_result) { .size = size };
 }
+
+#define UNICODE_FAIL(e) (titania_unicode_result) { .failed = true, .error = e }
+
+titania_unicode_result titania_utf16_to_utf8(const titania_char16* utf16, const size_t utf16_size, titania_char8* utf8, const size_t utf8_size) {
+	if (utf16 == nullptr || utf8 == nullptr) {
+		return UNICODE_FAIL(TITANIA_UNICODE_MALFORMED);
+	}
+
+	if (utf8_size == 0) {
+		return UNICODE_FAIL(TITANIA_UNICODE_OUT_OF_SPACE);
+	}
+
+	// every write below leaves room for the null terminator.
+	size_t size = 0;
+	size_t i = 0;
+	while (i < utf16_size) {
+		// 8 code units at a time while all of them are non-null ASCII.
+#if defined(TITANIA_UNICODE_SSE2)
+		if (i + 8 <= utf16_size && size + 8 < utf8_size) {
+			const __m128i v = _mm_loadu_si128((const __m128i*) (utf16 + i));
+			const __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16((short) 0xFF80)), _mm_setzero_si128());
+			const __m128i null = _mm_cmpeq_epi16(v, _mm_setzero_si128());
+			if (_mm_movemask_epi8(_mm_andnot_si128(null, ascii)) == 0xFFFF) {
+				_mm_storel_epi64((__m128i*) (utf8 + size), _mm_packus_epi16(v, v));
+				i += 8;
+				size += 8;
+				continue;
+			}
+		}
+#elif defined(TITANIA_UNICODE_NEON)
+		if (i + 8 <= utf16_size && size + 8 < utf8_size) {
+			const uint16x8_t v = vld1q_u16(utf16 + i);
+			const uint8x8_t ascii = vmovn_u16(vcltq_u16(vsubq_u16(v, vdupq_n_u16(1)), vdupq_n_u16(0x7F)));
+			if (vget_lane_u64(vreinterpret_u64_u8(ascii), 0) == UINT64_MAX) {
+				vst1_u8(utf8 + size, vmovn_u16(v));
+				i += 8;
+				size += 8;
+				continue;
+			}
+		}
+#endif
+
+		const titania_char16 char0 = utf16[i++];
+		if (char0 == 0) {
+			break;
+		}
+
+		if (char0 < 0x80) {
+			if (size + 1 >= utf8_size) {
+				return UNICODE_FAIL(TITANIA_UNICODE_OUT_OF_SPACE);
+			}
+
+			utf8[size++] = (titania_char8) char0;
+		} else if (char0 < 0x800) {
+			if (size + 2 >= utf8_size) {
+				return UNICODE_FAIL(TITANIA_UNICODE_OUT_OF_SPACE);
+			}
+
+			utf8[size++] = 0xC0 | (char0 >> 6);
+			utf8[size++] = 0x80 | (char0 & 0x3F);
+		} else if (char0 < 0xD800 || char0 > 0xDFFF) {
+			if (size + 3 >= utf8_size) {
+				return UNICODE_FAIL(TITANIA_UNICODE_OUT_OF_SPACE);
+			}
+
+			utf8[size++] = 0xE0 | (char0 >> 12);
+			utf8[size++] = 0x80 | (char0 >> 6 & 0x3F);
+			utf8[size++] = 0x80 | (char0 & 0x3F);
+		} else {
+			if (char0 > 0xDBFF) {
+				return UNICODE_FAIL(TITANIA_UNICODE_EXPECTED_SURROGATE_HIGH);
+			}
+
+			if (i >= utf16_size) {
+				return UNICODE_FAIL(TITANIA_UNICODE_OUT_OF_SPACE);
+			}
+
+			const titania_char16 char1 = utf16[i++];
+			if (char1 < 0xDC00 || char1 > 0xDFFF) {
+				return UNICODE_FAIL(TITANIA_UNICODE_EXPECTED_SURROGATE_LOW);
+			}
+
+			if (size + 4 >= utf8_size) {
+				return UNICODE_FAIL(TITANIA_UNICODE_OUT_OF_SPACE);
+			}
+
+			const titania_char32 codepoint = ((char0 & 0x3FF) << 10 | (char1 & 0x3FF)) + 0x10000;
+			utf8[size++] = 0xF0 | (codepoint >> 18);
+			utf8[size++] = 0x80 | (codepoint >> 12 & 0x3F);
+			utf8[size++] = 0x80 | (codepoint >> 6 & 0x3F);
+			utf8[size++] = 0x80 | (codepoint & 0x3F);
+		}
+	}
+
+	utf8[size] = 0;
+
+	return (titania_unicode_result) { .size = size };
+}
+
+titania_unicode_result titania_utf8_to_utf16(const titania_char8* utf8, const size_t utf8_size, titania_char16* utf16, const size_t utf16_size) {
+	if (utf8 == nullptr || utf16 == nullptr) {
+		return UNICODE_FAIL(TITANIA_UNICODE_MALFORMED);
+	}
+
+	if (utf16_size == 0) {
+		return UNICODE_FAIL(TITANIA_UNICODE_OUT_OF_SPACE);
+	}
+
+	// every write below leaves room for the null terminator.
+	size_t size = 0;
+	size_t i = 0;
+	while (i < utf8_size) {
+		// 16 bytes at a time while all of them are non-null ASCII.
+#if defined(TITANIA_UNICODE_SSE2)
+		if (i + 16 <= utf8_size && size + 16 < utf16_size) {
+			const __m128i v = _mm_loadu_si128((const __m128i*) (utf8 + i));
+			if ((_mm_movemask_epi8(v) | _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()))) == 0) {
+				_mm_storeu_si128((__m128i*) (utf16 + size), _mm_unpacklo_epi8(v, _mm_setzero_si128()));
+				_mm_storeu_si128((__m128i*) (utf16 + size + 8), _mm_unpackhi_epi8(v, _mm_setzero_si128()));
+				i += 16;
+				size += 16;
+				continue;
+			}
+		}
+#elif defined(TITANIA_UNICODE_NEON)
+		if (i + 16 <= utf8_size && size + 16 < utf16_size) {
+			const uint8x16_t v = vld1q_u8(utf8 + i);
+			const uint64x2_t ascii = vreinterpretq_u64_u8(vcltq_u8(vsubq_u8(v, vdupq_n_u8(1)), vdupq_n_u8(0x7F)));
+			if ((vgetq_lane_u64(ascii, 0) & vgetq_lane_u64(ascii, 1)) == UINT64_MAX) {
+				vst1q_u16(utf16 + size, vmovl_u8(vget_low_u8(v)));
+				vst1q_u16(utf16 + size + 8, vmovl_u8(vget_high_u8(v)));
+				i += 16;
+				size += 16;
+				continue;
+			}
+		}
+#endif
+
+		const titania_char8 char0 = utf8[i++];
+		if (char0 == 0) {
+			break;
+		}
+
+		titania_char32 codepoint;
+		int continuation;
+		titania_char32 minimum;
+		if (char0 < 0x80) {
+			codepoint = char0;
+			continuation = 0;
+			minimum = 0;
+		} else if ((char0 & 0xE0) == 0xC0) {
+			codepoint = char0 & 0x1F;
+			continuation = 1;
+			minimum = 0x80;
+		} else if ((char0 & 0xF0) == 0xE0) {
+			codepoint = char0 & 0xF;
+			continuation = 2;
+			minimum = 0x800;
+		} else if ((char0 & 0xF8) == 0xF0) {
+			codepoint = char0 & 0x7;
+			continuation = 3;
+			minimum = 0x10000;
+		} else {
+			return UNICODE_FAIL(TITANIA_UNICODE_EXPECTED_REGULAR_CHAR);
+		}
+
+		for (int j = 0; j < continuation; ++j) {
+			if (i >= utf8_size) {
+				return UNICODE_FAIL(TITANIA_UNICODE_OUT_OF_SPACE);
+			}
+
+			const titania_char8 char1 = utf8[i++];
+			if ((char1 & 0xC0) != 0x80) {
+				return UNICODE_FAIL(TITANIA_UNICODE_EXPECTED_CONTINUATION_CHAR);
+			}
+
+			codepoint = codepoint << 6 | (char1 & 0x3F);
+		}
+
+		// overlong encodings, surrogates, and anything past the unicode limit.
+		if (codepoint < minimum || (codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint >= 0x110000) {
+			return UNICODE_FAIL(TITANIA_UNICODE_MALFORMED);
+		}
+
+		if (codepoint < 0x10000) {
+			if (size + 1 >= utf16_size) {
+				return UNICODE_FAIL(TITANIA_UNICODE_OUT_OF_SPACE);
+			}
+
+			utf16[size++] = (titania_char16) codepoint;
+		} else {
+			if (size + 2 >= utf16_size) {
+				return UNICODE_FAIL(TITANIA_UNICODE_OUT_OF_SPACE);
+			}
+
+			codepoint -= 0x10000;
+			utf16[size++] = (codepoint >> 10) + 0xD800;
+			utf16[size++] = (codepoint & 0x3FF) + 0xDC00;
+		}
+	}
+
+	utf16[size] = 0;
+
+	return (titania_unicode_result) { .size = size };
+}